@@ -0,0 +1,21 @@
+#!/usr/bin/env sh
+
+# SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+# SPDX-License-Identifier: MIT
+
+set -e
+
+echo "🏗️ Building Bismuth Benchmark..."
+
+cmake -S "." -B "build" -G Ninja \
+  -DCMAKE_BUILD_TYPE=RelWithDebInfo \
+  -DCMAKE_EXPORT_COMPILE_COMMANDS=ON \
+  -DBUILD_TESTING=true
+
+cmake --build "build" --target bismuth_bench
+
+echo "⏱️ Benchmarking Bismuth..."
+
+build/bin/bismuth_bench --output "build/bench.json" "$@"
+
+echo "📄 Results are written to build/bench.json"
@@ -0,0 +1,135 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDBusConnection>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+
+#include <cstdio>
+
+#include "metrics_interface.h"
+
+namespace
+{
+/**
+ * The counters are integers, but JSON keeps every number as a double
+ */
+qint64 integer(const QJsonValue &value)
+{
+    return static_cast<qint64>(value.toDouble());
+}
+
+QString latencyRow(const QString &name, const QJsonObject &histogram)
+{
+    return QStringLiteral("  %1 %2 %3 %4 %5 %6 %7")
+        .arg(name, -24)
+        .arg(integer(histogram.value(QStringLiteral("count"))), 8)
+        .arg(histogram.value(QStringLiteral("meanUs")).toDouble(), 9, 'f', 1)
+        .arg(integer(histogram.value(QStringLiteral("p50Us"))), 8)
+        .arg(integer(histogram.value(QStringLiteral("p90Us"))), 8)
+        .arg(integer(histogram.value(QStringLiteral("p99Us"))), 8)
+        .arg(integer(histogram.value(QStringLiteral("maxUs"))), 8);
+}
+
+void printStats(const QJsonObject &stats)
+{
+    QTextStream out(stdout);
+
+    out << "Managed windows:\n";
+    const auto surfaces = stats.value(QStringLiteral("surfaces")).toArray();
+    for (const auto &value : surfaces) {
+        const auto surface = value.toObject();
+        const auto activity = surface.value(QStringLiteral("activity")).toString();
+        out << QStringLiteral("  screen %1, desktop %2%3: %4\n")
+                   .arg(surface.value(QStringLiteral("screen")).toInt())
+                   .arg(surface.value(QStringLiteral("desktop")).toInt())
+                   .arg(activity.isEmpty() ? QString() : QStringLiteral(", activity ") + activity)
+                   .arg(integer(surface.value(QStringLiteral("windows"))));
+    }
+    if (surfaces.isEmpty()) {
+        out << "  none\n";
+    }
+
+    out << QStringLiteral("\nCommits: %1 sent, %2 skipped, %3 echoes ignored\n")
+               .arg(integer(stats.value(QStringLiteral("commitsSent"))))
+               .arg(integer(stats.value(QStringLiteral("commitsSkipped"))))
+               .arg(integer(stats.value(QStringLiteral("echoesIgnored"))));
+
+    out << QStringLiteral("\nLatency, µs:\n  %1 %2 %3 %4 %5 %6 %7\n")
+               .arg(QString(), -24)
+               .arg(QStringLiteral("count"), 8)
+               .arg(QStringLiteral("mean"), 9)
+               .arg(QStringLiteral("p50"), 8)
+               .arg(QStringLiteral("p90"), 8)
+               .arg(QStringLiteral("p99"), 8)
+               .arg(QStringLiteral("max"), 8);
+    const auto arrangements = stats.value(QStringLiteral("arrangements")).toObject();
+    for (auto it = arrangements.begin(); it != arrangements.end(); ++it) {
+        out << latencyRow(QStringLiteral("arrange ") + it.key(), it.value().toObject()) << '\n';
+    }
+    out << latencyRow(QStringLiteral("shortcut"), stats.value(QStringLiteral("shortcuts")).toObject()) << '\n';
+
+    out << "\nBridge calls:\n";
+    const auto calls = stats.value(QStringLiteral("bridgeCalls")).toObject();
+    for (auto it = calls.begin(); it != calls.end(); ++it) {
+        out << QStringLiteral("  %1 %2\n").arg(it.key(), -24).arg(integer(it.value()), 8);
+    }
+}
+}
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Inspect the running Bismuth instance"));
+    parser.addHelpOption();
+
+    auto jsonOption = QCommandLineOption(QStringLiteral("json"), QStringLiteral("Print the stats as JSON"));
+    parser.addOption(jsonOption);
+    parser.addPositionalArgument(QStringLiteral("command"),
+                                 QStringLiteral("stats - print the metrics of the tiling pipeline, reset - count the metrics from zero"));
+    parser.process(app);
+
+    const auto arguments = parser.positionalArguments();
+    if (arguments.size() != 1) {
+        parser.showHelp(1);
+    }
+
+    auto metrics = OrgKdeBismuthMetricsInterface(QStringLiteral("org.kde.bismuth"), QStringLiteral("/Metrics"), QDBusConnection::sessionBus());
+
+    const auto &command = arguments.constFirst();
+    if (command != QStringLiteral("stats") && command != QStringLiteral("reset")) {
+        parser.showHelp(1);
+    }
+
+    if (!metrics.isValid()) {
+        qCritical("Cannot reach Bismuth, is it running? %s", qPrintable(metrics.lastError().message()));
+        return 1;
+    }
+
+    if (command == QStringLiteral("reset")) {
+        metrics.reset();
+        return 0;
+    }
+
+    auto reply = metrics.stats();
+    reply.waitForFinished();
+    if (reply.isError()) {
+        qCritical("Cannot get the stats: %s", qPrintable(reply.error().message()));
+        return 1;
+    }
+
+    if (parser.isSet(jsonOption)) {
+        const auto json = QJsonDocument::fromJson(reply.value().toUtf8()).toJson();
+        std::fwrite(json.constData(), 1, json.size(), stdout);
+        return 0;
+    }
+
+    printStats(QJsonDocument::fromJson(reply.value().toUtf8()).object());
+    return 0;
+}
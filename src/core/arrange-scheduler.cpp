@@ -0,0 +1,87 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include "arrange-scheduler.hpp"
+
+#include <utility>
+
+#include "logger.hpp"
+
+namespace Bismuth
+{
+
+ArrangeScheduler::ArrangeScheduler(QObject *parent)
+    : QObject(parent)
+    , m_timer()
+    , m_dirtySurfaces()
+    , m_dirty()
+    , m_allSurfacesDirty(false)
+{
+    // Zero interval means "as soon as all the pending events are processed"
+    m_timer.setSingleShot(true);
+    m_timer.setInterval(0);
+    connect(&m_timer, &QTimer::timeout, this, &ArrangeScheduler::flush);
+}
+
+void ArrangeScheduler::schedule(int surface)
+{
+    if (surface < 0) {
+        return;
+    }
+
+    if (surface >= static_cast<int>(m_dirty.size())) {
+        m_dirty.resize(surface + 1);
+    }
+
+    if (!m_allSurfacesDirty && !m_dirty[surface]) {
+        m_dirty[surface] = true;
+        m_dirtySurfaces.append(surface);
+    }
+    start();
+}
+
+void ArrangeScheduler::scheduleAll()
+{
+    m_allSurfacesDirty = true;
+    clearDirty();
+    start();
+}
+
+bool ArrangeScheduler::pending() const
+{
+    return m_timer.isActive();
+}
+
+void ArrangeScheduler::start()
+{
+    // Restarting the timer on every request would postpone the arrangement
+    // for as long as the events keep coming
+    if (!m_timer.isActive()) {
+        m_timer.start();
+    }
+}
+
+void ArrangeScheduler::flush()
+{
+    // Requests made during the arrangement go to the next iteration
+    const auto surfaces = m_dirtySurfaces;
+    const auto allSurfaces = std::exchange(m_allSurfacesDirty, false);
+    clearDirty();
+
+    if (allSurfaces) {
+        qCDebug(Bi) << "Arranging all the surfaces";
+    } else {
+        qCDebug(Bi) << "Arranging surfaces:" << surfaces;
+    }
+    Q_EMIT arrangeRequested(surfaces, allSurfaces);
+}
+
+void ArrangeScheduler::clearDirty()
+{
+    for (auto surface : qAsConst(m_dirtySurfaces)) {
+        m_dirty[surface] = false;
+    }
+    m_dirtySurfaces.clear();
+}
+
+}
@@ -0,0 +1,67 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <QList>
+#include <QObject>
+#include <QTimer>
+
+#include <vector>
+
+namespace Bismuth
+{
+
+/**
+ * Collects the arrange requests made during one event loop iteration.
+ *
+ * Every request marks a surface as dirty. When control returns to the event
+ * loop, arrangeRequested is emitted once with all the dirty surfaces, so a
+ * burst of window events results in one layout pass per affected surface.
+ *
+ * The surfaces are the dense handles of the SurfaceRegistry, so the dirty
+ * ones are marked in a bit vector indexed by the handle.
+ */
+class ArrangeScheduler : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ArrangeScheduler(QObject *parent = nullptr);
+
+    /**
+     * Mark the surface as dirty
+     * @param surface handle of the surface, @see SurfaceRegistry::intern
+     */
+    void schedule(int surface);
+
+    /**
+     * Mark all the visible surfaces as dirty
+     */
+    void scheduleAll();
+
+    /**
+     * @return whether an arrangement is pending
+     */
+    bool pending() const;
+
+Q_SIGNALS:
+    /**
+     * Emitted once per event loop iteration, if there were any requests
+     * @param surfaces handles of the dirty surfaces in the order they were requested
+     * @param allSurfaces whether all the visible surfaces must be arranged.
+     * In that case @p surfaces should be ignored.
+     */
+    void arrangeRequested(const QList<int> &surfaces, bool allSurfaces);
+
+private:
+    void start();
+    void flush();
+    void clearDirty();
+
+    QTimer m_timer;
+    QList<int> m_dirtySurfaces;
+    std::vector<bool> m_dirty; ///< Whether the surface is in m_dirtySurfaces, by the handle
+    bool m_allSurfacesDirty;
+};
+
+}
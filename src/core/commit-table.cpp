@@ -0,0 +1,65 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include "commit-table.hpp"
+
+namespace Bismuth
+{
+
+namespace
+{
+/**
+ * Copy the new value into the committed one
+ * @return whether the value has changed
+ */
+template<typename T>
+bool merge(std::optional<T> &committed, const std::optional<T> &value)
+{
+    if (!value || committed == value) {
+        return false;
+    }
+    committed = value;
+    return true;
+}
+}
+
+bool CommitTable::update(const QString &windowId, const WindowCommit &commit)
+{
+    auto &committed = m_committed[windowId];
+
+    // Everything must be merged, so no short-circuiting here
+    auto changed = merge(committed.geometry, commit.geometry);
+    changed |= merge(committed.noBorder, commit.noBorder);
+    changed |= merge(committed.keepAbove, commit.keepAbove);
+
+    if (changed) {
+        m_sentCount++;
+    } else {
+        m_skippedCount++;
+    }
+
+    return changed;
+}
+
+void CommitTable::forget(const QString &windowId)
+{
+    m_committed.erase(windowId);
+}
+
+quint64 CommitTable::sentCount() const
+{
+    return m_sentCount;
+}
+
+quint64 CommitTable::skippedCount() const
+{
+    return m_skippedCount;
+}
+
+void CommitTable::resetCounters()
+{
+    m_sentCount = 0;
+    m_skippedCount = 0;
+}
+
+}
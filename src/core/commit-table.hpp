@@ -0,0 +1,59 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <QRect>
+#include <QString>
+
+#include <optional>
+#include <unordered_map>
+
+namespace Bismuth
+{
+
+/**
+ * Window properties, that are written to KWin. Unset values are left as is.
+ */
+struct WindowCommit {
+    std::optional<QRect> geometry;
+    std::optional<bool> noBorder;
+    std::optional<bool> keepAbove;
+};
+
+/**
+ * Last committed properties of every window.
+ *
+ * Used to skip the writes, that would not change anything, as every
+ * geometry write makes KWin reconfigure and repaint the window.
+ */
+class CommitTable
+{
+public:
+    /**
+     * Check whether the commit changes anything and remember its values
+     * @return whether the commit must be sent to KWin
+     */
+    bool update(const QString &windowId, const WindowCommit &commit);
+
+    /**
+     * Forget the committed state of the window, e.g. when it was changed
+     * not by us. The next commit of the window is always sent.
+     */
+    void forget(const QString &windowId);
+
+    quint64 sentCount() const;
+    quint64 skippedCount() const;
+
+    /**
+     * Count the sent and the skipped commits from zero. The committed state is kept.
+     */
+    void resetCounters();
+
+private:
+    std::unordered_map<QString, WindowCommit> m_committed;
+    quint64 m_sentCount = 0;
+    quint64 m_skippedCount = 0;
+};
+
+}
@@ -0,0 +1,127 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include "config-snapshot.hpp"
+
+#include "config.hpp"
+#include "logger.hpp"
+
+namespace Bismuth
+{
+
+namespace
+{
+QStringList splitList(const QString &commaSeparatedString)
+{
+    auto result = commaSeparatedString.split(QLatin1Char(','), Qt::SkipEmptyParts);
+    for (auto &value : result) {
+        value = value.trimmed();
+    }
+    return result;
+}
+}
+
+std::shared_ptr<const ConfigSnapshot> ConfigSnapshot::fromConfig(const Bismuth::Config &config, quint64 generation)
+{
+    auto snapshot = std::make_shared<ConfigSnapshot>();
+
+    snapshot->generation = generation;
+
+    auto addLayout = [&snapshot](bool enabled, const char *layoutId) {
+        if (enabled) {
+            snapshot->layoutOrder.append(QString::fromUtf8(layoutId));
+        }
+    };
+
+    // HACK: We have to hardcode layoutIds here for now
+    addLayout(config.enableTileLayout(), "TileLayout");
+    addLayout(config.enableMonocleLayout(), "MonocleLayout");
+    addLayout(config.enableThreeColumnLayout(), "ThreeColumnLayout");
+    addLayout(config.enableSpreadLayout(), "SpreadLayout");
+    addLayout(config.enableStairLayout(), "StairLayout");
+    addLayout(config.enableSpiralLayout(), "SpiralLayout");
+    addLayout(config.enableQuarterLayout(), "QuarterLayout");
+    addLayout(config.enableFloatingLayout(), "FloatingLayout");
+    // NOTE: CascadeLayout has no config entry yet, so it is never enabled
+
+    snapshot->monocleMaximize = config.monocleMaximize();
+    snapshot->maximizeSoleTile = config.maximizeSoleTile();
+    snapshot->monocleMinimizeRest = config.monocleMinimizeRest();
+    snapshot->untileByDragging = config.untileByDragging();
+
+    snapshot->keepFloatAbove = config.keepFloatAbove();
+    snapshot->noTileBorder = config.noTileBorder();
+    snapshot->limitTileWidthRatio = config.limitTileWidth() ? config.limitTileWidthRatio() : 0;
+
+    snapshot->screenGapBottom = config.screenGapBottom();
+    snapshot->screenGapLeft = config.screenGapLeft();
+    snapshot->screenGapRight = config.screenGapRight();
+    snapshot->screenGapTop = config.screenGapTop();
+    snapshot->tileLayoutGap = config.tileLayoutGap();
+
+    snapshot->newWindowAsMaster = config.newWindowAsMaster();
+    snapshot->layoutPerActivity = config.layoutPerActivity();
+    snapshot->layoutPerDesktop = config.layoutPerDesktop();
+
+    snapshot->preventMinimize = config.preventMinimize();
+    snapshot->preventProtrusion = config.preventProtrusion();
+
+    // Minimizing the rest of the windows in Monocle would be undone otherwise
+    if (snapshot->preventMinimize && snapshot->monocleMinimizeRest) {
+        qCDebug(Bi) << "preventMinimize is disabled because of monocleMinimizeRest";
+        snapshot->preventMinimize = false;
+    }
+
+    snapshot->floatUtility = config.floatUtility();
+
+    snapshot->experimentalBackend = config.experimentalBackend();
+
+    snapshot->floatingClass = splitList(config.floatingClass());
+    snapshot->floatingTitle = splitList(config.floatingTitle());
+    snapshot->ignoreClass = splitList(config.ignoreClass());
+    snapshot->ignoreTitle = splitList(config.ignoreTitle());
+    snapshot->ignoreRole = splitList(config.ignoreRole());
+
+    snapshot->ignoreActivity = splitList(config.ignoreActivity());
+    for (auto &screen : splitList(config.ignoreScreen())) {
+        snapshot->ignoreScreen.append(screen.toInt());
+    }
+
+    return snapshot;
+}
+
+int ConfigSnapshot::changesFrom(const ConfigSnapshot &previous) const
+{
+    auto changes = int(NoChanges);
+
+    if (layoutOrder != previous.layoutOrder) {
+        changes |= Layouts;
+    }
+
+    if (monocleMaximize != previous.monocleMaximize || maximizeSoleTile != previous.maximizeSoleTile
+        || monocleMinimizeRest != previous.monocleMinimizeRest || keepFloatAbove != previous.keepFloatAbove || noTileBorder != previous.noTileBorder
+        || !qFuzzyCompare(1 + limitTileWidthRatio, 1 + previous.limitTileWidthRatio) || screenGapBottom != previous.screenGapBottom
+        || screenGapLeft != previous.screenGapLeft || screenGapRight != previous.screenGapRight || screenGapTop != previous.screenGapTop
+        || tileLayoutGap != previous.tileLayoutGap || preventProtrusion != previous.preventProtrusion) {
+        changes |= Arrangement;
+    }
+
+    if (floatUtility != previous.floatUtility || floatingClass != previous.floatingClass || floatingTitle != previous.floatingTitle
+        || ignoreClass != previous.ignoreClass || ignoreTitle != previous.ignoreTitle || ignoreRole != previous.ignoreRole) {
+        changes |= Rules;
+    }
+
+    if (ignoreActivity != previous.ignoreActivity || ignoreScreen != previous.ignoreScreen || layoutPerActivity != previous.layoutPerActivity
+        || layoutPerDesktop != previous.layoutPerDesktop) {
+        changes |= Surfaces;
+    }
+
+    if (untileByDragging != previous.untileByDragging || newWindowAsMaster != previous.newWindowAsMaster || preventMinimize != previous.preventMinimize
+        || experimentalBackend != previous.experimentalBackend) {
+        changes |= Behavior;
+    }
+
+    return changes;
+}
+
+}
@@ -0,0 +1,89 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+#include <memory>
+
+namespace Bismuth
+{
+class Config;
+
+/**
+ * Parsed and immutable copy of the configuration.
+ *
+ * Reading the values from KConfigSkeleton and splitting the comma-separated
+ * lists is done once per configuration change, not every time the values
+ * are needed.
+ */
+struct ConfigSnapshot {
+    /**
+     * Groups of the settings, that are applied the same way, when changed
+     */
+    enum Change {
+        NoChanges = 0x0,
+        Layouts = 0x1, ///< Enabled layouts and their order
+        Arrangement = 0x2, ///< Gaps and the other settings, that affect the geometry of the windows
+        Rules = 0x4, ///< Window rules
+        Surfaces = 0x8, ///< Ignored surfaces and the scope of the layouts
+        Behavior = 0x10, ///< Settings, that take effect on the next user action
+    };
+
+    /**
+     * Parse the current values of the config
+     * @param generation the number of the snapshot. Every next snapshot
+     * must have a greater number than the previous one.
+     */
+    static std::shared_ptr<const ConfigSnapshot> fromConfig(const Bismuth::Config &, quint64 generation);
+
+    /**
+     * Compare the settings with the previous snapshot. The generation is not compared.
+     * @return a combination of Change values
+     */
+    int changesFrom(const ConfigSnapshot &previous) const;
+
+    quint64 generation = 0;
+
+    QStringList layoutOrder;
+
+    bool monocleMaximize = true;
+    bool maximizeSoleTile = false;
+    bool monocleMinimizeRest = false;
+    bool untileByDragging = true;
+
+    bool keepFloatAbove = true;
+    bool noTileBorder = false;
+    qreal limitTileWidthRatio = 0; ///< 0 if the tile width is not limited
+
+    int screenGapBottom = 0;
+    int screenGapLeft = 0;
+    int screenGapRight = 0;
+    int screenGapTop = 0;
+    int tileLayoutGap = 0;
+
+    bool newWindowAsMaster = false;
+    bool layoutPerActivity = true;
+    bool layoutPerDesktop = true;
+
+    bool preventMinimize = false;
+    bool preventProtrusion = true;
+
+    bool floatUtility = true;
+
+    bool experimentalBackend = false;
+
+    QStringList floatingClass;
+    QStringList floatingTitle;
+    QStringList ignoreClass;
+    QStringList ignoreTitle;
+    QStringList ignoreRole;
+
+    QStringList ignoreActivity;
+    QList<int> ignoreScreen;
+};
+
+}
@@ -12,18 +12,66 @@
 #include <QObject>
 
 #include <memory>
+#include <utility>
 
 #include "config.hpp"
 #include "logger.hpp"
 
 namespace Bismuth
 {
-Controller::Controller(const Bismuth::Config &config)
-    : m_config(config)
+namespace
 {
+/**
+ * Number of the global shortcuts, registered per event loop iteration
+ */
+constexpr int registrationBatchSize = 8;
+}
+
+Controller::Controller(const Bismuth::Config &config, bool globalShortcuts)
+    : m_repeatTimer()
+    , m_registrationTimer()
+    , m_registrationClock()
+    , m_globalShortcuts(globalShortcuts)
+    , m_config(config)
+{
+    // Auto-repeated keys are executed as soon as all the pending key events are processed
+    m_repeatTimer.setSingleShot(true);
+    m_repeatTimer.setInterval(0);
+    connect(&m_repeatTimer, &QTimer::timeout, this, &Controller::flushRepeats);
+
+    // Let the compositor handle its events between the batches of the registrations
+    m_registrationTimer.setSingleShot(true);
+    m_registrationTimer.setInterval(0);
+    connect(&m_registrationTimer, &QTimer::timeout, this, &Controller::registerPendingShortcuts);
 }
 
 void Controller::registerAction(const Action &data)
+{
+    registerActions({data});
+};
+
+void Controller::registerActions(const std::vector<Action> &actions)
+{
+    if (m_pendingShortcuts.empty()) {
+        m_registrationClock.start();
+        m_registrationDuration = -1;
+    }
+
+    for (const auto &data : actions) {
+        bindAction(data);
+    }
+
+    if (!m_registrationTimer.isActive()) {
+        m_registrationTimer.start();
+    }
+}
+
+qint64 Controller::registrationDuration() const
+{
+    return m_registrationDuration;
+}
+
+void Controller::bindAction(const Action &data)
 {
     auto action = new QAction(this);
     action->setProperty("componentName", QStringLiteral("bismuth"));
@@ -31,27 +79,86 @@ void Controller::registerAction(const Action &data)
     action->setObjectName(data.id);
     action->setText(data.description);
 
-    // Register the keybinding as the default. This is needed for KCM to
-    // recognize it as such, so that it can properly show whether it is changed
-    // from the default.
-    KGlobalAccel::self()->setDefaultShortcut(action, data.defaultKeybinding);
+    const auto binding = m_bindings.size();
+    m_bindings.push_back({action, data.callback, data.repeatable, 0});
+    m_bindingIndex[data.id] = binding;
 
-    // How this function works:
-    // Set the shortcut from the global shortcuts configuration, or set it to
-    // the provided value if it is not found in the config
-    KGlobalAccel::self()->setShortcut(action, data.defaultKeybinding);
+    QObject::connect(action, &QAction::triggered, this, [this, binding]() {
+        dispatch(binding);
+    });
 
-    QObject::connect(action, &QAction::triggered, data.callback);
+    m_pendingShortcuts.emplace_back(action, data.defaultKeybinding);
+}
 
-    m_registeredShortcuts.push_back(action);
-};
+void Controller::registerPendingShortcuts()
+{
+    for (auto i = 0; i < registrationBatchSize && !m_pendingShortcuts.empty(); ++i) {
+        const auto [action, keybinding] = m_pendingShortcuts.front();
+        m_pendingShortcuts.pop_front();
+
+        // Register the keybinding as the default and set the shortcut from the
+        // global shortcuts configuration, or the default one if it is not found
+        // there. The default is needed for KCM to recognize it as such, so that
+        // it can properly show whether it is changed from the default.
+        // This is one round trip instead of setDefaultShortcut and setShortcut.
+        if (m_globalShortcuts) {
+            KGlobalAccel::self()->setGlobalShortcut(action, keybinding);
+        }
+    }
+
+    if (!m_pendingShortcuts.empty()) {
+        m_registrationTimer.start();
+        return;
+    }
+
+    m_registrationDuration = m_registrationClock.elapsed();
+    qCInfo(Bi) << "Registered" << m_bindings.size() << "shortcuts in" << m_registrationDuration << "ms";
+}
+
+bool Controller::trigger(const QString &id)
+{
+    auto it = m_bindingIndex.find(id);
+    if (it == m_bindingIndex.end()) {
+        return false;
+    }
+
+    dispatch(it->second);
+    return true;
+}
+
+void Controller::dispatch(std::size_t binding)
+{
+    auto &entry = m_bindings[binding];
+    if (!entry.repeatable) {
+        entry.callback(1);
+        return;
+    }
+
+    ++entry.pendingRepeats;
+    if (!m_repeatTimer.isActive()) {
+        m_repeatTimer.start();
+    }
+}
+
+void Controller::flushRepeats()
+{
+    // Callbacks may trigger actions too, their repeats go to the next iteration
+    for (auto i = std::size_t(0); i < m_bindings.size(); ++i) {
+        const auto repeats = std::exchange(m_bindings[i].pendingRepeats, 0);
+        if (repeats > 0) {
+            qCDebug(Bi) << "Coalesced" << repeats << "triggers of" << m_bindings[i].action->objectName();
+            m_bindings[i].callback(repeats);
+        }
+    }
+}
 
-Action::Action(const QString &id, const QString &description, const QString &defaultKeybinding, std::function<void()> callback)
+Action::Action(const QString &id, const QString &description, const QString &defaultKeybinding, std::function<void(int)> callback, bool repeatable)
 {
     this->id = id;
     this->description = description;
     this->defaultKeybinding = {QKeySequence(defaultKeybinding)};
     this->callback = callback;
+    this->repeatable = repeatable;
 };
 
 }
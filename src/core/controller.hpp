@@ -4,11 +4,16 @@
 #pragma once
 
 #include <QAction>
+#include <QElapsedTimer>
 #include <QKeySequence>
 #include <QList>
+#include <QTimer>
 
+#include <deque>
 #include <functional>
 #include <memory>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "config.hpp"
@@ -17,24 +22,76 @@ namespace Bismuth
 {
 
 struct Action {
-    Action(const QString &id, const QString &description, const QString &defaultKeybinding, std::function<void()> callback);
+    Action(const QString &id, const QString &description, const QString &defaultKeybinding, std::function<void(int)> callback, bool repeatable = false);
 
     QString id;
     QString description;
     QList<QKeySequence> defaultKeybinding;
-    std::function<void()> callback;
+    std::function<void(int)> callback; ///< Called with the number of the coalesced triggers
+    bool repeatable; ///< Whether the triggers during one event loop iteration are coalesced
 };
 
 class Controller : public QObject
 {
     Q_OBJECT
 public:
-    Controller(const Bismuth::Config &);
+    /**
+     * @param globalShortcuts whether to register the shortcuts of the actions
+     * in the global shortcuts daemon. Without them, the actions are executed
+     * only by trigger.
+     */
+    Controller(const Bismuth::Config &, bool globalShortcuts = true);
 
     void registerAction(const Action &);
 
+    /**
+     * Register the whole set of actions at once.
+     *
+     * The actions are bound immediately, but their global shortcuts are
+     * registered in small batches from the event loop, as every
+     * registration is a blocking D-Bus call to the global shortcuts daemon.
+     */
+    void registerActions(const std::vector<Action> &);
+
+    /**
+     * @return time in milliseconds, that the registration of the global
+     * shortcuts took, or -1 if it is not finished yet
+     */
+    qint64 registrationDuration() const;
+
+    /**
+     * Execute the registered action, as if its shortcut was pressed.
+     * Triggers of the repeatable actions are coalesced and executed
+     * once, when control returns to the event loop.
+     * @return whether there is such an action
+     */
+    bool trigger(const QString &id);
+
 private:
-    std::vector<QAction *> m_registeredShortcuts{};
+    /**
+     * Entry of the dispatch table
+     */
+    struct Binding {
+        QAction *action;
+        std::function<void(int)> callback;
+        bool repeatable;
+        int pendingRepeats; ///< Triggers, that are not executed yet
+    };
+
+    void bindAction(const Action &);
+    void registerPendingShortcuts();
+    void dispatch(std::size_t binding);
+    void flushRepeats();
+
+    std::vector<Binding> m_bindings{};
+    std::unordered_map<QString, std::size_t> m_bindingIndex{}; ///< Position in m_bindings by the action id
+    QTimer m_repeatTimer;
+
+    std::deque<std::pair<QAction *, QList<QKeySequence>>> m_pendingShortcuts{}; ///< Actions, whose shortcuts are not registered yet
+    QTimer m_registrationTimer;
+    QElapsedTimer m_registrationClock;
+    qint64 m_registrationDuration = -1;
+    bool m_globalShortcuts;
 
     const Config &m_config;
 };
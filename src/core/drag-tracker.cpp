@@ -0,0 +1,59 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include "drag-tracker.hpp"
+
+namespace Bismuth
+{
+
+namespace
+{
+/**
+ * The same check as in the script: the right and the bottom edges belong to the zone
+ */
+bool includes(const QRect &zone, const QPoint &point)
+{
+    return zone.x() <= point.x() && point.x() <= zone.x() + zone.width() && zone.y() <= point.y() && point.y() <= zone.y() + zone.height();
+}
+}
+
+void DragTracker::begin(const QString &windowId)
+{
+    m_window = windowId;
+    m_active = true;
+}
+
+void DragTracker::end()
+{
+    m_window.clear();
+    m_active = false;
+}
+
+bool DragTracker::active() const
+{
+    return m_active;
+}
+
+const QString &DragTracker::window() const
+{
+    return m_window;
+}
+
+QString DragTracker::target(const std::vector<std::pair<QString, QRect>> &tiles, const QPoint &point) const
+{
+    const QString *result = nullptr;
+    for (auto &[id, geometry] : tiles) {
+        if (id == m_window || geometry.isEmpty() || !includes(geometry, point)) {
+            continue;
+        }
+
+        // Overlapping tiles, e.g. in the cascade layout, are not a clear target
+        if (result) {
+            return {};
+        }
+        result = &id;
+    }
+    return result ? *result : QString();
+}
+
+}
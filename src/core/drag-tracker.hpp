@@ -0,0 +1,60 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <QPoint>
+#include <QRect>
+#include <QString>
+
+#include <utility>
+#include <vector>
+
+namespace Bismuth
+{
+
+/**
+ * Interactive move of a window over the tiles.
+ *
+ * Nothing is tracked during the move itself. The drop target is found only
+ * once, when the window is dropped, by checking the tiles of the surface,
+ * where it has landed.
+ */
+class DragTracker
+{
+public:
+    /**
+     * Start tracking the window
+     * @param windowId the dragged window, it is never a drop target
+     */
+    void begin(const QString &windowId);
+
+    /**
+     * Stop tracking
+     */
+    void end();
+
+    /**
+     * @return whether a window is being dragged
+     */
+    bool active() const;
+
+    /**
+     * @return the dragged window
+     */
+    const QString &window() const;
+
+    /**
+     * Find the drop target under the point
+     * @param tiles ids and geometries of the tiles on the surface of the drop
+     * @return the only tile other than the dragged window, that contains the
+     * point, or an empty string, if there is none or several tiles overlap there
+     */
+    QString target(const std::vector<std::pair<QString, QRect>> &tiles, const QPoint &) const;
+
+private:
+    QString m_window;
+    bool m_active = false;
+};
+
+}
@@ -0,0 +1,163 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include "echo-tracker.hpp"
+
+#include <algorithm>
+
+namespace Bismuth
+{
+
+namespace
+{
+bool isEchoed(const WindowCommit &values)
+{
+    return !values.geometry && !values.noBorder && !values.keepAbove;
+}
+}
+
+EchoTracker::EchoTracker(qint64 timeout, std::size_t capacity)
+    : m_timeout(timeout)
+    , m_capacity(std::max<std::size_t>(capacity, 1))
+    , m_writes()
+    , m_nextSequence(1)
+    , m_echoCount(0)
+{
+}
+
+quint64 EchoTracker::record(const QString &windowId, const WindowCommit &commit, qint64 now)
+{
+    if (isEchoed(commit)) {
+        return 0;
+    }
+
+    auto &writes = m_writes[windowId];
+    if (writes.size() == m_capacity) {
+        writes.erase(writes.begin());
+    }
+
+    const auto sequence = m_nextSequence++;
+    writes.push_back(Write{sequence, now, commit, commit.geometry && commit.noBorder});
+    return sequence;
+}
+
+quint64 EchoTracker::consumeGeometry(const QString &windowId, const QRect &geometry, qint64 now)
+{
+    auto writes = this->writes(windowId, now);
+    if (!writes) {
+        return 0;
+    }
+
+    for (auto i = std::size_t(0); i < writes->size(); ++i) {
+        if ((*writes)[i].values.geometry == geometry) {
+            const auto sequence = (*writes)[i].sequence;
+            consume(windowId, *writes, i, Geometry);
+            ++m_echoCount;
+            return sequence;
+        }
+    }
+
+    // The frame has changed around the client, our geometry is still coming.
+    // KWin does that once per border change, anything after it is not ours.
+    for (auto &write : *writes) {
+        if (write.reframes && write.values.geometry) {
+            write.reframes = false;
+            return write.sequence;
+        }
+    }
+
+    return 0;
+}
+
+quint64 EchoTracker::consumeFlag(const QString &windowId, Property property, bool value, qint64 now)
+{
+    auto writes = this->writes(windowId, now);
+    if (!writes) {
+        return 0;
+    }
+
+    for (auto i = std::size_t(0); i < writes->size(); ++i) {
+        const auto &values = (*writes)[i].values;
+        const auto &flag = property == NoBorder ? values.noBorder : values.keepAbove;
+        if (flag == value) {
+            const auto sequence = (*writes)[i].sequence;
+            consume(windowId, *writes, i, property);
+            ++m_echoCount;
+            return sequence;
+        }
+    }
+
+    return 0;
+}
+
+void EchoTracker::forget(const QString &windowId)
+{
+    m_writes.erase(windowId);
+}
+
+std::size_t EchoTracker::size() const
+{
+    return m_writes.size();
+}
+
+quint64 EchoTracker::echoCount() const
+{
+    return m_echoCount;
+}
+
+void EchoTracker::resetCounters()
+{
+    m_echoCount = 0;
+}
+
+std::vector<EchoTracker::Write> *EchoTracker::writes(const QString &windowId, qint64 now)
+{
+    auto it = m_writes.find(windowId);
+    if (it == m_writes.end()) {
+        return nullptr;
+    }
+
+    // The writes are recorded in the order of time
+    auto &writes = it->second;
+    auto firstAlive = std::find_if(writes.begin(), writes.end(), [this, now](const Write &write) {
+        return now - write.time <= m_timeout;
+    });
+    writes.erase(writes.begin(), firstAlive);
+
+    if (writes.empty()) {
+        m_writes.erase(it);
+        return nullptr;
+    }
+    return &writes;
+}
+
+void EchoTracker::consume(const QString &windowId, std::vector<Write> &writes, std::size_t index, Property property)
+{
+    for (auto i = std::size_t(0); i <= index; ++i) {
+        auto &values = writes[i].values;
+        switch (property) {
+        case Geometry:
+            values.geometry.reset();
+            break;
+        case NoBorder:
+            values.noBorder.reset();
+            break;
+        case KeepAbove:
+            values.keepAbove.reset();
+            break;
+        }
+    }
+
+    writes.erase(std::remove_if(writes.begin(),
+                                writes.end(),
+                                [](const Write &write) {
+                                    return isEchoed(write.values);
+                                }),
+                 writes.end());
+
+    if (writes.empty()) {
+        m_writes.erase(windowId);
+    }
+}
+
+}
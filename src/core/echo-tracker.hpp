@@ -0,0 +1,112 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <QRect>
+#include <QString>
+#include <QtGlobal>
+
+#include <unordered_map>
+#include <vector>
+
+#include "commit-table.hpp"
+
+namespace Bismuth
+{
+
+/**
+ * Writes to the KWin clients, whose change signals are not received yet.
+ *
+ * KWin emits the change signal of every written property, sometimes long
+ * after the write, e.g. when an X11 client acknowledges the new size. Such an
+ * echo is recognised by the written value and must not be handled as a
+ * change made by the user, or the window is arranged and written again.
+ *
+ * The writes are forgotten, when a later write is echoed or when they time
+ * out, as KWin does not emit anything for the values it already had.
+ */
+class EchoTracker
+{
+public:
+    /**
+     * Written properties of the client
+     */
+    enum Property {
+        Geometry = 0,
+        NoBorder = 1,
+        KeepAbove = 2,
+    };
+
+    /**
+     * @param timeout time in nanoseconds, after which the write is not expected to be echoed
+     * @param capacity maximal number of the unechoed writes of one window
+     */
+    explicit EchoTracker(qint64 timeout = 500'000'000, std::size_t capacity = 4);
+
+    /**
+     * Remember the values, that are about to be written to the client
+     * @param now current timestamp in nanoseconds, @see Tracer::now
+     * @return sequence number of the write
+     */
+    quint64 record(const QString &windowId, const WindowCommit &, qint64 now);
+
+    /**
+     * Check, whether the new geometry of the client is an echo of our write.
+     * The matching write and all the earlier ones are forgotten.
+     *
+     * While the geometry of a write with a changed border is not echoed, the
+     * first other geometry is taken for the frame, that KWin resizes around
+     * the client. It is not counted as an echo, as its value is unknown.
+     *
+     * @return sequence number of the echoed write or 0, if the change is not ours
+     */
+    quint64 consumeGeometry(const QString &windowId, const QRect &geometry, qint64 now);
+
+    /**
+     * The same as consumeGeometry for the noBorder and keepAbove properties
+     */
+    quint64 consumeFlag(const QString &windowId, Property, bool value, qint64 now);
+
+    /**
+     * Forget all the writes to the window, e.g. when it is closed
+     */
+    void forget(const QString &windowId);
+
+    /**
+     * @return number of the windows with unechoed writes
+     */
+    std::size_t size() const;
+
+    /**
+     * Number of the written values, echoed to consumeGeometry and consumeFlag
+     */
+    quint64 echoCount() const;
+    void resetCounters();
+
+private:
+    struct Write {
+        quint64 sequence;
+        qint64 time;
+        WindowCommit values; ///< Only the values, that are not echoed yet
+        bool reframes; ///< Whether the border was written with the geometry, and the frame has not changed yet
+    };
+
+    /**
+     * @return unexpired writes of the window from the oldest to the newest or nullptr, if there are none
+     */
+    std::vector<Write> *writes(const QString &windowId, qint64 now);
+
+    /**
+     * Forget the property of the write and of all the earlier ones
+     */
+    void consume(const QString &windowId, std::vector<Write> &, std::size_t index, Property);
+
+    qint64 m_timeout;
+    std::size_t m_capacity;
+    std::unordered_map<QString, std::vector<Write>> m_writes;
+    quint64 m_nextSequence;
+    quint64 m_echoCount;
+};
+
+}
@@ -0,0 +1,174 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include "engine.hpp"
+
+#include <QSemaphore>
+#include <QThread>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+#include "engine/layout/cascade_layout.hpp"
+#include "engine/layout/monocle_layout.hpp"
+#include "engine/layout/quarter_layout.hpp"
+#include "engine/layout/spiral_layout.hpp"
+#include "engine/layout/spread_layout.hpp"
+#include "engine/layout/stair_layout.hpp"
+#include "engine/layout/three_column_layout.hpp"
+#include "engine/layout/tile_layout.hpp"
+
+namespace Bismuth
+{
+
+namespace
+{
+/**
+ * Number of tiles in all the requests, below which the surfaces are arranged
+ * on the calling thread. Handing small layouts over to a worker costs more,
+ * than computing them.
+ */
+constexpr std::size_t minParallelTiles = 64;
+
+/**
+ * Maximum number of the workers. Even the workstations have only a few screens.
+ */
+constexpr int maxWorkers = 3;
+}
+
+Engine::Engine(std::shared_ptr<const ConfigSnapshot> config)
+    : m_config(std::move(config))
+    , m_layouts()
+    , m_workers()
+{
+    // The calling thread arranges the surfaces too
+    m_workers.setMaxThreadCount(std::clamp(QThread::idealThreadCount() - 1, 1, maxWorkers));
+    loadLayouts();
+}
+
+void Engine::setConfig(std::shared_ptr<const ConfigSnapshot> config)
+{
+    auto gapChanged = config->tileLayoutGap != m_config->tileLayoutGap;
+    m_config = std::move(config);
+
+    // Layouts depend on the gap only
+    if (gapChanged) {
+        loadLayouts();
+    }
+}
+
+const Layout *Engine::layout(const QString &layoutId) const
+{
+    auto it = m_layouts.find(layoutId);
+    if (it == m_layouts.end()) {
+        return nullptr;
+    }
+    return it->second.get();
+}
+
+std::vector<QRect> Engine::arrange(const QString &layoutId, const LayoutParameters &parameters, const QRect &area, const std::vector<qreal> &weights) const
+{
+    auto layout = this->layout(layoutId);
+    if (!layout || weights.empty()) {
+        return {};
+    }
+
+    return layout->apply(area, weights, parameters);
+}
+
+void Engine::arrange(const QString &layoutId, const LayoutParameters &parameters, const QRect &area, const std::vector<qreal> &weights, GeometryBuffer &result) const
+{
+    // The buffer is reused, so nothing is allocated once it is large enough
+    auto &geometries = result.geometries();
+    auto layout = this->layout(layoutId);
+    if (layout && !weights.empty()) {
+        layout->apply(area, weights, parameters, geometries);
+    } else {
+        geometries.clear();
+    }
+
+    const auto maxWidth = maxTileWidth(layoutId, area);
+    if (maxWidth > 0) {
+        result.clampWidth(maxWidth);
+    }
+}
+
+void Engine::arrange(const std::vector<ArrangeRequest> &requests, std::vector<GeometryBuffer> &results) const
+{
+    const auto count = requests.size();
+    results.resize(count);
+
+    auto arrangeOne = [&](std::size_t i) {
+        const auto &request = requests[i];
+        arrange(request.layoutId, request.parameters, request.area, request.weights, results[i]);
+    };
+
+    auto tilesCount = std::size_t(0);
+    for (const auto &request : requests) {
+        tilesCount += request.weights.size();
+    }
+
+    if (count < 2 || tilesCount < minParallelTiles) {
+        for (auto i = std::size_t(0); i < count; ++i) {
+            arrangeOne(i);
+        }
+        return;
+    }
+
+    // Every thread takes the next request, until there are none left
+    auto next = std::atomic<std::size_t>(0);
+    auto work = [&] {
+        for (auto i = next++; i < count; i = next++) {
+            arrangeOne(i);
+        }
+    };
+
+    const auto helpers = std::min(static_cast<int>(count) - 1, m_workers.maxThreadCount());
+    auto done = QSemaphore();
+    for (auto i = 0; i < helpers; ++i) {
+        m_workers.start([&] {
+            work();
+            done.release();
+        });
+    }
+
+    work();
+    done.acquire(helpers);
+}
+
+int Engine::maxTileWidth(const QString &layoutId, const QRect &area) const
+{
+    // Monocle windows take the whole area by design
+    if (m_config->limitTileWidthRatio <= 0 || layoutId == QStringLiteral("MonocleLayout")) {
+        return 0;
+    }
+
+    // The limit is relative to the working area. Apart from the maximized
+    // monocle, the tiling area is the working area without the screen gaps.
+    const auto workingAreaHeight = area.height() + m_config->screenGapTop + m_config->screenGapBottom;
+    return static_cast<int>(std::floor(workingAreaHeight * m_config->limitTileWidthRatio));
+}
+
+void Engine::loadLayouts()
+{
+    const auto gap = m_config->tileLayoutGap;
+
+    m_layouts.clear();
+
+    auto add = [this](std::unique_ptr<Layout> layout) {
+        auto id = layout->id();
+        m_layouts.emplace(id, std::move(layout));
+    };
+
+    add(std::make_unique<TileLayout>(gap));
+    add(std::make_unique<ThreeColumnLayout>(gap));
+    add(std::make_unique<SpiralLayout>(gap));
+    add(std::make_unique<QuarterLayout>(gap));
+    add(std::make_unique<StairLayout>());
+    add(std::make_unique<SpreadLayout>());
+    add(std::make_unique<CascadeLayout>());
+    add(std::make_unique<MonocleLayout>());
+}
+
+}
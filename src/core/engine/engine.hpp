@@ -0,0 +1,95 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <QRect>
+#include <QString>
+#include <QThreadPool>
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "config-snapshot.hpp"
+#include "engine/geometry_buffer.hpp"
+#include "engine/layout/layout.hpp"
+
+namespace Bismuth
+{
+
+/**
+ * Everything needed to arrange one surface. Requests own their data, so that
+ * they could be computed on any thread.
+ */
+struct ArrangeRequest {
+    QString layoutId;
+    LayoutParameters parameters;
+    QRect area; ///< Tiling area of the surface
+    std::vector<qreal> weights;
+};
+
+/**
+ * Native tiling engine. Used by the TS backend, when the experimental
+ * backend is enabled.
+ */
+class Engine
+{
+public:
+    Engine(std::shared_ptr<const ConfigSnapshot>);
+
+    /**
+     * Apply the new configuration
+     */
+    void setConfig(std::shared_ptr<const ConfigSnapshot>);
+
+    /**
+     * @return the layout with the given id or nullptr, if there is no
+     * native implementation of it
+     */
+    const Layout *layout(const QString &layoutId) const;
+
+    /**
+     * Compute the geometries of all the tiles on the surface at once.
+     *
+     * @param layoutId id of the layout to use
+     * @param parameters per-surface parameters of the layout
+     * @param area the tiling area of the surface
+     * @param weights the weight of every tile
+     * @return geometries in the same order as @p weights. Empty if there is
+     * no such layout.
+     */
+    std::vector<QRect> arrange(const QString &layoutId, const LayoutParameters &parameters, const QRect &area, const std::vector<qreal> &weights) const;
+
+    /**
+     * Compute the geometries of all the tiles on the surface and apply the
+     * passes, that follow the layout, e.g. the tile width limit.
+     *
+     * @param area the tiling area of the surface, i.e. its working area
+     * without the screen gaps
+     * @param result buffer for the geometries. Emptied if there is no such layout.
+     */
+    void arrange(const QString &layoutId, const LayoutParameters &parameters, const QRect &area, const std::vector<qreal> &weights, GeometryBuffer &result) const;
+
+    /**
+     * Arrange several surfaces at the same time on the worker threads.
+     * Returns, when all of them are done.
+     *
+     * @param results buffers for the geometries, one for every request
+     */
+    void arrange(const std::vector<ArrangeRequest> &requests, std::vector<GeometryBuffer> &results) const;
+
+private:
+    void loadLayouts();
+
+    /**
+     * @return maximum width of the tiles in the tiling area or 0, if it is not limited
+     */
+    int maxTileWidth(const QString &layoutId, const QRect &area) const;
+
+    std::shared_ptr<const ConfigSnapshot> m_config;
+    std::unordered_map<QString, std::unique_ptr<Layout>> m_layouts;
+    mutable QThreadPool m_workers; ///< Arranges the surfaces in parallel
+};
+
+}
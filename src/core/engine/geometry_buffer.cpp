@@ -0,0 +1,47 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include "geometry_buffer.hpp"
+
+#include <algorithm>
+
+namespace Bismuth
+{
+
+int GeometryBuffer::size() const
+{
+    return static_cast<int>(m_geometries.size());
+}
+
+std::vector<QRect> &GeometryBuffer::geometries()
+{
+    return m_geometries;
+}
+
+QRect GeometryBuffer::at(int index) const
+{
+    return m_geometries[index];
+}
+
+void GeometryBuffer::clampWidth(int maxWidth)
+{
+    for (auto &geometry : m_geometries) {
+        const auto excess = geometry.width() - maxWidth;
+        if (excess > 0) {
+            geometry.setRect(geometry.x() + excess / 2, geometry.y(), maxWidth, geometry.height());
+        }
+    }
+}
+
+void GeometryBuffer::writeFlat(qint32 *values) const
+{
+    for (const auto &geometry : m_geometries) {
+        values[0] = geometry.x();
+        values[1] = geometry.y();
+        values[2] = geometry.width();
+        values[3] = geometry.height();
+        values += 4;
+    }
+}
+
+}
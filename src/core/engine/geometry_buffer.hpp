@@ -0,0 +1,47 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <QRect>
+
+#include <vector>
+
+namespace Bismuth
+{
+
+/**
+ * Geometries of the tiles on one surface.
+ *
+ * The layout writes its result straight into the buffer, and the passes,
+ * that follow it, change the geometries in place. The memory is kept
+ * between the arrangements, so that reusing a buffer does not allocate.
+ */
+class GeometryBuffer
+{
+public:
+    int size() const;
+
+    /**
+     * Vector for the layout to write the geometries into
+     */
+    std::vector<QRect> &geometries();
+
+    QRect at(int index) const;
+
+    /**
+     * Make the tiles at most @p maxWidth wide, keeping their centers in place
+     */
+    void clampWidth(int maxWidth);
+
+    /**
+     * Write x, y, width and height of every tile one after another
+     * @param values array with a place for 4 values per tile
+     */
+    void writeFlat(qint32 *values) const;
+
+private:
+    std::vector<QRect> m_geometries;
+};
+
+}
@@ -0,0 +1,74 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include "cascade_layout.hpp"
+
+#include <utility>
+
+namespace Bismuth
+{
+
+namespace
+{
+/**
+ * Decompose direction into vertical and horizontal steps
+ */
+std::pair<int, int> decomposeDirection(CascadeLayout::Direction direction)
+{
+    switch (direction) {
+    case CascadeLayout::Direction::NorthWest:
+        return {-1, -1};
+    case CascadeLayout::Direction::North:
+        return {-1, 0};
+    case CascadeLayout::Direction::NorthEast:
+        return {-1, 1};
+    case CascadeLayout::Direction::East:
+        return {0, 1};
+    case CascadeLayout::Direction::SouthEast:
+        return {1, 1};
+    case CascadeLayout::Direction::South:
+        return {1, 0};
+    case CascadeLayout::Direction::SouthWest:
+        return {1, -1};
+    case CascadeLayout::Direction::West:
+        return {0, -1};
+    }
+    return {1, 1};
+}
+}
+
+QString CascadeLayout::id() const
+{
+    return QStringLiteral("CascadeLayout");
+}
+
+LayoutParameters CascadeLayout::defaultParameters() const
+{
+    auto parameters = LayoutParameters();
+    parameters.direction = static_cast<int>(Direction::SouthEast);
+    return parameters;
+}
+
+void CascadeLayout::compute(const QRect &area, const std::vector<qreal> &weights, const LayoutParameters &parameters, std::vector<QRect> &result) const
+{
+    const auto count = static_cast<int>(weights.size());
+
+    const auto [vertStep, horzStep] = decomposeDirection(static_cast<Direction>(parameters.direction));
+
+    // TODO: adjustable step size
+    const auto stepSize = 25;
+
+    const auto windowWidth = horzStep != 0 ? area.width() - stepSize * (count - 1) : area.width();
+    const auto windowHeight = vertStep != 0 ? area.height() - stepSize * (count - 1) : area.height();
+
+    auto x = horzStep >= 0 ? area.x() : area.x() + area.width() - windowWidth;
+    auto y = vertStep >= 0 ? area.y() : area.y() + area.height() - windowHeight;
+
+    for (auto i = 0; i < count; ++i) {
+        result[i] = QRect(x, y, windowWidth, windowHeight);
+        x += horzStep * stepSize;
+        y += vertStep * stepSize;
+    }
+}
+
+}
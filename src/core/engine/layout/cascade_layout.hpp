@@ -0,0 +1,35 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "layout.hpp"
+
+namespace Bismuth
+{
+
+/**
+ * Windows cascaded from one corner or edge of the screen
+ */
+class CascadeLayout : public Layout
+{
+public:
+    enum class Direction {
+        NorthWest = 0,
+        North,
+        NorthEast,
+        East,
+        SouthEast,
+        South,
+        SouthWest,
+        West,
+    };
+
+    QString id() const override;
+    LayoutParameters defaultParameters() const override;
+
+protected:
+    void compute(const QRect &area, const std::vector<qreal> &weights, const LayoutParameters &parameters, std::vector<QRect> &result) const override;
+};
+
+}
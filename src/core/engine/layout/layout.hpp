@@ -0,0 +1,90 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <QRect>
+#include <QString>
+
+#include <vector>
+
+namespace Bismuth
+{
+
+/**
+ * Per-surface tunables of a layout, e.g. the master area ratio.
+ *
+ * Every layout uses only the fields it needs and ignores the rest.
+ */
+struct LayoutParameters {
+    int numMaster = 1; ///< Number of windows in the master area (Tile, ThreeColumn)
+    qreal masterRatio = 0.5; ///< Weight of the master area (Tile, ThreeColumn)
+    int angle = 0; ///< Rotation of the whole layout (Tile)
+    int masterAngle = 0; ///< Rotation of the master area (Tile)
+    qreal vsplit = 0.5; ///< Vertical split position (Quarter)
+    qreal lhsplit = 0.5; ///< Left-side horizontal split position (Quarter)
+    qreal rhsplit = 0.5; ///< Right-side horizontal split position (Quarter)
+    qreal space = 0; ///< Distance between the windows, in pixels (Stair) or as a ratio (Spread)
+    int direction = 0; ///< Cascade direction, @see CascadeLayout::Direction
+    std::vector<qreal> ratios{}; ///< Split ratio of every nesting level (Spiral)
+};
+
+/**
+ * Native implementation of a tiling layout.
+ *
+ * Layouts are stateless: everything, that may differ between surfaces is
+ * passed in LayoutParameters, so one object may serve all of them.
+ */
+class Layout
+{
+public:
+    virtual ~Layout() = default;
+
+    /**
+     * Layout identifier, the same as the one used in the TypeScript backend
+     */
+    virtual QString id() const = 0;
+
+    /**
+     * Parameters, with which the layout is created on a new surface
+     */
+    virtual LayoutParameters defaultParameters() const
+    {
+        return {};
+    }
+
+    /**
+     * Compute geometries of the tiles.
+     *
+     * @param area the area to place the tiles in
+     * @param weights the weight of every tile. Its size is the number of tiles.
+     * @param parameters per-surface layout parameters
+     * @return geometries of the tiles in the same order as @p weights. Tiles,
+     * that do not fit into the layout, are left out.
+     */
+    std::vector<QRect> apply(const QRect &area, const std::vector<qreal> &weights, const LayoutParameters &parameters) const
+    {
+        auto result = std::vector<QRect>();
+        apply(area, weights, parameters, result);
+        return result;
+    }
+
+    /**
+     * The same as above, but the geometries replace the contents of @p result,
+     * so that a vector reused between the arrangements does not allocate
+     */
+    void apply(const QRect &area, const std::vector<qreal> &weights, const LayoutParameters &parameters, std::vector<QRect> &result) const
+    {
+        result.resize(weights.size());
+        compute(area, weights, parameters, result);
+    }
+
+protected:
+    /**
+     * Compute geometries of the tiles into @p result, that already has a
+     * place for every tile. Layouts, that leave some tiles out, shrink it.
+     */
+    virtual void compute(const QRect &area, const std::vector<qreal> &weights, const LayoutParameters &parameters, std::vector<QRect> &result) const = 0;
+};
+
+}
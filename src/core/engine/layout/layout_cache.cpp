@@ -0,0 +1,107 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include "layout_cache.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Bismuth
+{
+
+namespace
+{
+/**
+ * One step of FNV-1a over the bits of the value
+ */
+template<typename T>
+void combine(quint64 &hash, T value)
+{
+    auto bits = quint64(0);
+    std::memcpy(&bits, &value, sizeof(value));
+    hash ^= bits;
+    hash *= 1099511628211ULL;
+}
+}
+
+LayoutCache::LayoutCache(std::size_t capacity)
+    : m_mutex()
+    , m_entries()
+    , m_capacity(std::max<std::size_t>(capacity, 1))
+{
+}
+
+quint64 LayoutCache::hash(const QRect &area, const LayoutParameters &parameters, const std::vector<qreal> &weights)
+{
+    auto result = quint64(14695981039346656037ULL);
+    combine(result, area.x());
+    combine(result, area.y());
+    combine(result, area.width());
+    combine(result, area.height());
+
+    // Only the parameters of the tile layout are hashed, the rest are compared
+    combine(result, parameters.numMaster);
+    combine(result, parameters.masterRatio);
+    combine(result, parameters.angle);
+    combine(result, parameters.masterAngle);
+
+    combine(result, weights.size());
+    for (auto weight : weights) {
+        combine(result, weight);
+    }
+    return result;
+}
+
+bool LayoutCache::find(quint64 hash, const QRect &area, const LayoutParameters &parameters, const std::vector<qreal> &weights, std::vector<QRect> &result)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_entries.find(hash);
+    if (it == m_entries.end() || !it->second.matches(area, parameters, weights)) {
+        ++m_misses;
+        return false;
+    }
+
+    // Layouts, that leave some tiles out, have fewer results than tiles
+    result.assign(it->second.result.cbegin(), it->second.result.cend());
+    ++m_hits;
+    return true;
+}
+
+void LayoutCache::insert(quint64 hash, const QRect &area, const LayoutParameters &parameters, const std::vector<qreal> &weights, const std::vector<QRect> &result)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Old results are usually never asked again, e.g. after a window is added
+    if (m_entries.size() >= m_capacity) {
+        m_entries.clear();
+    }
+
+    auto &entry = m_entries[hash];
+    entry.area = area;
+    entry.parameters = parameters;
+    entry.weights.assign(weights.cbegin(), weights.cend());
+    entry.result.assign(result.cbegin(), result.cend());
+}
+
+quint64 LayoutCache::hits() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_hits;
+}
+
+quint64 LayoutCache::misses() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_misses;
+}
+
+bool LayoutCache::Entry::matches(const QRect &area, const LayoutParameters &parameters, const std::vector<qreal> &weights) const
+{
+    const auto &p = this->parameters;
+    return this->area == area && this->weights == weights && p.numMaster == parameters.numMaster && p.masterRatio == parameters.masterRatio
+        && p.angle == parameters.angle && p.masterAngle == parameters.masterAngle && p.vsplit == parameters.vsplit && p.lhsplit == parameters.lhsplit
+        && p.rhsplit == parameters.rhsplit && p.space == parameters.space && p.direction == parameters.direction && p.ratios == parameters.ratios;
+}
+
+}
@@ -0,0 +1,72 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <QRect>
+
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "layout.hpp"
+
+namespace Bismuth
+{
+
+/**
+ * Memoized results of a whole layout.
+ *
+ * A result is stored under the inputs of the layout: the area, the
+ * parameters and the weights of the tiles. Most of the arrangements, e.g.
+ * after a focus change, pass the same inputs again, and then the result is
+ * copied instead of being computed.
+ *
+ * The cache is bounded and is dropped as a whole, when it is full.
+ * It is safe to use from multiple threads.
+ */
+class LayoutCache
+{
+public:
+    /**
+     * @param capacity maximum number of the cached results
+     */
+    explicit LayoutCache(std::size_t capacity = 64);
+
+    /**
+     * @return hash of the inputs, that is passed to find and insert
+     */
+    static quint64 hash(const QRect &area, const LayoutParameters &parameters, const std::vector<qreal> &weights);
+
+    /**
+     * Copy the cached result into @p result, that has a place for every tile
+     * @return whether the result for the inputs was found
+     */
+    bool find(quint64 hash, const QRect &area, const LayoutParameters &parameters, const std::vector<qreal> &weights, std::vector<QRect> &result);
+
+    /**
+     * Remember the result for the inputs
+     */
+    void insert(quint64 hash, const QRect &area, const LayoutParameters &parameters, const std::vector<qreal> &weights, const std::vector<QRect> &result);
+
+    quint64 hits() const;
+    quint64 misses() const;
+
+private:
+    struct Entry {
+        QRect area;
+        LayoutParameters parameters;
+        std::vector<qreal> weights; ///< Full inputs, as different inputs may have the same hash
+        std::vector<QRect> result;
+
+        bool matches(const QRect &area, const LayoutParameters &parameters, const std::vector<qreal> &weights) const;
+    };
+
+    mutable std::mutex m_mutex;
+    std::unordered_map<quint64, Entry> m_entries;
+    std::size_t m_capacity;
+    quint64 m_hits = 0;
+    quint64 m_misses = 0;
+};
+
+}
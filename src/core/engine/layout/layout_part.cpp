@@ -0,0 +1,101 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include "layout_part.hpp"
+
+#include "layout_utils.hpp"
+
+namespace Bismuth
+{
+
+void FillLayoutPart::apply(const QRect &area, const qreal *, int count, QRect *result) const
+{
+    for (auto i = 0; i < count; ++i) {
+        result[i] = area;
+    }
+}
+
+HalfSplitLayoutPart::HalfSplitLayoutPart(const LayoutPart &primary, const LayoutPart &secondary)
+    : m_primary(primary)
+    , m_secondary(secondary)
+{
+}
+
+void HalfSplitLayoutPart::apply(const QRect &area, const qreal *weights, int count, QRect *result) const
+{
+    if (count <= primarySize) {
+        // Primary only
+        m_primary.apply(area, weights, count, result);
+    } else if (primarySize == 0) {
+        // Secondary only
+        m_secondary.apply(area, weights, count, result);
+    } else {
+        // Both parts
+        const auto isReversed = reversed();
+        const auto areas = LayoutUtils::splitAreaHalfWeighted(area, isReversed ? 1 - ratio : ratio, gap, horizontal());
+
+        m_primary.apply(isReversed ? areas[1] : areas[0], weights, primarySize, result);
+        m_secondary.apply(isReversed ? areas[0] : areas[1], weights + primarySize, count - primarySize, result + primarySize);
+    }
+}
+
+bool HalfSplitLayoutPart::horizontal() const
+{
+    return angle == 0 || angle == 180;
+}
+
+bool HalfSplitLayoutPart::reversed() const
+{
+    return angle == 180 || angle == 270;
+}
+
+void StackLayoutPart::apply(const QRect &area, const qreal *weights, int count, QRect *result) const
+{
+    LayoutUtils::splitAreaWeighted(area, weights, count, gap, false, result);
+}
+
+RotateLayoutPart::RotateLayoutPart(const LayoutPart &inner, int angle)
+    : angle(angle)
+    , m_inner(inner)
+{
+}
+
+void RotateLayoutPart::apply(const QRect &area, const qreal *weights, int count, QRect *result) const
+{
+    auto transposed = [](const QRect &r) {
+        return QRect(r.y(), r.x(), r.height(), r.width());
+    };
+
+    const auto innerArea = (angle == 90 || angle == 270) ? transposed(area) : area;
+
+    m_inner.apply(innerArea, weights, count, result);
+
+    if (angle == 0) {
+        return;
+    }
+
+    for (auto i = 0; i < count; ++i) {
+        const auto &g = result[i];
+        switch (angle) {
+        case 90:
+            result[i] = transposed(g);
+            break;
+        case 180: {
+            const auto rx = g.x() - innerArea.x();
+            const auto newX = innerArea.x() + innerArea.width() - (rx + g.width());
+            result[i] = QRect(newX, g.y(), g.width(), g.height());
+            break;
+        }
+        case 270: {
+            const auto rx = g.x() - innerArea.x();
+            const auto newY = innerArea.x() + innerArea.width() - (rx + g.width());
+            result[i] = QRect(g.y(), newY, g.height(), g.width());
+            break;
+        }
+        default:
+            break;
+        }
+    }
+}
+
+}
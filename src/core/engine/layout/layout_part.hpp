@@ -0,0 +1,104 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <QRect>
+
+namespace Bismuth
+{
+
+/**
+ * Building block of the layouts. Layout parts could be combined into a tree,
+ * where every node places a portion of tiles in a portion of the area.
+ *
+ * Parts write into a caller-provided buffer, so that computing the whole
+ * tree does not allocate.
+ */
+class LayoutPart
+{
+public:
+    virtual ~LayoutPart() = default;
+
+    /**
+     * Compute geometries of the tiles.
+     *
+     * @param area the area to place the tiles in
+     * @param weights the weight of every tile
+     * @param count the number of tiles
+     * @param result output array, which must have room for @p count rects
+     */
+    virtual void apply(const QRect &area, const qreal *weights, int count, QRect *result) const = 0;
+};
+
+/**
+ * Gives the whole area to every tile
+ */
+class FillLayoutPart : public LayoutPart
+{
+public:
+    void apply(const QRect &area, const qreal *weights, int count, QRect *result) const override;
+};
+
+/**
+ * Splits the area into two halves: the primary one for the first
+ * @c primarySize tiles and the secondary one for the rest.
+ */
+class HalfSplitLayoutPart : public LayoutPart
+{
+public:
+    HalfSplitLayoutPart(const LayoutPart &primary, const LayoutPart &secondary);
+
+    void apply(const QRect &area, const qreal *weights, int count, QRect *result) const override;
+
+    /**
+     * The rotation angle for this part.
+     *
+     *    | angle | direction  | primary |
+     *    | ----- | ---------- | ------- |
+     *    |     0 | horizontal | left    |
+     *    |    90 | vertical   | top     |
+     *    |   180 | horizontal | right   |
+     *    |   270 | vertical   | bottom  |
+     */
+    int angle = 0;
+    int gap = 0;
+    int primarySize = 1;
+    qreal ratio = 0.5;
+
+private:
+    bool horizontal() const;
+    bool reversed() const;
+
+    const LayoutPart &m_primary;
+    const LayoutPart &m_secondary;
+};
+
+/**
+ * Splits the area vertically between all the tiles according to their weights
+ */
+class StackLayoutPart : public LayoutPart
+{
+public:
+    void apply(const QRect &area, const qreal *weights, int count, QRect *result) const override;
+
+    int gap = 0;
+};
+
+/**
+ * Rotates the inner part by the multiple of 90 degrees
+ */
+class RotateLayoutPart : public LayoutPart
+{
+public:
+    RotateLayoutPart(const LayoutPart &inner, int angle = 0);
+
+    void apply(const QRect &area, const qreal *weights, int count, QRect *result) const override;
+
+    int angle;
+
+private:
+    const LayoutPart &m_inner;
+};
+
+}
@@ -0,0 +1,57 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include "layout_utils.hpp"
+
+#include <cmath>
+
+namespace Bismuth
+{
+namespace LayoutUtils
+{
+
+void splitAreaWeighted(const QRect &area, const qreal *weights, int count, int gap, bool horizontal, QRect *result)
+{
+    if (count <= 0) {
+        return;
+    }
+
+    const auto begin = horizontal ? area.x() : area.y();
+    const auto length = horizontal ? area.width() : area.height();
+
+    const auto actualLength = static_cast<qreal>(length - (count - 1) * gap);
+
+    auto weightSum = qreal(0);
+    for (auto i = 0; i < count; ++i) {
+        weightSum += weights[i];
+    }
+
+    auto weightAcc = qreal(0);
+    for (auto i = 0; i < count; ++i) {
+        const auto partBegin = begin + static_cast<int>(std::floor(actualLength * weightAcc / weightSum + i * gap));
+        const auto partLength = static_cast<int>(std::floor(actualLength * weights[i] / weightSum));
+        weightAcc += weights[i];
+
+        if (horizontal) {
+            result[i] = QRect(partBegin, area.y(), partLength, area.height());
+        } else {
+            result[i] = QRect(area.x(), partBegin, area.width(), partLength);
+        }
+    }
+}
+
+std::array<QRect, 2> splitAreaHalfWeighted(const QRect &area, qreal weight, int gap, bool horizontal)
+{
+    const qreal weights[] = {weight, 1 - weight};
+    auto result = std::array<QRect, 2>();
+    splitAreaWeighted(area, weights, 2, gap, horizontal, result.data());
+    return result;
+}
+
+QRect gap(const QRect &rect, int left, int right, int top, int bottom)
+{
+    return QRect(rect.x() + left, rect.y() + top, rect.width() - (left + right), rect.height() - (top + bottom));
+}
+
+}
+}
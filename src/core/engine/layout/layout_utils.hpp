@@ -0,0 +1,44 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <QRect>
+
+#include <array>
+
+namespace Bismuth
+{
+namespace LayoutUtils
+{
+
+/**
+ * Split an area into multiple parts based on weight.
+ *
+ * @param area the area to be split
+ * @param weights the weight of each part
+ * @param count the number of parts
+ * @param gap the size of gaps between parts
+ * @param horizontal if true, split horizontally. Otherwise, vertically.
+ * @param result output array, which must have room for @p count rects
+ */
+void splitAreaWeighted(const QRect &area, const qreal *weights, int count, int gap, bool horizontal, QRect *result);
+
+/**
+ * Split an area into two based on weight.
+ *
+ * @param area the area to be split
+ * @param weight the weight of the left/upper part
+ * @param gap the size of the gap between parts
+ * @param horizontal if true, split horizontally. Otherwise, vertically.
+ */
+std::array<QRect, 2> splitAreaHalfWeighted(const QRect &area, qreal weight, int gap, bool horizontal);
+
+/**
+ * Shrink the rect from each side by the given amounts.
+ * Same as Rect#gap in the TypeScript backend.
+ */
+QRect gap(const QRect &rect, int left, int right, int top, int bottom);
+
+}
+}
@@ -0,0 +1,21 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include "monocle_layout.hpp"
+
+#include <algorithm>
+
+namespace Bismuth
+{
+
+QString MonocleLayout::id() const
+{
+    return QStringLiteral("MonocleLayout");
+}
+
+void MonocleLayout::compute(const QRect &area, const std::vector<qreal> &, const LayoutParameters &, std::vector<QRect> &result) const
+{
+    std::fill(result.begin(), result.end(), area);
+}
+
+}
@@ -0,0 +1,23 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "layout.hpp"
+
+namespace Bismuth
+{
+
+/**
+ * Every window takes the whole area
+ */
+class MonocleLayout : public Layout
+{
+public:
+    QString id() const override;
+
+protected:
+    void compute(const QRect &area, const std::vector<qreal> &weights, const LayoutParameters &parameters, std::vector<QRect> &result) const override;
+};
+
+}
@@ -0,0 +1,71 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include "quarter_layout.hpp"
+
+#include "layout_utils.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Bismuth
+{
+
+QuarterLayout::QuarterLayout(int gap)
+    : m_gap(gap)
+{
+}
+
+QString QuarterLayout::id() const
+{
+    return QStringLiteral("QuarterLayout");
+}
+
+void QuarterLayout::compute(const QRect &area, const std::vector<qreal> &weights, const LayoutParameters &parameters, std::vector<QRect> &result) const
+{
+    using LayoutUtils::gap;
+
+    const auto count = std::min(static_cast<int>(weights.size()), capacity);
+    result.resize(count);
+
+    if (count == 0) {
+        return;
+    }
+
+    if (count == 1) {
+        result[0] = area;
+        return;
+    }
+
+    const auto gap1 = m_gap / 2;
+    const auto gap2 = m_gap - gap1;
+
+    const auto leftWidth = static_cast<int>(std::floor(area.width() * parameters.vsplit));
+    const auto rightWidth = area.width() - leftWidth;
+    const auto rightX = area.x() + leftWidth;
+    if (count == 2) {
+        result[0] = gap(QRect(area.x(), area.y(), leftWidth, area.height()), 0, gap1, 0, 0);
+        result[1] = gap(QRect(rightX, area.y(), rightWidth, area.height()), gap2, 0, 0, 0);
+        return;
+    }
+
+    const auto rightTopHeight = static_cast<int>(std::floor(area.height() * parameters.rhsplit));
+    const auto rightBottomHeight = area.height() - rightTopHeight;
+    const auto rightBottomY = area.y() + rightTopHeight;
+    if (count == 3) {
+        result[0] = gap(QRect(area.x(), area.y(), leftWidth, area.height()), 0, gap1, 0, 0);
+        result[1] = gap(QRect(rightX, area.y(), rightWidth, rightTopHeight), gap2, 0, 0, gap1);
+        result[2] = gap(QRect(rightX, rightBottomY, rightWidth, rightBottomHeight), gap2, 0, gap2, 0);
+        return;
+    }
+
+    const auto leftTopHeight = static_cast<int>(std::floor(area.height() * parameters.lhsplit));
+    const auto leftBottomHeight = area.height() - leftTopHeight;
+    const auto leftBottomY = area.y() + leftTopHeight;
+    result[0] = gap(QRect(area.x(), area.y(), leftWidth, leftTopHeight), 0, gap1, 0, gap1);
+    result[1] = gap(QRect(rightX, area.y(), rightWidth, rightTopHeight), gap2, 0, 0, gap1);
+    result[2] = gap(QRect(rightX, rightBottomY, rightWidth, rightBottomHeight), gap2, 0, gap2, 0);
+    result[3] = gap(QRect(area.x(), leftBottomY, leftWidth, leftBottomHeight), 0, gap2, gap2, 0);
+}
+
+}
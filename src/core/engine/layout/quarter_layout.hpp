@@ -0,0 +1,30 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "layout.hpp"
+
+namespace Bismuth
+{
+
+/**
+ * Up to four windows, each in its own quarter of the screen
+ */
+class QuarterLayout : public Layout
+{
+public:
+    explicit QuarterLayout(int gap);
+
+    QString id() const override;
+
+    static constexpr int capacity = 4;
+
+protected:
+    void compute(const QRect &area, const std::vector<qreal> &weights, const LayoutParameters &parameters, std::vector<QRect> &result) const override;
+
+private:
+    int m_gap;
+};
+
+}
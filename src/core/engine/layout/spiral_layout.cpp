@@ -0,0 +1,68 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include "spiral_layout.hpp"
+
+#include "layout_part.hpp"
+
+namespace Bismuth
+{
+
+namespace
+{
+/**
+ * The rest of the spiral after the given nesting level.
+ *
+ * Spiral is an unbounded chain of HalfSplit(Fill, Spiral) parts. Instead of
+ * building the chain beforehand, every level is created on the stack when
+ * it is reached.
+ */
+class SpiralTailPart : public LayoutPart
+{
+public:
+    SpiralTailPart(int level, int gap, const std::vector<qreal> &ratios)
+        : m_level(level)
+        , m_gap(gap)
+        , m_ratios(ratios)
+    {
+    }
+
+    void apply(const QRect &area, const qreal *weights, int count, QRect *result) const override
+    {
+        auto fill = FillLayoutPart();
+        auto tail = SpiralTailPart(m_level + 1, m_gap, m_ratios);
+
+        auto part = HalfSplitLayoutPart(fill, tail);
+        part.angle = (m_level % 4) * 90;
+        part.gap = m_gap;
+        if (static_cast<size_t>(m_level) < m_ratios.size()) {
+            part.ratio = m_ratios[m_level];
+        }
+
+        part.apply(area, weights, count, result);
+    }
+
+private:
+    int m_level;
+    int m_gap;
+    const std::vector<qreal> &m_ratios;
+};
+}
+
+SpiralLayout::SpiralLayout(int gap)
+    : m_gap(gap)
+{
+}
+
+QString SpiralLayout::id() const
+{
+    return QStringLiteral("SpiralLayout");
+}
+
+void SpiralLayout::compute(const QRect &area, const std::vector<qreal> &weights, const LayoutParameters &parameters, std::vector<QRect> &result) const
+{
+    auto root = SpiralTailPart(0, m_gap, parameters.ratios);
+    root.apply(area, weights.data(), static_cast<int>(weights.size()), result.data());
+}
+
+}
@@ -0,0 +1,29 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "layout.hpp"
+
+namespace Bismuth
+{
+
+/**
+ * Every next window takes the half of the space, left by the previous one,
+ * going clockwise
+ */
+class SpiralLayout : public Layout
+{
+public:
+    explicit SpiralLayout(int gap);
+
+    QString id() const override;
+
+protected:
+    void compute(const QRect &area, const std::vector<qreal> &weights, const LayoutParameters &parameters, std::vector<QRect> &result) const override;
+
+private:
+    int m_gap;
+};
+
+}
@@ -0,0 +1,44 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include "spread_layout.hpp"
+
+#include <cmath>
+
+namespace Bismuth
+{
+
+QString SpreadLayout::id() const
+{
+    return QStringLiteral("SpreadLayout");
+}
+
+LayoutParameters SpreadLayout::defaultParameters() const
+{
+    auto parameters = LayoutParameters();
+    parameters.space = 0.07;
+    return parameters;
+}
+
+void SpreadLayout::compute(const QRect &area, const std::vector<qreal> &weights, const LayoutParameters &parameters, std::vector<QRect> &result) const
+{
+    const auto count = static_cast<int>(weights.size());
+
+    auto numTiles = count;
+    const auto spaceWidth = static_cast<int>(std::floor(area.width() * parameters.space));
+    auto cardWidth = area.width() - spaceWidth * (numTiles - 1);
+
+    // TODO: define arbitrary constants
+    const auto minimumCardWidth = area.width() * 0.4;
+    while (cardWidth < minimumCardWidth && numTiles > 1) {
+        cardWidth += spaceWidth;
+        numTiles -= 1;
+    }
+
+    for (auto i = 0; i < count; ++i) {
+        const auto x = area.x() + (i < numTiles ? spaceWidth * (numTiles - i - 1) : 0);
+        result[i] = QRect(x, area.y(), cardWidth, area.height());
+    }
+}
+
+}
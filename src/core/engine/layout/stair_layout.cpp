@@ -0,0 +1,33 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include "stair_layout.hpp"
+
+namespace Bismuth
+{
+
+QString StairLayout::id() const
+{
+    return QStringLiteral("StairLayout");
+}
+
+LayoutParameters StairLayout::defaultParameters() const
+{
+    auto parameters = LayoutParameters();
+    parameters.space = 24;
+    return parameters;
+}
+
+void StairLayout::compute(const QRect &area, const std::vector<qreal> &weights, const LayoutParameters &parameters, std::vector<QRect> &result) const
+{
+    const auto count = static_cast<int>(weights.size());
+    const auto space = static_cast<int>(parameters.space);
+
+    for (auto i = 0; i < count; ++i) {
+        const auto dx = space * (count - i - 1);
+        const auto dy = space * i;
+        result[i] = QRect(area.x() + dx, area.y() + dy, area.width() - dx, area.height() - dy);
+    }
+}
+
+}
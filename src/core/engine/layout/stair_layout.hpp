@@ -0,0 +1,24 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "layout.hpp"
+
+namespace Bismuth
+{
+
+/**
+ * Windows placed on top of each other like stairs
+ */
+class StairLayout : public Layout
+{
+public:
+    QString id() const override;
+    LayoutParameters defaultParameters() const override;
+
+protected:
+    void compute(const QRect &area, const std::vector<qreal> &weights, const LayoutParameters &parameters, std::vector<QRect> &result) const override;
+};
+
+}
@@ -0,0 +1,60 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include "three_column_layout.hpp"
+
+#include "layout_utils.hpp"
+
+namespace Bismuth
+{
+
+ThreeColumnLayout::ThreeColumnLayout(int gap)
+    : m_gap(gap)
+{
+}
+
+QString ThreeColumnLayout::id() const
+{
+    return QStringLiteral("ThreeColumnLayout");
+}
+
+LayoutParameters ThreeColumnLayout::defaultParameters() const
+{
+    auto parameters = LayoutParameters();
+    parameters.masterRatio = 0.6;
+    return parameters;
+}
+
+void ThreeColumnLayout::compute(const QRect &area, const std::vector<qreal> &weights, const LayoutParameters &parameters, std::vector<QRect> &result) const
+{
+    const auto count = static_cast<int>(weights.size());
+    const auto masterSize = parameters.numMaster;
+
+    if (count <= masterSize) {
+        // Only master
+        LayoutUtils::splitAreaWeighted(area, weights.data(), count, m_gap, false, result.data());
+    } else if (count == masterSize + 1) {
+        // Master & R-stack (only 1 window in stack)
+        const auto areas = LayoutUtils::splitAreaHalfWeighted(area, parameters.masterRatio, m_gap, true);
+        LayoutUtils::splitAreaWeighted(areas[0], weights.data(), masterSize, m_gap, false, result.data());
+        result[count - 1] = areas[1];
+    } else {
+        // L-stack & master & R-stack
+        const auto stackRatio = 1 - parameters.masterRatio;
+        const qreal groupWeights[] = {stackRatio, parameters.masterRatio, stackRatio};
+
+        // Areas allocated to L-stack, master, and R-stack
+        QRect groupAreas[3];
+        LayoutUtils::splitAreaWeighted(area, groupWeights, 3, m_gap, true, groupAreas);
+
+        // Tiles are ordered as master, R-stack, L-stack
+        const auto rstackSize = (count - masterSize) / 2;
+        const auto lstackBegin = masterSize + rstackSize;
+
+        LayoutUtils::splitAreaWeighted(groupAreas[1], weights.data(), masterSize, m_gap, false, result.data());
+        LayoutUtils::splitAreaWeighted(groupAreas[2], weights.data() + masterSize, rstackSize, m_gap, false, result.data() + masterSize);
+        LayoutUtils::splitAreaWeighted(groupAreas[0], weights.data() + lstackBegin, count - lstackBegin, m_gap, false, result.data() + lstackBegin);
+    }
+}
+
+}
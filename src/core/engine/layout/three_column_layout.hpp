@@ -0,0 +1,29 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "layout.hpp"
+
+namespace Bismuth
+{
+
+/**
+ * Master column in the middle and two stacks on its sides
+ */
+class ThreeColumnLayout : public Layout
+{
+public:
+    explicit ThreeColumnLayout(int gap);
+
+    QString id() const override;
+    LayoutParameters defaultParameters() const override;
+
+protected:
+    void compute(const QRect &area, const std::vector<qreal> &weights, const LayoutParameters &parameters, std::vector<QRect> &result) const override;
+
+private:
+    int m_gap;
+};
+
+}
@@ -0,0 +1,50 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include "tile_layout.hpp"
+
+#include "layout_part.hpp"
+
+namespace Bismuth
+{
+
+TileLayout::TileLayout(int gap)
+    : m_gap(gap)
+    , m_cache()
+{
+}
+
+QString TileLayout::id() const
+{
+    return QStringLiteral("TileLayout");
+}
+
+void TileLayout::compute(const QRect &area, const std::vector<qreal> &weights, const LayoutParameters &parameters, std::vector<QRect> &result) const
+{
+    const auto hash = LayoutCache::hash(area, parameters, weights);
+    if (m_cache.find(hash, area, parameters, weights, result)) {
+        return;
+    }
+
+    // Same structure as in the TypeScript backend:
+    // Rotate(HalfSplit(Rotate(Stack), Stack))
+    auto masterStack = StackLayoutPart();
+    masterStack.gap = m_gap;
+
+    auto masterPart = RotateLayoutPart(masterStack, parameters.masterAngle);
+
+    auto stack = StackLayoutPart();
+    stack.gap = m_gap;
+
+    auto split = HalfSplitLayoutPart(masterPart, stack);
+    split.gap = m_gap;
+    split.primarySize = parameters.numMaster;
+    split.ratio = parameters.masterRatio;
+
+    auto root = RotateLayoutPart(split, parameters.angle);
+    root.apply(area, weights.data(), static_cast<int>(weights.size()), result.data());
+
+    m_cache.insert(hash, area, parameters, weights, result);
+}
+
+}
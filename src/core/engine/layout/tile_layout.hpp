@@ -0,0 +1,34 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "layout.hpp"
+#include "layout_cache.hpp"
+
+namespace Bismuth
+{
+
+/**
+ * Master area and the stack, both of which could be rotated.
+ *
+ * Results are memoized, so an arrangement with the same inputs copies the
+ * previous result. The cache does not change the results, so the layout is
+ * still shared between the surfaces.
+ */
+class TileLayout : public Layout
+{
+public:
+    explicit TileLayout(int gap);
+
+    QString id() const override;
+
+protected:
+    void compute(const QRect &area, const std::vector<qreal> &weights, const LayoutParameters &parameters, std::vector<QRect> &result) const override;
+
+private:
+    int m_gap;
+    mutable LayoutCache m_cache;
+};
+
+}
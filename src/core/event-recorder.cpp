@@ -0,0 +1,231 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include "event-recorder.hpp"
+
+#include <QRectF>
+#include <QSizeF>
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+#include "logger.hpp"
+
+namespace Bismuth
+{
+
+EventRecorder::EventRecorder()
+    : m_file()
+    , m_stream()
+    , m_started(false)
+    , m_clock()
+    , m_lastEvent(0)
+    , m_clientIds()
+    , m_nextClientId(1)
+{
+}
+
+EventRecorder::~EventRecorder()
+{
+    stop();
+}
+
+bool EventRecorder::start(const QString &path)
+{
+    stop();
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCWarning(Bi) << "Cannot write the event trace to" << path << ":" << m_file.errorString();
+        return false;
+    }
+
+    m_stream.setDevice(&m_file);
+    return true;
+}
+
+QString EventRecorder::stop()
+{
+    if (!m_file.isOpen()) {
+        return {};
+    }
+
+    m_stream.setDevice(nullptr);
+    m_file.close();
+    m_clientIds.clear();
+
+    // A trace without the header cannot be replayed
+    const auto started = std::exchange(m_started, false);
+    if (!started) {
+        m_file.remove();
+        return {};
+    }
+
+    qCInfo(Bi) << "Event trace is written to" << m_file.fileName();
+    return m_file.fileName();
+}
+
+bool EventRecorder::isRecording() const
+{
+    return m_file.isOpen();
+}
+
+void EventRecorder::recordWorkspace(TraceWorkspace workspace, const QList<QObject *> &clients)
+{
+    if (!m_file.isOpen() || m_started) {
+        return;
+    }
+
+    workspace.clients.clear();
+    for (auto client : clients) {
+        workspace.clients.push_back(readClient(client));
+    }
+
+    EventTrace::writeHeader(m_stream, workspace);
+    m_started = true;
+    m_lastEvent = 0;
+    m_clock.start();
+}
+
+void EventRecorder::recordEvent(TraceEvent::Type type, QObject *client, const QVariant &value)
+{
+    if (!m_started) {
+        return;
+    }
+
+    auto event = TraceEvent();
+    event.type = type;
+    if (client) {
+        event.client = clientId(client);
+    }
+
+    switch (type) {
+    case TraceEvent::ClientAdded:
+        if (!client) {
+            return;
+        }
+        event.state = readClient(client);
+        break;
+    case TraceEvent::ClientRemoved:
+    case TraceEvent::ClientMinimized:
+    case TraceEvent::ClientUnminimized:
+        break;
+    case TraceEvent::ClientMaximizeSet:
+    case TraceEvent::CurrentDesktopChanged:
+        event.value = value.toInt();
+        break;
+    case TraceEvent::CurrentActivityChanged:
+        event.text = value.toString();
+        break;
+    case TraceEvent::FrameGeometryChanged:
+        event.geometry = client->property("frameGeometry").toRectF().toRect();
+        break;
+    case TraceEvent::MoveResizedChanged:
+        event.value = (client->property("move").toBool() ? TraceClient::Move : 0) | (client->property("resize").toBool() ? TraceClient::Resize : 0);
+        break;
+    case TraceEvent::ActiveChanged:
+        event.value = client->property("active").toBool();
+        break;
+    case TraceEvent::ScreenChanged:
+        event.value = client->property("screen").toInt();
+        break;
+    case TraceEvent::ActivitiesChanged:
+        event.activities = client->property("activities").toStringList();
+        break;
+    case TraceEvent::DesktopChanged:
+        event.value = client->property("desktop").toInt();
+        break;
+    case TraceEvent::FullScreenChanged:
+        event.value = client->property("fullScreen").toBool();
+        break;
+    case TraceEvent::ShadeChanged:
+        event.value = client->property("shade").toBool();
+        break;
+    case TraceEvent::ShortcutTriggered:
+        return;
+    }
+
+    write(event);
+
+    // The address may be reused by the next client
+    if (type == TraceEvent::ClientRemoved) {
+        m_clientIds.erase(client);
+    }
+}
+
+void EventRecorder::recordShortcut(const QString &id, int repeatCount)
+{
+    if (!m_started) {
+        return;
+    }
+
+    auto event = TraceEvent();
+    event.type = TraceEvent::ShortcutTriggered;
+    event.text = id;
+    event.value = repeatCount;
+    write(event);
+}
+
+TraceClient EventRecorder::readClient(QObject *client)
+{
+    auto state = TraceClient();
+    state.id = clientId(client);
+    state.windowId = client->property("windowId").toUInt();
+    state.resourceClass = client->property("resourceClass").toString();
+    state.resourceName = client->property("resourceName").toString();
+    state.windowRole = client->property("windowRole").toString();
+    state.caption = client->property("caption").toString();
+    state.frameGeometry = client->property("frameGeometry").toRectF().toRect();
+    state.minSize = client->property("minSize").toSizeF().toSize();
+    state.maxSize = client->property("maxSize").toSizeF().toSize();
+    state.screen = client->property("screen").toInt();
+    state.desktop = client->property("desktop").toInt();
+    state.activities = client->property("activities").toStringList();
+
+    const std::pair<const char *, TraceClient::Flag> flags[] = {
+        {"active", TraceClient::Active},
+        {"dialog", TraceClient::Dialog},
+        {"splash", TraceClient::Splash},
+        {"utility", TraceClient::Utility},
+        {"modal", TraceClient::Modal},
+        {"resizeable", TraceClient::Resizeable},
+        {"specialWindow", TraceClient::SpecialWindow},
+        {"transient", TraceClient::Transient},
+        {"fullScreen", TraceClient::FullScreen},
+        {"keepAbove", TraceClient::KeepAbove},
+        {"keepBelow", TraceClient::KeepBelow},
+        {"minimized", TraceClient::Minimized},
+        {"noBorder", TraceClient::NoBorder},
+        {"shade", TraceClient::Shade},
+        {"move", TraceClient::Move},
+        {"resize", TraceClient::Resize},
+    };
+    for (auto &[name, flag] : flags) {
+        if (client->property(name).toBool()) {
+            state.flags |= flag;
+        }
+    }
+
+    return state;
+}
+
+quint32 EventRecorder::clientId(QObject *client)
+{
+    auto [it, inserted] = m_clientIds.emplace(client, m_nextClientId);
+    if (inserted) {
+        ++m_nextClientId;
+    }
+    return it->second;
+}
+
+void EventRecorder::write(TraceEvent &event)
+{
+    const auto now = m_clock.nsecsElapsed() / 1000;
+    event.delay = static_cast<quint32>(std::clamp<qint64>(now - m_lastEvent, 0, std::numeric_limits<quint32>::max()));
+    m_lastEvent = now;
+
+    EventTrace::writeEvent(m_stream, event);
+}
+
+}
@@ -0,0 +1,87 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <QDataStream>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QList>
+#include <QObject>
+#include <QVariant>
+
+#include <unordered_map>
+
+#include "event-trace.hpp"
+
+namespace Bismuth
+{
+
+/**
+ * Writes the events, that the script receives from KWin, to an event trace.
+ *
+ * The properties of the clients are read directly from the KWin objects,
+ * so recording adds only a few property reads to every event. The events
+ * are appended to the file as they come, @see EventTrace.
+ */
+class EventRecorder
+{
+public:
+    EventRecorder();
+    ~EventRecorder();
+
+    EventRecorder(const EventRecorder &) = delete;
+    EventRecorder &operator=(const EventRecorder &) = delete;
+
+    /**
+     * Open the trace file. The events are recorded only after the state of
+     * the workspace is passed to recordWorkspace.
+     * @return whether the file was opened
+     */
+    bool start(const QString &path);
+
+    /**
+     * Finish the recording
+     * @return path of the written trace or an empty string, if nothing was recorded
+     */
+    QString stop();
+
+    /**
+     * @return whether the file is open, even if the workspace is not recorded yet
+     */
+    bool isRecording() const;
+
+    /**
+     * Write the header of the trace
+     * @param clients KWin clients, that already exist
+     */
+    void recordWorkspace(TraceWorkspace, const QList<QObject *> &clients);
+
+    /**
+     * Append the event with the current properties of the client
+     * @param client KWin client or nullptr for the workspace events
+     * @param value argument of the workspace signal, e.g. the new desktop,
+     * or the arguments of clientMaximizeSet as a combination of 1 and 2
+     */
+    void recordEvent(TraceEvent::Type, QObject *client, const QVariant &value = QVariant());
+
+    /**
+     * Append the trigger of the shortcut
+     */
+    void recordShortcut(const QString &id, int repeatCount);
+
+private:
+    TraceClient readClient(QObject *);
+    quint32 clientId(QObject *);
+    void write(TraceEvent &);
+
+    QFile m_file;
+    QDataStream m_stream;
+    bool m_started; ///< Whether the header is written
+    QElapsedTimer m_clock;
+    qint64 m_lastEvent; ///< Time of the previous event in microseconds
+    std::unordered_map<QObject *, quint32> m_clientIds;
+    quint32 m_nextClientId;
+};
+
+}
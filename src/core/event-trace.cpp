@@ -0,0 +1,305 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include "event-trace.hpp"
+
+#include <QFile>
+
+#include "logger.hpp"
+
+namespace Bismuth
+{
+
+namespace
+{
+/**
+ * Read the number of the following elements. Every element takes at least
+ * four bytes, so a greater number means, that the data is damaged.
+ */
+std::optional<quint32> readCount(QDataStream &stream, int dataSize)
+{
+    auto count = quint32(0);
+    stream >> count;
+    if (stream.status() != QDataStream::Ok || count > static_cast<quint32>(dataSize / 4)) {
+        return std::nullopt;
+    }
+    return count;
+}
+
+void writeStrings(QDataStream &stream, const QStringList &strings)
+{
+    stream << static_cast<quint32>(strings.size());
+    for (auto &string : strings) {
+        stream << string;
+    }
+}
+
+bool readStrings(QDataStream &stream, int dataSize, QStringList &strings)
+{
+    auto count = readCount(stream, dataSize);
+    if (!count) {
+        return false;
+    }
+    strings.clear();
+    for (auto i = quint32(0); i < *count && stream.status() == QDataStream::Ok; ++i) {
+        auto string = QString();
+        stream >> string;
+        strings.append(string);
+    }
+    return stream.status() == QDataStream::Ok;
+}
+
+void writeClient(QDataStream &stream, const TraceClient &client)
+{
+    stream << client.id << client.windowId << client.resourceClass << client.resourceName << client.windowRole << client.caption;
+    stream << client.frameGeometry << client.minSize << client.maxSize << client.screen << client.desktop;
+    writeStrings(stream, client.activities);
+    stream << client.flags;
+}
+
+bool readClient(QDataStream &stream, int dataSize, TraceClient &client)
+{
+    stream >> client.id >> client.windowId >> client.resourceClass >> client.resourceName >> client.windowRole >> client.caption;
+    stream >> client.frameGeometry >> client.minSize >> client.maxSize >> client.screen >> client.desktop;
+    if (!readStrings(stream, dataSize, client.activities)) {
+        return false;
+    }
+    stream >> client.flags;
+    return stream.status() == QDataStream::Ok;
+}
+
+bool readEvent(QDataStream &stream, int dataSize, TraceEvent &event)
+{
+    auto type = quint8(0);
+    stream >> type >> event.delay;
+    if (stream.status() != QDataStream::Ok || type > TraceEvent::ShortcutTriggered) {
+        return false;
+    }
+    event.type = static_cast<TraceEvent::Type>(type);
+
+    switch (event.type) {
+    case TraceEvent::ClientAdded:
+        if (!readClient(stream, dataSize, event.state)) {
+            return false;
+        }
+        event.client = event.state.id;
+        break;
+    case TraceEvent::ClientRemoved:
+    case TraceEvent::ClientMinimized:
+    case TraceEvent::ClientUnminimized:
+        stream >> event.client;
+        break;
+    case TraceEvent::ClientMaximizeSet:
+    case TraceEvent::MoveResizedChanged:
+    case TraceEvent::ActiveChanged:
+    case TraceEvent::ScreenChanged:
+    case TraceEvent::DesktopChanged:
+    case TraceEvent::FullScreenChanged:
+    case TraceEvent::ShadeChanged:
+        stream >> event.client >> event.value;
+        break;
+    case TraceEvent::CurrentDesktopChanged:
+        stream >> event.value;
+        break;
+    case TraceEvent::CurrentActivityChanged:
+        stream >> event.text;
+        break;
+    case TraceEvent::FrameGeometryChanged:
+        stream >> event.client >> event.geometry;
+        break;
+    case TraceEvent::ActivitiesChanged:
+        stream >> event.client;
+        if (!readStrings(stream, dataSize, event.activities)) {
+            return false;
+        }
+        break;
+    case TraceEvent::ShortcutTriggered:
+        stream >> event.text >> event.value;
+        break;
+    }
+
+    return stream.status() == QDataStream::Ok;
+}
+}
+
+bool TraceClient::operator==(const TraceClient &rhs) const
+{
+    return id == rhs.id && windowId == rhs.windowId && resourceClass == rhs.resourceClass && resourceName == rhs.resourceName && windowRole == rhs.windowRole
+        && caption == rhs.caption && frameGeometry == rhs.frameGeometry && minSize == rhs.minSize && maxSize == rhs.maxSize && screen == rhs.screen
+        && desktop == rhs.desktop && activities == rhs.activities && flags == rhs.flags;
+}
+
+bool TraceArea::operator==(const TraceArea &rhs) const
+{
+    return screen == rhs.screen && desktop == rhs.desktop && area == rhs.area;
+}
+
+bool TraceWorkspace::operator==(const TraceWorkspace &rhs) const
+{
+    return numScreens == rhs.numScreens && desktops == rhs.desktops && currentDesktop == rhs.currentDesktop && activeScreen == rhs.activeScreen
+        && currentActivity == rhs.currentActivity && activities == rhs.activities && areas == rhs.areas && clients == rhs.clients;
+}
+
+bool TraceEvent::operator==(const TraceEvent &rhs) const
+{
+    return type == rhs.type && delay == rhs.delay && client == rhs.client && value == rhs.value && geometry == rhs.geometry && text == rhs.text
+        && activities == rhs.activities && state == rhs.state;
+}
+
+std::optional<EventTrace> EventTrace::load(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCWarning(Bi) << "Cannot read the event trace" << path << ":" << file.errorString();
+        return std::nullopt;
+    }
+
+    auto trace = deserialize(file.readAll());
+    if (!trace) {
+        qCWarning(Bi) << "Ignoring the incompatible or damaged event trace" << path;
+    }
+    return trace;
+}
+
+QByteArray EventTrace::serialize() const
+{
+    auto result = QByteArray();
+    QDataStream stream(&result, QIODevice::WriteOnly);
+
+    writeHeader(stream, workspace);
+    for (auto &event : events) {
+        writeEvent(stream, event);
+    }
+
+    return result;
+}
+
+std::optional<EventTrace> EventTrace::deserialize(const QByteArray &data)
+{
+    QDataStream stream(data);
+    stream.setVersion(QDataStream::Qt_5_15);
+
+    auto fileMagic = quint32(0);
+    auto fileVersion = quint32(0);
+    stream >> fileMagic >> fileVersion;
+    if (stream.status() != QDataStream::Ok || fileMagic != magic || fileVersion != version) {
+        return std::nullopt;
+    }
+
+    auto trace = EventTrace();
+    auto &workspace = trace.workspace;
+    stream >> workspace.numScreens >> workspace.desktops >> workspace.currentDesktop >> workspace.activeScreen >> workspace.currentActivity;
+
+    auto activityCount = readCount(stream, data.size());
+    if (!activityCount) {
+        return std::nullopt;
+    }
+    for (auto i = quint32(0); i < *activityCount; ++i) {
+        auto activity = std::pair<QString, QString>();
+        stream >> activity.first >> activity.second;
+        workspace.activities.push_back(std::move(activity));
+    }
+
+    auto areaCount = readCount(stream, data.size());
+    if (!areaCount) {
+        return std::nullopt;
+    }
+    workspace.areas.resize(*areaCount);
+    for (auto &area : workspace.areas) {
+        stream >> area.screen >> area.desktop >> area.area;
+    }
+
+    auto clientCount = readCount(stream, data.size());
+    if (!clientCount) {
+        return std::nullopt;
+    }
+    workspace.clients.resize(*clientCount);
+    for (auto &client : workspace.clients) {
+        if (!readClient(stream, data.size(), client)) {
+            return std::nullopt;
+        }
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+        return std::nullopt;
+    }
+
+    // The recording may have been interrupted in the middle of an event,
+    // everything before it is still valid
+    while (!stream.atEnd()) {
+        auto event = TraceEvent();
+        if (!readEvent(stream, data.size(), event)) {
+            qCWarning(Bi) << "The event trace is truncated after" << trace.events.size() << "events";
+            break;
+        }
+        trace.events.push_back(std::move(event));
+    }
+
+    return trace;
+}
+
+void EventTrace::writeHeader(QDataStream &stream, const TraceWorkspace &workspace)
+{
+    stream.setVersion(QDataStream::Qt_5_15);
+
+    stream << magic << version;
+    stream << workspace.numScreens << workspace.desktops << workspace.currentDesktop << workspace.activeScreen << workspace.currentActivity;
+
+    stream << static_cast<quint32>(workspace.activities.size());
+    for (auto &[id, name] : workspace.activities) {
+        stream << id << name;
+    }
+
+    stream << static_cast<quint32>(workspace.areas.size());
+    for (auto &area : workspace.areas) {
+        stream << area.screen << area.desktop << area.area;
+    }
+
+    stream << static_cast<quint32>(workspace.clients.size());
+    for (auto &client : workspace.clients) {
+        writeClient(stream, client);
+    }
+}
+
+void EventTrace::writeEvent(QDataStream &stream, const TraceEvent &event)
+{
+    stream << static_cast<quint8>(event.type) << event.delay;
+
+    switch (event.type) {
+    case TraceEvent::ClientAdded:
+        writeClient(stream, event.state);
+        break;
+    case TraceEvent::ClientRemoved:
+    case TraceEvent::ClientMinimized:
+    case TraceEvent::ClientUnminimized:
+        stream << event.client;
+        break;
+    case TraceEvent::ClientMaximizeSet:
+    case TraceEvent::MoveResizedChanged:
+    case TraceEvent::ActiveChanged:
+    case TraceEvent::ScreenChanged:
+    case TraceEvent::DesktopChanged:
+    case TraceEvent::FullScreenChanged:
+    case TraceEvent::ShadeChanged:
+        stream << event.client << event.value;
+        break;
+    case TraceEvent::CurrentDesktopChanged:
+        stream << event.value;
+        break;
+    case TraceEvent::CurrentActivityChanged:
+        stream << event.text;
+        break;
+    case TraceEvent::FrameGeometryChanged:
+        stream << event.client << event.geometry;
+        break;
+    case TraceEvent::ActivitiesChanged:
+        stream << event.client;
+        writeStrings(stream, event.activities);
+        break;
+    case TraceEvent::ShortcutTriggered:
+        stream << event.text << event.value;
+        break;
+    }
+}
+
+}
@@ -0,0 +1,161 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QRect>
+#include <QSize>
+#include <QString>
+#include <QStringList>
+
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace Bismuth
+{
+
+/**
+ * State of a KWin client, as the script sees it
+ */
+struct TraceClient {
+    enum Flag {
+        Active = 0x1,
+        Dialog = 0x2,
+        Splash = 0x4,
+        Utility = 0x8,
+        Modal = 0x10,
+        Resizeable = 0x20,
+        SpecialWindow = 0x40,
+        Transient = 0x80,
+        FullScreen = 0x100,
+        KeepAbove = 0x200,
+        KeepBelow = 0x400,
+        Minimized = 0x800,
+        NoBorder = 0x1000,
+        Shade = 0x2000,
+        Move = 0x4000,
+        Resize = 0x8000,
+    };
+
+    quint32 id = 0; ///< Number of the client in the trace, not the KWin window id
+    quint32 windowId = 0;
+    QString resourceClass;
+    QString resourceName;
+    QString windowRole;
+    QString caption;
+    QRect frameGeometry;
+    QSize minSize;
+    QSize maxSize;
+    qint32 screen = 0;
+    qint32 desktop = 0; ///< -1 if the client is on all the desktops
+    QStringList activities;
+    quint32 flags = 0; ///< Combination of Flag values
+
+    bool operator==(const TraceClient &) const;
+};
+
+/**
+ * Working area of the screen on the virtual desktop
+ */
+struct TraceArea {
+    qint32 screen = 0;
+    qint32 desktop = 0;
+    QRect area;
+
+    bool operator==(const TraceArea &) const;
+};
+
+/**
+ * State of the workspace, when the recording began
+ */
+struct TraceWorkspace {
+    qint32 numScreens = 1;
+    qint32 desktops = 1;
+    qint32 currentDesktop = 1;
+    qint32 activeScreen = 0;
+    QString currentActivity;
+    std::vector<std::pair<QString, QString>> activities; ///< Names of the activities by their ids
+    std::vector<TraceArea> areas;
+    std::vector<TraceClient> clients; ///< Clients, that existed before the recording
+
+    bool operator==(const TraceWorkspace &) const;
+};
+
+/**
+ * One event of the workspace or of a client, that reached the script
+ */
+struct TraceEvent {
+    /**
+     * Kind of the event. The values are shared with RecordedEvent in the
+     * driver of the script and must not be changed.
+     */
+    enum Type : quint8 {
+        ClientAdded = 0, ///< state is the new client
+        ClientRemoved = 1,
+        ClientMaximizeSet = 2, ///< value is 1 for horizontal, 2 for vertical or 3 for both
+        ClientMinimized = 3,
+        ClientUnminimized = 4,
+        CurrentDesktopChanged = 5, ///< value is the new desktop
+        CurrentActivityChanged = 6, ///< text is the new activity
+        FrameGeometryChanged = 7, ///< geometry is the new frame geometry
+        MoveResizedChanged = 8, ///< value is a combination of TraceClient::Move and TraceClient::Resize
+        ActiveChanged = 9, ///< value is whether the client is active
+        ScreenChanged = 10, ///< value is the new screen
+        ActivitiesChanged = 11, ///< activities are the new activities
+        DesktopChanged = 12, ///< value is the new desktop
+        FullScreenChanged = 13, ///< value is whether the client is fullscreen
+        ShadeChanged = 14, ///< value is whether the client is shaded
+        ShortcutTriggered = 15, ///< text is the action id, value is the number of the coalesced triggers
+    };
+
+    Type type = ClientAdded;
+    quint32 delay = 0; ///< Microseconds since the previous event
+    quint32 client = 0; ///< Client id, if the event belongs to a client
+    qint32 value = 0;
+    QRect geometry;
+    QString text;
+    QStringList activities;
+    TraceClient state;
+
+    bool operator==(const TraceEvent &) const;
+};
+
+/**
+ * Recorded stream of the events, that the script received from KWin.
+ *
+ * The trace is a small binary file: a header with the state of the
+ * workspace, followed by the events. Every event takes only the fields of
+ * its type. The events are appended while recording, so a trace of a
+ * crashed session is readable up to the last complete event.
+ */
+struct EventTrace {
+    static constexpr quint32 magic = 0x42494556; ///< "BIEV"
+    static constexpr quint32 version = 1;
+
+    TraceWorkspace workspace;
+    std::vector<TraceEvent> events;
+
+    /**
+     * Read the trace from the file
+     * @return nothing, if the file does not exist, has another version or its header is damaged
+     */
+    static std::optional<EventTrace> load(const QString &path);
+
+    QByteArray serialize() const;
+    static std::optional<EventTrace> deserialize(const QByteArray &);
+
+    /**
+     * Write the beginning of the trace
+     */
+    static void writeHeader(QDataStream &, const TraceWorkspace &);
+
+    /**
+     * Append the event to the trace
+     */
+    static void writeEvent(QDataStream &, const TraceEvent &);
+};
+
+}
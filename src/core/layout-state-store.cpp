@@ -0,0 +1,149 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include "layout-state-store.hpp"
+
+#include <algorithm>
+
+namespace Bismuth
+{
+
+LayoutStateStore::LayoutStateStore(std::size_t capacity)
+    : m_layoutOrder()
+    , m_entries()
+    , m_index()
+    , m_capacity(std::max<std::size_t>(capacity, 1))
+    , m_evictedCount(0)
+{
+}
+
+void LayoutStateStore::setLayoutOrder(const QStringList &layoutOrder)
+{
+    m_layoutOrder = layoutOrder;
+
+    for (auto &[key, state] : m_entries) {
+        applyLayoutOrder(state);
+    }
+}
+
+QString LayoutStateStore::currentLayout(int layoutKey, const QString &surfaceId)
+{
+    return entry(layoutKey, surfaceId).currentLayout;
+}
+
+QString LayoutStateStore::cycleLayout(int layoutKey, const QString &surfaceId, int step)
+{
+    auto &state = entry(layoutKey, surfaceId);
+    if (m_layoutOrder.isEmpty()) {
+        return state.currentLayout;
+    }
+
+    // A layout, that is not enabled, e.g. the toggled one, cycles from the beginning
+    auto index = m_layoutOrder.indexOf(state.currentLayout);
+    index = index < 0 ? 0 : (index + step % m_layoutOrder.size() + m_layoutOrder.size()) % m_layoutOrder.size();
+
+    state.previousLayout = state.currentLayout;
+    state.currentLayout = m_layoutOrder.at(index);
+    return state.currentLayout;
+}
+
+QString LayoutStateStore::toggleLayout(int layoutKey, const QString &surfaceId, const QString &layoutId)
+{
+    auto &state = entry(layoutKey, surfaceId);
+    if (state.currentLayout == layoutId) {
+        std::swap(state.currentLayout, state.previousLayout);
+    } else {
+        state.previousLayout = state.currentLayout;
+        state.currentLayout = layoutId;
+    }
+    return state.currentLayout;
+}
+
+std::vector<qreal> LayoutStateStore::values(int layoutKey, const QString &surfaceId, const QString &layoutId)
+{
+    const auto &layouts = entry(layoutKey, surfaceId).layouts;
+    auto it = std::find_if(layouts.begin(), layouts.end(), [&layoutId](const LayoutState &layout) {
+        return layout.layoutId == layoutId;
+    });
+    return it != layouts.end() ? it->values : std::vector<qreal>();
+}
+
+void LayoutStateStore::setValues(int layoutKey, const QString &surfaceId, const QString &layoutId, std::vector<qreal> values)
+{
+    auto &layouts = entry(layoutKey, surfaceId).layouts;
+    auto it = std::find_if(layouts.begin(), layouts.end(), [&layoutId](const LayoutState &layout) {
+        return layout.layoutId == layoutId;
+    });
+    if (it != layouts.end()) {
+        it->values = std::move(values);
+    } else {
+        layouts.push_back({layoutId, std::move(values)});
+    }
+}
+
+void LayoutStateStore::restore(int layoutKey, SurfaceState state)
+{
+    auto &stored = entry(layoutKey, state.surfaceId);
+    stored = std::move(state);
+    applyLayoutOrder(stored);
+}
+
+std::vector<SurfaceState> LayoutStateStore::states() const
+{
+    auto result = std::vector<SurfaceState>();
+    result.reserve(m_entries.size());
+    for (auto &[key, state] : m_entries) {
+        result.push_back(state);
+    }
+
+    // The order of use changes all the time, but it must not make the saved state differ
+    std::sort(result.begin(), result.end(), [](const SurfaceState &lhs, const SurfaceState &rhs) {
+        return lhs.surfaceId < rhs.surfaceId;
+    });
+    return result;
+}
+
+std::size_t LayoutStateStore::size() const
+{
+    return m_entries.size();
+}
+
+std::size_t LayoutStateStore::capacity() const
+{
+    return m_capacity;
+}
+
+quint64 LayoutStateStore::evictedCount() const
+{
+    return m_evictedCount;
+}
+
+SurfaceState &LayoutStateStore::entry(int layoutKey, const QString &surfaceId)
+{
+    auto it = m_index.find(layoutKey);
+    if (it != m_index.end()) {
+        m_entries.splice(m_entries.begin(), m_entries, it->second);
+        return it->second->second;
+    }
+
+    if (m_entries.size() >= m_capacity) {
+        m_index.erase(m_entries.back().first);
+        m_entries.pop_back();
+        ++m_evictedCount;
+    }
+
+    const auto layoutId = m_layoutOrder.isEmpty() ? QString() : m_layoutOrder.constFirst();
+    m_entries.push_front({layoutKey, SurfaceState{surfaceId, layoutId, layoutId, {}}});
+    m_index.emplace(layoutKey, m_entries.begin());
+    return m_entries.front().second;
+}
+
+void LayoutStateStore::applyLayoutOrder(SurfaceState &state) const
+{
+    if (!m_layoutOrder.isEmpty() && !m_layoutOrder.contains(state.currentLayout)) {
+        state.currentLayout = m_layoutOrder.constFirst();
+        state.previousLayout = state.currentLayout;
+    }
+}
+
+}
@@ -0,0 +1,107 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <QString>
+#include <QStringList>
+
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "state-snapshot.hpp"
+
+namespace Bismuth
+{
+
+/**
+ * Layouts of the surfaces: the current and the previous layout and the
+ * compact parameters of every layout, that was used on the surface.
+ *
+ * The surfaces are identified by their layout keys, @see SurfaceRegistry.
+ * The store keeps at most capacity surfaces. When it is full, the least
+ * recently used surface is evicted and starts from the default layout,
+ * when it is used again.
+ */
+class LayoutStateStore
+{
+public:
+    static constexpr std::size_t defaultCapacity = 256;
+
+    explicit LayoutStateStore(std::size_t capacity = defaultCapacity);
+
+    /**
+     * Set the enabled layouts in their order. The surfaces, whose current
+     * layout was disabled, are switched to the first enabled one.
+     */
+    void setLayoutOrder(const QStringList &layoutOrder);
+
+    /**
+     * @return id of the current layout of the surface. The surface is added
+     * with the first enabled layout, if it is not in the store.
+     */
+    QString currentLayout(int layoutKey, const QString &surfaceId);
+
+    /**
+     * Switch the surface to the next or the previous enabled layout
+     * @param step 1 or -1
+     * @return id of the new current layout
+     */
+    QString cycleLayout(int layoutKey, const QString &surfaceId, int step);
+
+    /**
+     * Switch the surface to the layout or back to the previous one, if the
+     * layout is already the current one
+     * @return id of the new current layout
+     */
+    QString toggleLayout(int layoutKey, const QString &surfaceId, const QString &layoutId);
+
+    /**
+     * @return parameters of the layout on the surface or an empty list, if
+     * they were never stored
+     */
+    std::vector<qreal> values(int layoutKey, const QString &surfaceId, const QString &layoutId);
+
+    /**
+     * Replace the parameters of the layout on the surface
+     */
+    void setValues(int layoutKey, const QString &surfaceId, const QString &layoutId, std::vector<qreal> values);
+
+    /**
+     * Put the saved state of the surface into the store. The layouts, that
+     * were disabled since the state was saved, are replaced.
+     */
+    void restore(int layoutKey, SurfaceState state);
+
+    /**
+     * @return states of all the surfaces in the store, ordered by the surface id
+     */
+    std::vector<SurfaceState> states() const;
+
+    std::size_t size() const;
+    std::size_t capacity() const;
+
+    /**
+     * @return number of the surfaces, that were evicted to stay in the capacity
+     */
+    quint64 evictedCount() const;
+
+private:
+    using List = std::list<std::pair<int, SurfaceState>>;
+
+    /**
+     * Find or add the surface and mark it as the most recently used one
+     */
+    SurfaceState &entry(int layoutKey, const QString &surfaceId);
+    void applyLayoutOrder(SurfaceState &) const;
+
+    QStringList m_layoutOrder;
+    List m_entries; ///< The most recently used surface first
+    std::unordered_map<int, List::iterator> m_index; ///< Position of every surface in m_entries
+    std::size_t m_capacity;
+    quint64 m_evictedCount;
+};
+
+}
@@ -0,0 +1,29 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include "metrics-service.hpp"
+
+#include <QJsonDocument>
+
+#include "ts-proxy.hpp"
+
+namespace Bismuth
+{
+
+MetricsService::MetricsService(TSProxy &proxy, QObject *parent)
+    : QObject(parent)
+    , m_proxy(proxy)
+{
+}
+
+QString MetricsService::stats()
+{
+    return QString::fromUtf8(QJsonDocument(m_proxy.metrics()).toJson(QJsonDocument::Compact));
+}
+
+void MetricsService::reset()
+{
+    m_proxy.resetMetrics();
+}
+
+}
@@ -0,0 +1,36 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <QObject>
+#include <QString>
+
+namespace Bismuth
+{
+
+class TSProxy;
+
+/**
+ * The metrics of the proxy, exported on D-Bus at /Metrics.
+ * @see org.kde.bismuth.Metrics.xml
+ */
+class MetricsService : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MetricsService(TSProxy &, QObject *parent = nullptr);
+
+    /**
+     * @return the metrics as a compact JSON object, @see TSProxy::metrics
+     */
+    QString stats();
+
+    void reset();
+
+private:
+    TSProxy &m_proxy;
+};
+
+}
@@ -0,0 +1,201 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include "metrics.hpp"
+
+#include <QJsonArray>
+
+#include <algorithm>
+#include <cmath>
+
+namespace Bismuth
+{
+
+namespace
+{
+int bucketIndex(qint64 microseconds)
+{
+    auto index = 0;
+    while (microseconds > 0 && index < LatencyHistogram::BucketCount - 1) {
+        microseconds >>= 1;
+        ++index;
+    }
+    return index;
+}
+}
+
+void LatencyHistogram::record(qint64 nanoseconds)
+{
+    nanoseconds = std::max<qint64>(nanoseconds, 0);
+
+    ++m_buckets[bucketIndex(nanoseconds / 1000)];
+    ++m_count;
+    m_total += nanoseconds;
+    m_max = std::max(m_max, nanoseconds);
+}
+
+quint64 LatencyHistogram::count() const
+{
+    return m_count;
+}
+
+qint64 LatencyHistogram::totalNanoseconds() const
+{
+    return m_total;
+}
+
+qint64 LatencyHistogram::maxNanoseconds() const
+{
+    return m_max;
+}
+
+quint64 LatencyHistogram::bucket(int index) const
+{
+    return m_buckets[index];
+}
+
+qint64 LatencyHistogram::bucketBound(int index)
+{
+    return qint64(1) << index;
+}
+
+qint64 LatencyHistogram::percentile(double fraction) const
+{
+    if (m_count == 0) {
+        return 0;
+    }
+
+    const auto rank = std::max<quint64>(1, static_cast<quint64>(std::ceil(fraction * m_count)));
+    auto seen = quint64(0);
+    auto index = 0;
+    for (; index < BucketCount - 1; ++index) {
+        seen += m_buckets[index];
+        if (seen >= rank) {
+            break;
+        }
+    }
+
+    // The bound is the upper estimate, the maximum is exact
+    return std::min(bucketBound(index), (m_max + 999) / 1000);
+}
+
+QJsonObject LatencyHistogram::toJson() const
+{
+    auto buckets = QJsonArray();
+    for (auto i = 0; i < BucketCount; ++i) {
+        if (m_buckets[i] == 0) {
+            continue;
+        }
+
+        auto bucket = QJsonObject{{QStringLiteral("count"), static_cast<qint64>(m_buckets[i])}};
+        if (i < BucketCount - 1) {
+            bucket.insert(QStringLiteral("belowUs"), bucketBound(i));
+        }
+        buckets.append(bucket);
+    }
+
+    return QJsonObject{
+        {QStringLiteral("count"), static_cast<qint64>(m_count)},
+        {QStringLiteral("totalUs"), m_total / 1000},
+        {QStringLiteral("meanUs"), m_count > 0 ? m_total / 1000.0 / m_count : 0.0},
+        {QStringLiteral("maxUs"), m_max / 1000},
+        {QStringLiteral("p50Us"), percentile(0.5)},
+        {QStringLiteral("p90Us"), percentile(0.9)},
+        {QStringLiteral("p99Us"), percentile(0.99)},
+        {QStringLiteral("buckets"), buckets},
+    };
+}
+
+void Metrics::countCall(BridgeCall call)
+{
+    ++m_calls[call];
+}
+
+quint64 Metrics::calls(BridgeCall call) const
+{
+    return m_calls[call];
+}
+
+QString Metrics::callName(BridgeCall call)
+{
+    switch (call) {
+    case ConfigCall:
+        return QStringLiteral("config");
+    case ShortcutCall:
+        return QStringLiteral("shortcut");
+    case LogCall:
+        return QStringLiteral("log");
+    case LayoutCall:
+        return QStringLiteral("layout");
+    case RulesCall:
+        return QStringLiteral("rules");
+    case SurfaceCall:
+        return QStringLiteral("surface");
+    case ScheduleCall:
+        return QStringLiteral("schedule");
+    case CommitCall:
+        return QStringLiteral("commit");
+    case WindowCall:
+        return QStringLiteral("window");
+    case DragCall:
+        return QStringLiteral("drag");
+    case TraceCall:
+        return QStringLiteral("trace");
+    case StateCall:
+        return QStringLiteral("state");
+    case RecordCall:
+        return QStringLiteral("record");
+    case BridgeCallCount:
+        break;
+    }
+    return {};
+}
+
+void Metrics::recordArrange(const QString &layoutId, qint64 nanoseconds)
+{
+    m_arrangeLatency[layoutId].record(nanoseconds);
+}
+
+const LatencyHistogram *Metrics::arrangeLatency(const QString &layoutId) const
+{
+    auto it = m_arrangeLatency.find(layoutId);
+    return it != m_arrangeLatency.end() ? &it->second : nullptr;
+}
+
+void Metrics::recordShortcut(qint64 nanoseconds)
+{
+    m_shortcutLatency.record(nanoseconds);
+}
+
+const LatencyHistogram &Metrics::shortcutLatency() const
+{
+    return m_shortcutLatency;
+}
+
+void Metrics::reset()
+{
+    m_calls.fill(0);
+    m_arrangeLatency.clear();
+    m_shortcutLatency = LatencyHistogram();
+}
+
+QJsonObject Metrics::toJson() const
+{
+    auto arrangements = QJsonObject();
+    for (auto &[layoutId, histogram] : m_arrangeLatency) {
+        arrangements.insert(layoutId, histogram.toJson());
+    }
+
+    auto calls = QJsonObject();
+    for (auto i = 0; i < BridgeCallCount; ++i) {
+        calls.insert(callName(static_cast<BridgeCall>(i)), static_cast<qint64>(m_calls[i]));
+    }
+
+    return QJsonObject{
+        {QStringLiteral("arrangements"), arrangements},
+        {QStringLiteral("shortcuts"), m_shortcutLatency.toJson()},
+        {QStringLiteral("bridgeCalls"), calls},
+    };
+}
+
+}
@@ -0,0 +1,124 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <QJsonObject>
+#include <QString>
+#include <QtGlobal>
+
+#include <array>
+#include <map>
+
+namespace Bismuth
+{
+
+/**
+ * Distribution of the durations in power-of-two buckets of microseconds.
+ * The bucket 0 holds the durations below 1 µs, the bucket i the ones below
+ * 2^i µs and the last one everything longer.
+ */
+class LatencyHistogram
+{
+public:
+    static constexpr int BucketCount = 24;
+
+    void record(qint64 nanoseconds);
+
+    quint64 count() const;
+    qint64 totalNanoseconds() const;
+    qint64 maxNanoseconds() const;
+    quint64 bucket(int index) const;
+
+    /**
+     * @return upper bound of the bucket in microseconds
+     */
+    static qint64 bucketBound(int index);
+
+    /**
+     * Estimate the percentile of the recorded durations
+     * @param fraction e.g. 0.99
+     * @return upper bound of the bucket, that contains the percentile, in
+     * microseconds, but no more than the maximal duration
+     */
+    qint64 percentile(double fraction) const;
+
+    /**
+     * @return count, total, mean, max, p50, p90 and p99 in microseconds and
+     * the non-empty buckets
+     */
+    QJsonObject toJson() const;
+
+private:
+    std::array<quint64, BucketCount> m_buckets{};
+    quint64 m_count = 0;
+    qint64 m_total = 0;
+    qint64 m_max = 0;
+};
+
+/**
+ * Counters of the tiling pipeline, that are published on D-Bus.
+ *
+ * Everything is counted on the GUI thread, so the counters are plain numbers.
+ */
+class Metrics
+{
+public:
+    /**
+     * Groups of the calls from the script to the native code
+     */
+    enum BridgeCall {
+        ConfigCall,
+        ShortcutCall,
+        LogCall,
+        LayoutCall, ///< applyLayout and applyLayouts
+        RulesCall,
+        SurfaceCall,
+        ScheduleCall,
+        CommitCall,
+        WindowCall, ///< Changes and queries of the window registry
+        DragCall,
+        TraceCall,
+        StateCall, ///< Layout state store
+        RecordCall,
+        BridgeCallCount,
+    };
+
+    void countCall(BridgeCall);
+    quint64 calls(BridgeCall) const;
+    static QString callName(BridgeCall);
+
+    /**
+     * Count the arrangement of a surface and its duration
+     */
+    void recordArrange(const QString &layoutId, qint64 nanoseconds);
+
+    /**
+     * @return histogram of the arrangements with the layout or nullptr, if there were none
+     */
+    const LatencyHistogram *arrangeLatency(const QString &layoutId) const;
+
+    /**
+     * Count the duration of a shortcut action, from the trigger till the return of the script
+     */
+    void recordShortcut(qint64 nanoseconds);
+    const LatencyHistogram &shortcutLatency() const;
+
+    /**
+     * Start counting from zero
+     */
+    void reset();
+
+    /**
+     * @return object with the arrangements by layout id, the shortcuts and
+     * the bridge calls by group name
+     */
+    QJsonObject toJson() const;
+
+private:
+    std::array<quint64, BridgeCallCount> m_calls{};
+    std::map<QString, LatencyHistogram> m_arrangeLatency; ///< By layout id, sorted for the output
+    LatencyHistogram m_shortcutLatency;
+};
+
+}
@@ -3,18 +3,29 @@
 
 #include "qml-plugin.hpp"
 
+#include <KConfigGroup>
 #include <KSharedConfig>
 
+#include <QDBusConnection>
+#include <QDateTime>
+#include <QFile>
 #include <QJSValue>
 #include <QString>
 #include <QtQml>
 
+#include <KLocalizedString>
+
+#include <chrono>
 #include <memory>
 
 #include "config.hpp"
 #include "controller.hpp"
+#include "core_adaptor.h"
+#include "engine/engine.hpp"
 #include "kconf_update/legacy_shortcuts.hpp"
 #include "logger.hpp"
+#include "metrics_adaptor.h"
+#include "runtime-directory.hpp"
 #include "ts-proxy.hpp"
 
 void CorePlugin::registerTypes(const char *uri)
@@ -32,19 +43,100 @@ Core::Core(QQuickItem *parent)
     : QQuickItem(parent)
     , m_qmlEngine() // We cannot get engine from the pointer in the constructor
     , m_controller()
+    , m_engine()
+    , m_arrangeScheduler()
+    , m_tracer()
     , m_tsProxy()
+    , m_metricsService()
     , m_config()
+    , m_configSnapshot()
+    , m_configWatcher()
+    , m_stateSaveTimer()
+    , m_savedState()
+    , m_stateHandedOver(false)
 {
     // Do the necessary migrations, that are not possible from kconf_update
     Bismuth::KConfUpdate::migrate();
 }
 
+Core::~Core()
+{
+    // The script cannot be asked anymore, so its last stored state is saved,
+    // unless the next instance has already taken it, see init
+    if (m_tsProxy && !m_stateHandedOver) {
+        saveState();
+    }
+
+    // The next instance of the script may have already taken the objects over, see init
+    auto bus = QDBusConnection::sessionBus();
+    if (m_metricsService && bus.objectRegisteredAt(QStringLiteral("/Metrics")) == m_metricsService.get()) {
+        bus.unregisterObject(QStringLiteral("/Metrics"));
+    }
+    if (bus.objectRegisteredAt(QStringLiteral("/Core")) == this) {
+        bus.unregisterObject(QStringLiteral("/Core"));
+        bus.unregisterService(QStringLiteral("org.kde.bismuth"));
+    }
+}
+
 void Core::init()
 {
     m_config = std::make_unique<Bismuth::Config>();
+    m_configSnapshot = ConfigSnapshot::fromConfig(*m_config, 1);
     m_qmlEngine = qmlEngine(this);
     m_controller = std::make_unique<Bismuth::Controller>(*m_config);
-    m_tsProxy = std::make_unique<TSProxy>(m_qmlEngine, *m_controller, *m_config);
+    m_engine = std::make_unique<Bismuth::Engine>(m_configSnapshot);
+    m_arrangeScheduler = std::make_unique<Bismuth::ArrangeScheduler>();
+    m_tracer = std::make_unique<Bismuth::Tracer>();
+    m_tsProxy = std::make_unique<TSProxy>(m_qmlEngine, *m_controller, *m_engine, *m_arrangeScheduler, *m_tracer, m_configSnapshot);
+
+    // When the script is reloaded, the previous instance is destroyed only
+    // after this one is initialized. It saves its current state first, so
+    // that nothing changed since its last periodic save is lost.
+    auto bus = QDBusConnection::sessionBus();
+    if (auto previous = qobject_cast<Core *>(bus.objectRegisteredAt(QStringLiteral("/Core"))); previous && previous != this) {
+        previous->handOverState();
+    }
+
+    // The script restores the state, before it arranges anything
+    auto restoredState = StateSnapshot::load(StateSnapshot::defaultPath());
+    if (restoredState) {
+        m_savedState = *restoredState;
+    }
+    m_tsProxy->setRestoredState(std::move(restoredState));
+
+    m_stateSaveTimer.setInterval(std::chrono::seconds(10));
+    connect(&m_stateSaveTimer, &QTimer::timeout, this, &Core::flushState);
+    m_stateSaveTimer.start();
+
+    // No default shortcut, it is only needed, when investigating a problem
+    m_controller->registerAction({QStringLiteral("bismuth_dump_trace"), i18n("Dump Tiling Trace"), QString(), [this](int) {
+                                      dumpTrace();
+                                  }});
+
+    // The objects of the previous instance are taken over. Then it sees,
+    // that the paths are not its own, and leaves them and the service.
+    bus.unregisterObject(QStringLiteral("/Core"));
+    bus.unregisterObject(QStringLiteral("/Metrics"));
+
+    // The KCM pushes the saved config here, so that the tiling state survives the change
+    new CoreAdaptor(this);
+    if (!bus.registerObject(QStringLiteral("/Core"), this, QDBusConnection::ExportAdaptors) || !bus.registerService(QStringLiteral("org.kde.bismuth"))) {
+        qCWarning(Bi) << "Cannot register the D-Bus interface:" << bus.lastError().message();
+    }
+
+    m_metricsService = std::make_unique<MetricsService>(*m_tsProxy);
+    new MetricsAdaptor(m_metricsService.get());
+    if (!bus.registerObject(QStringLiteral("/Metrics"), m_metricsService.get(), QDBusConnection::ExportAdaptors)) {
+        qCWarning(Bi) << "Cannot register the metrics on D-Bus:" << bus.lastError().message();
+    }
+
+    // The snapshot is invalidated only, when someone actually changes the config
+    m_configWatcher = KConfigWatcher::create(m_config->sharedConfig());
+    connect(m_configWatcher.data(), &KConfigWatcher::configChanged, this, [this](const KConfigGroup &group) {
+        if (group.name() == QStringLiteral("Script-bismuth")) {
+            reloadConfig();
+        }
+    });
 }
 
 TSProxy *Core::tsProxy() const
@@ -52,4 +144,104 @@ TSProxy *Core::tsProxy() const
     return m_tsProxy.get();
 }
 
+std::shared_ptr<const ConfigSnapshot> Core::config() const
+{
+    return m_configSnapshot;
+}
+
+QString Core::dumpTrace() const
+{
+    const auto fileName = QStringLiteral("bismuth-trace-%1.json").arg(QDateTime::currentDateTime().toString(QStringLiteral("yyyyMMdd-hhmmss")));
+    QFile file(runtimeFilePath(fileName));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCWarning(Bi) << "Cannot write the trace to" << file.fileName() << ":" << file.errorString();
+        return {};
+    }
+
+    file.write(m_tracer->toChromeJson());
+    qCInfo(Bi) << "Trace is written to" << file.fileName();
+    return file.fileName();
+}
+
+QString Core::startRecording()
+{
+    // Not initialized yet, there is nothing to record
+    if (!m_tsProxy) {
+        return {};
+    }
+
+    const auto fileName = QStringLiteral("bismuth-events-%1.bitrace").arg(QDateTime::currentDateTime().toString(QStringLiteral("yyyyMMdd-hhmmss")));
+    const auto path = runtimeFilePath(fileName);
+
+    m_tsProxy->stopRecording();
+    if (!m_tsProxy->startRecording(path)) {
+        return {};
+    }
+
+    qCInfo(Bi) << "Recording the events to" << path;
+    return path;
+}
+
+QString Core::stopRecording()
+{
+    if (!m_tsProxy) {
+        return {};
+    }
+
+    return m_tsProxy->stopRecording();
+}
+
+void Core::flushState()
+{
+    if (!m_tsProxy) {
+        return;
+    }
+
+    m_tsProxy->requestLayoutState();
+    saveState();
+}
+
+void Core::handOverState()
+{
+    m_stateSaveTimer.stop();
+    flushState();
+    m_stateHandedOver = true;
+}
+
+void Core::saveState()
+{
+    auto state = m_tsProxy->stateSnapshot();
+    if (state == m_savedState) {
+        return;
+    }
+
+    if (state.save(StateSnapshot::defaultPath())) {
+        m_savedState = std::move(state);
+    }
+}
+
+void Core::reloadConfig()
+{
+    // Not initialized yet, the config will be read by init
+    if (!m_config) {
+        return;
+    }
+
+    m_config->load();
+    auto snapshot = ConfigSnapshot::fromConfig(*m_config, m_configSnapshot->generation + 1);
+
+    // Both the KCM and the config watcher report the same save
+    const auto changes = snapshot->changesFrom(*m_configSnapshot);
+    if (changes == ConfigSnapshot::NoChanges) {
+        qCDebug(Bi) << "Configuration reloaded without changes";
+        return;
+    }
+
+    m_configSnapshot = std::move(snapshot);
+    qCDebug(Bi) << "Configuration changed. Generation:" << m_configSnapshot->generation << "Changes:" << changes;
+
+    m_engine->setConfig(m_configSnapshot);
+    m_tsProxy->setConfig(m_configSnapshot, changes);
+}
+
 }
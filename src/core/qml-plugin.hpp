@@ -8,11 +8,20 @@
 #include <QQmlEngine>
 #include <QQmlExtensionPlugin>
 #include <QQuickItem>
+#include <QTimer>
+
+#include <KConfigWatcher>
 
 #include <memory>
 
+#include "arrange-scheduler.hpp"
+#include "config-snapshot.hpp"
 #include "config.hpp"
 #include "controller.hpp"
+#include "engine/engine.hpp"
+#include "metrics-service.hpp"
+#include "state-snapshot.hpp"
+#include "tracer.hpp"
 #include "ts-proxy.hpp"
 
 class CorePlugin : public QQmlExtensionPlugin
@@ -36,6 +45,7 @@ class Core : public QQuickItem
 
 public:
     Core(QQuickItem *parent = nullptr);
+    ~Core() override;
 
     /**
      * Initializes the Core. Acts like a constructor, but bypasses the
@@ -45,12 +55,68 @@ public:
 
     TSProxy *tsProxy() const;
 
+    /**
+     * @return parsed configuration, that is valid until the next config change
+     */
+    std::shared_ptr<const ConfigSnapshot> config() const;
+
+    /**
+     * Write the recorded trace spans to a file in the runtime directory
+     * @return path of the written file or an empty string on failure
+     */
+    Q_INVOKABLE QString dumpTrace() const;
+
+    /**
+     * Re-read the configuration and pass the changed settings to their users.
+     * Called by the KCM over D-Bus and when the config file changes.
+     * Does nothing, if no setting has changed.
+     */
+    void reloadConfig();
+
+    /**
+     * Record the events of the workspace into a new trace file in the
+     * runtime directory. The previous recording is stopped.
+     * @return path of the trace or an empty string on failure
+     * @see EventTrace
+     */
+    QString startRecording();
+
+    /**
+     * @return path of the written trace or an empty string, if nothing was recorded
+     */
+    QString stopRecording();
+
 private:
+    /**
+     * Ask the script for its current tiling state and save it
+     */
+    void flushState();
+
+    /**
+     * Save the current tiling state for the instance of the script, that
+     * replaces this one. Nothing is saved after that.
+     */
+    void handOverState();
+
+    /**
+     * Write the tiling state to the snapshot file, if it has changed since the last save
+     */
+    void saveState();
+
     QQmlEngine *m_qmlEngine; ///< Pointer to the engine, that is currently using the Core element
 
     std::unique_ptr<Bismuth::Controller> m_controller; ///< Legacy TS Backend proxy
+    std::unique_ptr<Bismuth::Engine> m_engine; ///< Native tiling engine
+    std::unique_ptr<Bismuth::ArrangeScheduler> m_arrangeScheduler;
+    std::unique_ptr<Bismuth::Tracer> m_tracer; ///< Spans of the tiling pipeline
     std::unique_ptr<TSProxy> m_tsProxy; ///< Legacy TS Backend proxy
+    std::unique_ptr<MetricsService> m_metricsService; ///< Metrics of m_tsProxy on D-Bus
     std::unique_ptr<Bismuth::Config> m_config;
+    std::shared_ptr<const ConfigSnapshot> m_configSnapshot; ///< Parsed m_config, replaced on every change
+    KConfigWatcher::Ptr m_configWatcher;
+    QTimer m_stateSaveTimer; ///< Saves the state periodically, so that it survives a crash
+    StateSnapshot m_savedState; ///< Last state, written to the snapshot file
+    bool m_stateHandedOver; ///< Whether the next instance has taken the state, see handOverState
 };
 
 }
@@ -0,0 +1,21 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include "runtime-directory.hpp"
+
+#include <QDir>
+#include <QStandardPaths>
+
+namespace Bismuth
+{
+
+QString runtimeFilePath(const QString &fileName)
+{
+    auto directory = QStandardPaths::writableLocation(QStandardPaths::RuntimeLocation);
+    if (directory.isEmpty()) {
+        directory = QDir::tempPath();
+    }
+    return QDir(directory).filePath(fileName);
+}
+
+}
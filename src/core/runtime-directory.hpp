@@ -0,0 +1,17 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <QString>
+
+namespace Bismuth
+{
+
+/**
+ * @return path of the file in the runtime directory of the user, or in the
+ * temporary directory, if there is no runtime directory
+ */
+QString runtimeFilePath(const QString &fileName);
+
+}
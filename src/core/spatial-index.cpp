@@ -0,0 +1,113 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include "spatial-index.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+namespace Bismuth
+{
+
+namespace
+{
+/**
+ * Allowed misalignment of the tiles, that are considered equally close
+ */
+constexpr int closenessTolerance = 5;
+}
+
+SpatialIndex::SpatialIndex(std::vector<QRect> geometries)
+    : m_geometries(std::move(geometries))
+{
+    for (auto direction : {Direction::Up, Direction::Down, Direction::Left, Direction::Right}) {
+        auto &sorted = m_byEdge[static_cast<int>(direction)];
+        sorted.resize(m_geometries.size());
+        std::iota(sorted.begin(), sorted.end(), 0);
+
+        // Stable, so that the tiles with the same edge keep their order
+        std::stable_sort(sorted.begin(), sorted.end(), [this, direction](int lhs, int rhs) {
+            return edges(m_geometries[lhs], direction).end < edges(m_geometries[rhs], direction).end;
+        });
+
+        auto &reach = m_reach[static_cast<int>(direction)];
+        for (const auto &geometry : m_geometries) {
+            const auto tileEdges = edges(geometry, direction);
+            reach = std::max(reach, tileEdges.start - tileEdges.end);
+        }
+    }
+}
+
+int SpatialIndex::neighbor(const QRect &basis, Direction direction, const std::function<quint64(int)> &priority) const
+{
+    const auto basisStart = edges(basis, direction).start;
+
+    auto result = -1;
+    auto resultPriority = quint64(0);
+    auto closest = 0;
+
+    // The start of a candidate is after the start of the basis, so its end
+    // cannot be before that minus the largest tile extent. Everything
+    // before that is behind the basis and is skipped by the binary search.
+    const auto &sorted = m_byEdge[static_cast<int>(direction)];
+    const auto minEnd = basisStart - m_reach[static_cast<int>(direction)];
+    auto first = std::upper_bound(sorted.begin(), sorted.end(), minEnd, [this, direction](int edge, int tile) {
+        return edge < edges(m_geometries[tile], direction).end;
+    });
+
+    // The tiles are visited from the closest one, so the first candidate
+    // defines the distance and the scan stops right after the tolerance
+    for (auto it = first; it != sorted.end(); ++it) {
+        const auto tile = *it;
+        const auto &geometry = m_geometries[tile];
+        const auto tileEdges = edges(geometry, direction);
+
+        if (result >= 0 && tileEdges.end >= closest + closenessTolerance) {
+            break;
+        }
+
+        if (tileEdges.start <= basisStart || !overlaps(basis, geometry, direction)) {
+            continue;
+        }
+
+        if (result < 0) {
+            closest = tileEdges.end;
+            result = tile;
+            resultPriority = priority(tile);
+        } else {
+            const auto tilePriority = priority(tile);
+            if (tilePriority > resultPriority || (tilePriority == resultPriority && tile < result)) {
+                result = tile;
+                resultPriority = tilePriority;
+            }
+        }
+    }
+
+    return result;
+}
+
+SpatialIndex::Edges SpatialIndex::edges(const QRect &rect, Direction direction)
+{
+    // Equivalent of the exclusive right/bottom edge: x + width
+    switch (direction) {
+    case Direction::Up:
+        return {-rect.y(), -(rect.y() + rect.height())};
+    case Direction::Down:
+        return {rect.y(), rect.y()};
+    case Direction::Left:
+        return {-rect.x(), -(rect.x() + rect.width())};
+    case Direction::Right:
+        return {rect.x(), rect.x()};
+    }
+    return {0, 0};
+}
+
+bool SpatialIndex::overlaps(const QRect &lhs, const QRect &rhs, Direction direction)
+{
+    if (direction == Direction::Up || direction == Direction::Down) {
+        return std::min(lhs.x() + lhs.width(), rhs.x() + rhs.width()) - std::max(lhs.x(), rhs.x()) > 0;
+    }
+    return std::min(lhs.y() + lhs.height(), rhs.y() + rhs.height()) - std::max(lhs.y(), rhs.y()) > 0;
+}
+
+}
@@ -0,0 +1,73 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <QRect>
+
+#include <functional>
+#include <vector>
+
+namespace Bismuth
+{
+
+/**
+ * Index of the tile geometries on one surface for the directional lookups.
+ *
+ * The tiles are sorted by every edge, so that the nearest tiles in the
+ * given direction are found by a binary search, that skips the tiles behind
+ * the area, and a short scan, that stops after the closest tiles, instead
+ * of filtering and sorting all the tiles on every query.
+ */
+class SpatialIndex
+{
+public:
+    enum class Direction {
+        Up,
+        Down,
+        Left,
+        Right,
+    };
+
+    /**
+     * Build the index
+     * @param geometries geometries of the tiles. The tile number is its index in this array.
+     */
+    explicit SpatialIndex(std::vector<QRect> geometries = {});
+
+    /**
+     * Find the neighbor of the area in the given direction.
+     *
+     * The neighbor is one of the tiles, that overlap with @p basis in the
+     * perpendicular direction and are the closest to it (with a small
+     * tolerance for misaligned tiles).
+     *
+     * @param basis geometry to find the neighbor of
+     * @param direction direction to look in
+     * @param priority picks among the equally close tiles: the tile with the
+     * highest priority wins, and the one with the lowest number on ties
+     * @return the tile number or -1 if there is no neighbor
+     */
+    int neighbor(const QRect &basis, Direction direction, const std::function<quint64(int)> &priority) const;
+
+private:
+    /**
+     * Tile edges in the direction of the search, i.e. the edge, by which the
+     * tiles are considered as candidates, and the edge, by which their
+     * distance is measured. Both are negated for Up and Left, so that the
+     * search always goes towards greater values.
+     */
+    struct Edges {
+        int start;
+        int end;
+    };
+
+    static Edges edges(const QRect &, Direction);
+    static bool overlaps(const QRect &, const QRect &, Direction);
+
+    std::vector<QRect> m_geometries;
+    std::vector<int> m_byEdge[4]; ///< Tile numbers, sorted by the near edge for every direction
+    int m_reach[4] = {}; ///< The largest distance between the edges of a tile for every direction
+};
+
+}
@@ -0,0 +1,177 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include "state-snapshot.hpp"
+
+#include <QDataStream>
+#include <QFile>
+#include <QSaveFile>
+
+#include "logger.hpp"
+#include "runtime-directory.hpp"
+
+namespace Bismuth
+{
+
+namespace
+{
+/**
+ * Read the number of the following elements. Every element takes at least
+ * four bytes, so a greater number means, that the data is damaged.
+ */
+std::optional<quint32> readCount(QDataStream &stream, int dataSize)
+{
+    auto count = quint32(0);
+    stream >> count;
+    if (stream.status() != QDataStream::Ok || count > static_cast<quint32>(dataSize / 4)) {
+        return std::nullopt;
+    }
+    return count;
+}
+}
+
+bool LayoutState::operator==(const LayoutState &rhs) const
+{
+    return layoutId == rhs.layoutId && values == rhs.values;
+}
+
+bool SurfaceState::operator==(const SurfaceState &rhs) const
+{
+    return surfaceId == rhs.surfaceId && currentLayout == rhs.currentLayout && previousLayout == rhs.previousLayout && layouts == rhs.layouts;
+}
+
+bool StateSnapshot::operator==(const StateSnapshot &rhs) const
+{
+    return surfaces == rhs.surfaces && windowOrder == rhs.windowOrder;
+}
+
+QString StateSnapshot::defaultPath()
+{
+    return runtimeFilePath(QStringLiteral("bismuth-state"));
+}
+
+std::optional<StateSnapshot> StateSnapshot::load(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return std::nullopt;
+    }
+
+    auto size = file.size();
+    auto data = file.map(0, size);
+    if (!data) {
+        qCWarning(Bi) << "Cannot map the state snapshot" << path << ":" << file.errorString();
+        return std::nullopt;
+    }
+
+    // The strings are copied out of the mapped memory while parsing
+    auto snapshot = deserialize(QByteArray::fromRawData(reinterpret_cast<const char *>(data), static_cast<int>(size)));
+    file.unmap(data);
+
+    if (!snapshot) {
+        qCWarning(Bi) << "Ignoring the incompatible or damaged state snapshot" << path;
+    }
+    return snapshot;
+}
+
+bool StateSnapshot::save(const QString &path) const
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(Bi) << "Cannot write the state snapshot to" << path << ":" << file.errorString();
+        return false;
+    }
+
+    file.write(serialize());
+    return file.commit();
+}
+
+QByteArray StateSnapshot::serialize() const
+{
+    auto result = QByteArray();
+    QDataStream stream(&result, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_15);
+
+    stream << magic << version;
+
+    stream << static_cast<quint32>(surfaces.size());
+    for (auto &surface : surfaces) {
+        stream << surface.surfaceId << surface.currentLayout << surface.previousLayout;
+        stream << static_cast<quint32>(surface.layouts.size());
+        for (auto &layout : surface.layouts) {
+            stream << layout.layoutId << static_cast<quint32>(layout.values.size());
+            for (auto value : layout.values) {
+                stream << value;
+            }
+        }
+    }
+
+    stream << static_cast<quint32>(windowOrder.size());
+    for (auto &windowId : windowOrder) {
+        stream << windowId;
+    }
+
+    return result;
+}
+
+std::optional<StateSnapshot> StateSnapshot::deserialize(const QByteArray &data)
+{
+    QDataStream stream(data);
+    stream.setVersion(QDataStream::Qt_5_15);
+
+    auto fileMagic = quint32(0);
+    auto fileVersion = quint32(0);
+    stream >> fileMagic >> fileVersion;
+    if (stream.status() != QDataStream::Ok || fileMagic != magic || fileVersion != version) {
+        return std::nullopt;
+    }
+
+    auto snapshot = StateSnapshot();
+
+    auto surfaceCount = readCount(stream, data.size());
+    if (!surfaceCount) {
+        return std::nullopt;
+    }
+    for (auto i = quint32(0); i < *surfaceCount; ++i) {
+        auto surface = SurfaceState();
+        stream >> surface.surfaceId >> surface.currentLayout >> surface.previousLayout;
+
+        auto layoutCount = readCount(stream, data.size());
+        if (!layoutCount) {
+            return std::nullopt;
+        }
+        for (auto j = quint32(0); j < *layoutCount; ++j) {
+            auto layout = LayoutState();
+            stream >> layout.layoutId;
+
+            auto valueCount = readCount(stream, data.size());
+            if (!valueCount) {
+                return std::nullopt;
+            }
+            layout.values.resize(*valueCount);
+            for (auto &value : layout.values) {
+                stream >> value;
+            }
+            surface.layouts.push_back(std::move(layout));
+        }
+        snapshot.surfaces.push_back(std::move(surface));
+    }
+
+    auto windowCount = readCount(stream, data.size());
+    if (!windowCount) {
+        return std::nullopt;
+    }
+    snapshot.windowOrder.resize(*windowCount);
+    for (auto &windowId : snapshot.windowOrder) {
+        stream >> windowId;
+    }
+
+    // Truncated data is detected only after the reads
+    if (stream.status() != QDataStream::Ok) {
+        return std::nullopt;
+    }
+
+    return snapshot;
+}
+
+}
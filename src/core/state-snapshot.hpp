@@ -0,0 +1,76 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+
+#include <optional>
+#include <vector>
+
+namespace Bismuth
+{
+
+/**
+ * Saved state of one layout. The meaning of the values is up to the layout,
+ * e.g. the number of the master windows and the master ratio.
+ */
+struct LayoutState {
+    QString layoutId;
+    std::vector<qreal> values;
+
+    bool operator==(const LayoutState &) const;
+};
+
+/**
+ * Saved layouts of one surface
+ */
+struct SurfaceState {
+    QString surfaceId;
+    QString currentLayout;
+    QString previousLayout;
+    std::vector<LayoutState> layouts; ///< Only the layouts, that were used on the surface
+
+    bool operator==(const SurfaceState &) const;
+};
+
+/**
+ * Tiling state, that survives the reloads of the script.
+ *
+ * The state is stored in a small versioned binary file in the runtime
+ * directory. The file is memory-mapped when loaded. Files of the other
+ * versions and damaged files are ignored, so the tiling just starts
+ * from scratch in that case.
+ */
+struct StateSnapshot {
+    static constexpr quint32 magic = 0x42495354; ///< "BIST"
+    static constexpr quint32 version = 1;
+
+    std::vector<SurfaceState> surfaces;
+    std::vector<QString> windowOrder; ///< Ids of the managed windows in their order
+
+    /**
+     * @return default location of the snapshot file
+     */
+    static QString defaultPath();
+
+    /**
+     * Read the snapshot from the file
+     * @return nothing, if the file does not exist, has another version or is damaged
+     */
+    static std::optional<StateSnapshot> load(const QString &path);
+
+    /**
+     * Atomically replace the file with the snapshot
+     * @return whether the file was written
+     */
+    bool save(const QString &path) const;
+
+    QByteArray serialize() const;
+    static std::optional<StateSnapshot> deserialize(const QByteArray &);
+
+    bool operator==(const StateSnapshot &) const;
+};
+
+}
@@ -0,0 +1,90 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include "surface-registry.hpp"
+
+#include <utility>
+
+namespace Bismuth
+{
+
+SurfaceRegistry::SurfaceRegistry(std::shared_ptr<const ConfigSnapshot> config)
+    : m_config(std::move(config))
+    , m_surfaces()
+    , m_handles()
+    , m_layoutKeys()
+{
+}
+
+void SurfaceRegistry::setConfig(std::shared_ptr<const ConfigSnapshot> config)
+{
+    m_config = std::move(config);
+
+    for (auto &surface : m_surfaces) {
+        surface.id = surfaceId(surface.key);
+        surface.layoutKey = layoutKey(surface.id);
+        surface.cached = false;
+    }
+}
+
+int SurfaceRegistry::intern(const SurfaceKey &key)
+{
+    auto [it, inserted] = m_handles.emplace(key, static_cast<int>(m_surfaces.size()));
+    if (inserted) {
+        auto surface = Surface{key, surfaceId(key)};
+        surface.layoutKey = layoutKey(surface.id);
+        m_surfaces.push_back(std::move(surface));
+    }
+    return it->second;
+}
+
+bool SurfaceRegistry::contains(int handle) const
+{
+    return handle >= 0 && handle < static_cast<int>(m_surfaces.size());
+}
+
+const SurfaceRegistry::Surface &SurfaceRegistry::surface(int handle) const
+{
+    return m_surfaces[handle];
+}
+
+int SurfaceRegistry::layoutKey(const QString &surfaceId)
+{
+    return m_layoutKeys.emplace(surfaceId, static_cast<int>(m_layoutKeys.size())).first->second;
+}
+
+void SurfaceRegistry::cache(int handle, bool ignored, const QRect &workingArea)
+{
+    auto &surface = m_surfaces[handle];
+    surface.cached = true;
+    surface.ignored = ignored;
+    surface.workingArea = workingArea;
+}
+
+void SurfaceRegistry::invalidate()
+{
+    for (auto &surface : m_surfaces) {
+        surface.cached = false;
+    }
+}
+
+std::size_t SurfaceRegistry::size() const
+{
+    return m_surfaces.size();
+}
+
+QString SurfaceRegistry::surfaceId(const SurfaceKey &key) const
+{
+    // The ids are in the saved state, so the format (including the quote
+    // before the desktop) must stay as it was in the script
+    auto id = QString::number(key.screen);
+    if (m_config->layoutPerActivity) {
+        id += QLatin1Char('@') + key.activity;
+    }
+    if (m_config->layoutPerDesktop) {
+        id += QStringLiteral("\"#") + QString::number(key.desktop);
+    }
+    return id;
+}
+
+}
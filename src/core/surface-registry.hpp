@@ -0,0 +1,91 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <QRect>
+#include <QString>
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "config-snapshot.hpp"
+#include "window-registry.hpp"
+
+namespace Bismuth
+{
+
+/**
+ * Interned surfaces of the workspace.
+ *
+ * Every (screen, activity, desktop) tuple gets a small integer handle, that
+ * stays valid for the lifetime of the registry, so that the surfaces are
+ * compared and looked up by the handle instead of the strings. The id of the
+ * surface is built once per config change. The working area and the ignore
+ * flag are cached, until the screens, desktops or activities change.
+ */
+class SurfaceRegistry
+{
+public:
+    struct Surface {
+        SurfaceKey key;
+        QString id; ///< Id of the layouts, the same for the surfaces, that are not separated by the config
+        int layoutKey = 0; ///< Interned id
+        bool cached = false; ///< Whether the ignore flag and the working area are valid
+        bool ignored = false;
+        QRect workingArea{};
+    };
+
+    explicit SurfaceRegistry(std::shared_ptr<const ConfigSnapshot>);
+
+    /**
+     * Rebuild the ids of all the surfaces with the new config and drop the
+     * cached values. The handles stay the same.
+     */
+    void setConfig(std::shared_ptr<const ConfigSnapshot>);
+
+    /**
+     * @return handle of the surface, the same for every call with the same key
+     */
+    int intern(const SurfaceKey &);
+
+    /**
+     * @return whether the handle was returned by intern
+     */
+    bool contains(int handle) const;
+
+    /**
+     * @param handle handle, returned by intern
+     */
+    const Surface &surface(int handle) const;
+
+    /**
+     * @return layout key of the surface id, e.g. the one from the saved state.
+     * It is the same as the layout key of the surfaces with this id.
+     */
+    int layoutKey(const QString &surfaceId);
+
+    /**
+     * Remember the ignore flag and the working area of the surface until
+     * the next invalidation
+     */
+    void cache(int handle, bool ignored, const QRect &workingArea);
+
+    /**
+     * Drop the cached values of all the surfaces, e.g. when a screen was resized
+     */
+    void invalidate();
+
+    std::size_t size() const;
+
+private:
+    QString surfaceId(const SurfaceKey &) const;
+
+    std::shared_ptr<const ConfigSnapshot> m_config;
+    std::vector<Surface> m_surfaces; ///< Indexed by the handle
+    std::unordered_map<SurfaceKey, int, SurfaceKeyHash> m_handles;
+    std::unordered_map<QString, int> m_layoutKeys;
+};
+
+}
@@ -0,0 +1,146 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include "tracer.hpp"
+
+#include <QCoreApplication>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <algorithm>
+#include <chrono>
+
+namespace Bismuth
+{
+
+namespace
+{
+std::size_t roundUpToPowerOfTwo(std::size_t value)
+{
+    auto result = std::size_t(1);
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+}
+
+Tracer::Tracer(std::size_t capacity)
+    : m_slots(std::make_unique<Slot[]>(roundUpToPowerOfTwo(std::max<std::size_t>(capacity, 1))))
+    , m_mask(roundUpToPowerOfTwo(std::max<std::size_t>(capacity, 1)) - 1)
+{
+}
+
+qint64 Tracer::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int Tracer::intern(const QString &string)
+{
+    std::lock_guard<std::mutex> lock(m_stringsMutex);
+
+    auto it = m_stringIds.find(string);
+    if (it != m_stringIds.end()) {
+        return it->second;
+    }
+
+    const auto id = static_cast<int>(m_strings.size());
+    m_strings.push_back(string);
+    m_stringIds.emplace(string, id);
+    return id;
+}
+
+void Tracer::record(int name, qint64 start, qint64 end, int detail)
+{
+    const auto ticket = m_head.fetch_add(1, std::memory_order_relaxed);
+    auto &slot = m_slots[ticket & m_mask];
+
+    slot.sequence.store(ticket * 2 + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.detail.store(detail, std::memory_order_relaxed);
+    slot.thread.store(currentThread(), std::memory_order_relaxed);
+    slot.start.store(start, std::memory_order_relaxed);
+    slot.duration.store(end - start, std::memory_order_relaxed);
+
+    slot.sequence.store(ticket * 2 + 2, std::memory_order_release);
+}
+
+QByteArray Tracer::toChromeJson() const
+{
+    const auto head = m_head.load(std::memory_order_acquire);
+    const auto capacity = static_cast<quint64>(m_mask) + 1;
+    const auto first = head > capacity ? head - capacity : 0;
+    const auto pid = static_cast<qint64>(QCoreApplication::applicationPid());
+
+    std::lock_guard<std::mutex> lock(m_stringsMutex);
+
+    auto events = QJsonArray();
+    for (auto ticket = first; ticket < head; ++ticket) {
+        const auto &slot = m_slots[ticket & m_mask];
+
+        // Skip the slots, that are being written or were already overwritten
+        const auto sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence != ticket * 2 + 2) {
+            continue;
+        }
+
+        const auto name = slot.name.load(std::memory_order_relaxed);
+        const auto detail = slot.detail.load(std::memory_order_relaxed);
+        const auto thread = slot.thread.load(std::memory_order_relaxed);
+        const auto start = slot.start.load(std::memory_order_relaxed);
+        const auto duration = slot.duration.load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != sequence) {
+            continue;
+        }
+
+        // Timestamps are in microseconds in this format
+        auto event = QJsonObject{
+            {QStringLiteral("name"), m_strings.at(name)},
+            {QStringLiteral("cat"), QStringLiteral("bismuth")},
+            {QStringLiteral("ph"), QStringLiteral("X")},
+            {QStringLiteral("ts"), start / 1000.0},
+            {QStringLiteral("dur"), duration / 1000.0},
+            {QStringLiteral("pid"), pid},
+            {QStringLiteral("tid"), thread},
+        };
+        if (detail >= 0) {
+            event.insert(QStringLiteral("args"), QJsonObject{{QStringLiteral("detail"), m_strings.at(detail)}});
+        }
+        events.append(event);
+    }
+
+    const auto trace = QJsonObject{
+        {QStringLiteral("traceEvents"), events},
+        {QStringLiteral("displayTimeUnit"), QStringLiteral("ms")},
+    };
+    return QJsonDocument(trace).toJson(QJsonDocument::Compact);
+}
+
+int Tracer::currentThread()
+{
+    // Small sequential numbers are easier to read in the viewer than the native ids
+    static std::atomic<int> s_threadCount{0};
+    thread_local const auto s_thread = ++s_threadCount;
+    return s_thread;
+}
+
+TraceSpan::TraceSpan(Tracer &tracer, int name, int detail)
+    : m_tracer(tracer)
+    , m_name(name)
+    , m_detail(detail)
+    , m_start(Tracer::now())
+{
+}
+
+TraceSpan::~TraceSpan()
+{
+    m_tracer.record(m_name, m_start, Tracer::now(), m_detail);
+}
+
+}
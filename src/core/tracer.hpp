@@ -0,0 +1,106 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace Bismuth
+{
+
+/**
+ * Recorder of the timed spans of the tiling pipeline.
+ *
+ * The spans are written into a fixed-size ring buffer without locks, so
+ * recording is cheap enough to be always on. Only the latest spans are
+ * kept, older ones are overwritten. The buffer is dumped on demand in the
+ * Chrome trace event format, that can be opened in Perfetto or
+ * chrome://tracing.
+ *
+ * Span names and details are interned strings, so that the buffer holds
+ * only plain numbers.
+ */
+class Tracer
+{
+public:
+    /**
+     * @param capacity maximum number of the kept spans. Rounded up to a power of two.
+     */
+    explicit Tracer(std::size_t capacity = 16384);
+
+    /**
+     * @return monotonic timestamp in nanoseconds
+     */
+    static qint64 now();
+
+    /**
+     * @return the number, identifying the string in the spans. Always the same for equal strings.
+     */
+    int intern(const QString &);
+
+    /**
+     * Record the finished span
+     * @param name interned name of the span
+     * @param start timestamp of the span beginning, @see now()
+     * @param end timestamp of the span end
+     * @param detail interned detail of the span, e.g. the surface id, or -1
+     */
+    void record(int name, qint64 start, qint64 end, int detail = -1);
+
+    /**
+     * @return the recorded spans in the Chrome trace event JSON format
+     */
+    QByteArray toChromeJson() const;
+
+private:
+    /**
+     * One span in the ring buffer. The sequence number is odd while the
+     * span is being written, so that the readers skip torn entries.
+     */
+    struct Slot {
+        std::atomic<quint64> sequence{0};
+        std::atomic<int> name{0};
+        std::atomic<int> detail{-1};
+        std::atomic<int> thread{0};
+        std::atomic<qint64> start{0};
+        std::atomic<qint64> duration{0};
+    };
+
+    static int currentThread();
+
+    std::unique_ptr<Slot[]> m_slots;
+    std::size_t m_mask;
+    std::atomic<quint64> m_head{0}; ///< Number of the spans recorded so far
+
+    mutable std::mutex m_stringsMutex; ///< Guards only the interned strings, never the buffer
+    std::unordered_map<QString, int> m_stringIds;
+    std::vector<QString> m_strings;
+};
+
+/**
+ * Records a span from its construction to its destruction
+ */
+class TraceSpan
+{
+public:
+    TraceSpan(Tracer &, int name, int detail = -1);
+    ~TraceSpan();
+
+    TraceSpan(const TraceSpan &) = delete;
+    TraceSpan &operator=(const TraceSpan &) = delete;
+
+private:
+    Tracer &m_tracer;
+    int m_name;
+    int m_detail;
+    qint64 m_start;
+};
+
+}
@@ -6,6 +6,8 @@
 #include <KGlobalAccel>
 #include <KLocalizedString>
 #include <QAction>
+#include <QJSValueIterator>
+#include <QJsonArray>
 #include <QKeySequence>
 
 #include "controller.hpp"
@@ -14,120 +16,916 @@
 namespace Bismuth
 {
 
-TSProxy::TSProxy(QQmlEngine *engine, Bismuth::Controller &controller, Bismuth::Config &config)
+TSProxy::TSProxy(QQmlEngine *engine,
+                 Bismuth::Controller &controller,
+                 Bismuth::Engine &nativeEngine,
+                 Bismuth::ArrangeScheduler &arrangeScheduler,
+                 Bismuth::Tracer &tracer,
+                 std::shared_ptr<const ConfigSnapshot> config)
     : QObject()
     , m_engine(engine)
-    , m_config(config)
+    , m_config(std::move(config))
+    , m_jsConfig()
+    , m_configChanges(ConfigSnapshot::NoChanges)
+    , m_windowRules(m_config)
+    , m_commitTable()
+    , m_echoTracker()
+    , m_windowRegistry()
+    , m_surfaceRegistry(m_config)
+    , m_geometryBuffer()
+    , m_geometryBuffers()
+    , m_restoredState()
+    , m_layoutStore()
+    , m_dragTracker()
+    , m_recorder()
+    , m_metrics()
     , m_controller(controller)
+    , m_nativeEngine(nativeEngine)
+    , m_arrangeScheduler(arrangeScheduler)
+    , m_tracer(tracer)
+    , m_layoutSpanName(tracer.intern(QStringLiteral("layout")))
+    , m_shortcutSpanName(tracer.intern(QStringLiteral("shortcut")))
+    , m_arrangeSpanName(tracer.intern(QStringLiteral("arrange")))
 {
+    connect(&m_arrangeScheduler, &ArrangeScheduler::arrangeRequested, this, &TSProxy::arrangeRequested);
+
+    m_layoutStore.setLayoutOrder(m_config->layoutOrder);
 }
 
 QJSValue TSProxy::jsConfig()
 {
+    m_metrics.countCall(Metrics::ConfigCall);
+    if (m_jsConfig.isUndefined()) {
+        m_jsConfig = createJSConfig();
+    }
+
+    return m_jsConfig;
+}
+
+quint64 TSProxy::configGeneration() const
+{
+    return m_config->generation;
+}
+
+int TSProxy::configChanges() const
+{
+    return m_configChanges;
+}
+
+void TSProxy::setConfig(std::shared_ptr<const ConfigSnapshot> config, int changes)
+{
+    m_config = std::move(config);
+    m_configChanges = changes;
+    m_jsConfig = QJSValue();
+
+    // Recompiling the rules drops the cache of the window classes
+    if (changes & (ConfigSnapshot::Rules | ConfigSnapshot::Surfaces)) {
+        m_windowRules.setConfig(m_config);
+    }
+
+    if (changes & ConfigSnapshot::Layouts) {
+        m_layoutStore.setLayoutOrder(m_config->layoutOrder);
+    }
+
+    // The ids and the ignore flags of the surfaces depend on the config
+    if (changes & ConfigSnapshot::Surfaces) {
+        m_surfaceRegistry.setConfig(m_config);
+    }
+
+    Q_EMIT configChanged();
+}
+
+QJSValue TSProxy::createJSConfig() const
+{
+    auto freeze = m_engine->globalObject().property(QStringLiteral("Object")).property(QStringLiteral("freeze"));
     auto configJSObject = m_engine->newObject();
 
     auto setProp = [&configJSObject](const char *propName, const QJSValue &value) {
         configJSObject.setProperty(QString::fromUtf8(propName), value);
     };
 
-    setProp("layoutOrder", m_engine->newArray());
-    auto layoutOrderProp = configJSObject.property(QStringLiteral("layoutOrder"));
-
-    auto arrayIndexCounter = 0;
-    auto addLayout = [&arrayIndexCounter, &layoutOrderProp, this](const char *configKey, const char *layoutId) {
-        auto layoutEnabled = m_config.property(configKey).toBool();
-        if (layoutEnabled) {
-            layoutOrderProp.setProperty(arrayIndexCounter, QString::fromUtf8(layoutId));
-            arrayIndexCounter++;
+    auto setArrayProp = [this, &setProp, &freeze](const char *propName, const auto &list) {
+        auto arrayProperty = m_engine->newArray(list.size());
+        for (auto i = 0; i < list.size(); ++i) {
+            arrayProperty.setProperty(i, list.at(i));
         }
+        setProp(propName, freeze.call({arrayProperty}));
     };
 
-    // HACK: We have to hardcode layoutIds here for now
-    addLayout("enableTileLayout", "TileLayout");
-    addLayout("enableMonocleLayout", "MonocleLayout");
-    addLayout("enableThreeColumnLayout", "ThreeColumnLayout");
-    addLayout("enableSpreadLayout", "SpreadLayout");
-    addLayout("enableStairLayout", "StairLayout");
-    addLayout("enableSpiralLayout", "SpiralLayout");
-    addLayout("enableQuarterLayout", "QuarterLayout");
-    addLayout("enableFloatingLayout", "FloatingLayout");
-    addLayout("enableCascadeLayout", "CascadeLayout");
-
-    setProp("monocleMaximize", m_config.monocleMaximize());
-    setProp("maximizeSoleTile", m_config.maximizeSoleTile());
-    setProp("monocleMinimizeRest", m_config.monocleMinimizeRest());
-    setProp("untileByDragging", m_config.untileByDragging());
-
-    setProp("keepFloatAbove", m_config.keepFloatAbove());
-    setProp("noTileBorder", m_config.noTileBorder());
-
-    if (m_config.limitTileWidth()) {
-        setProp("limitTileWidthRatio", m_config.limitTileWidthRatio());
-    } else {
-        setProp("limitTileWidthRatio", 0);
-    }
+    setArrayProp("layoutOrder", m_config->layoutOrder);
 
-    setProp("screenGapBottom", m_config.screenGapBottom());
-    setProp("screenGapLeft", m_config.screenGapLeft());
-    setProp("screenGapRight", m_config.screenGapRight());
-    setProp("screenGapTop", m_config.screenGapTop());
-    setProp("tileLayoutGap", m_config.tileLayoutGap());
+    setProp("monocleMaximize", m_config->monocleMaximize);
+    setProp("maximizeSoleTile", m_config->maximizeSoleTile);
+    setProp("monocleMinimizeRest", m_config->monocleMinimizeRest);
+    setProp("untileByDragging", m_config->untileByDragging);
 
-    setProp("newWindowAsMaster", m_config.newWindowAsMaster());
-    setProp("layoutPerActivity", m_config.layoutPerActivity());
-    setProp("layoutPerDesktop", m_config.layoutPerDesktop());
+    setProp("keepFloatAbove", m_config->keepFloatAbove);
+    setProp("noTileBorder", m_config->noTileBorder);
+    setProp("limitTileWidthRatio", m_config->limitTileWidthRatio);
 
-    setProp("preventMinimize", m_config.preventMinimize());
-    setProp("preventProtrusion", m_config.preventProtrusion());
+    setProp("screenGapBottom", m_config->screenGapBottom);
+    setProp("screenGapLeft", m_config->screenGapLeft);
+    setProp("screenGapRight", m_config->screenGapRight);
+    setProp("screenGapTop", m_config->screenGapTop);
+    setProp("tileLayoutGap", m_config->tileLayoutGap);
 
-    setProp("floatUtility", m_config.floatUtility());
+    setProp("newWindowAsMaster", m_config->newWindowAsMaster);
+    setProp("layoutPerActivity", m_config->layoutPerActivity);
+    setProp("layoutPerDesktop", m_config->layoutPerDesktop);
 
-    auto setStrArrayProp = [&configJSObject, this, &setProp](const char *propName, const QString &commaSeparatedString, bool asNumbers = false) {
-        auto strList = commaSeparatedString.split(QLatin1Char(','), Qt::SkipEmptyParts);
+    setProp("preventMinimize", m_config->preventMinimize);
+    setProp("preventProtrusion", m_config->preventProtrusion);
 
-        setProp(propName, m_engine->newArray());
-        auto arrayProperty = configJSObject.property(QString::fromUtf8(propName));
+    setProp("floatUtility", m_config->floatUtility);
 
-        for (auto i = 0; i < strList.size(); ++i) {
-            auto value = strList.at(i);
-            if (asNumbers) {
-                arrayProperty.setProperty(i, value.toInt());
-            } else {
-                arrayProperty.setProperty(i, value.trimmed());
-            }
-        }
-    };
+    setProp("experimentalBackend", m_config->experimentalBackend);
 
-    setStrArrayProp("floatingClass", m_config.floatingClass());
-    setStrArrayProp("floatingTitle", m_config.floatingTitle());
-    setStrArrayProp("ignoreClass", m_config.ignoreClass());
-    setStrArrayProp("ignoreTitle", m_config.ignoreTitle());
-    setStrArrayProp("ignoreRole", m_config.ignoreRole());
+    setArrayProp("floatingClass", m_config->floatingClass);
+    setArrayProp("floatingTitle", m_config->floatingTitle);
+    setArrayProp("ignoreClass", m_config->ignoreClass);
+    setArrayProp("ignoreTitle", m_config->ignoreTitle);
+    setArrayProp("ignoreRole", m_config->ignoreRole);
 
-    setStrArrayProp("ignoreActivity", m_config.ignoreActivity());
-    setStrArrayProp("ignoreScreen", m_config.ignoreScreen(), true);
+    setArrayProp("ignoreActivity", m_config->ignoreActivity);
+    setArrayProp("ignoreScreen", m_config->ignoreScreen);
 
-    return configJSObject;
+    return freeze.call({configJSObject});
 }
 
 void TSProxy::registerShortcut(const QJSValue &tsAction)
+{
+    m_metrics.countCall(Metrics::ShortcutCall);
+    m_controller.registerAction(action(tsAction));
+}
+
+void TSProxy::registerShortcuts(const QJSValue &tsActions)
+{
+    m_metrics.countCall(Metrics::ShortcutCall);
+    auto actions = std::vector<Action>();
+    auto actionsCount = tsActions.property(QStringLiteral("length")).toInt();
+    actions.reserve(actionsCount);
+    for (auto i = 0; i < actionsCount; ++i) {
+        actions.push_back(action(tsActions.property(i)));
+    }
+
+    m_controller.registerActions(actions);
+}
+
+Action TSProxy::action(const QJSValue &tsAction)
 {
     auto id = tsAction.property("key").toString();
     auto desk = tsAction.property("description").toString();
     auto keybinding = tsAction.property("defaultKeybinding").toString();
+    auto repeatable = tsAction.property("repeatable").toBool();
+
+    // Resolved once, so that triggering the shortcut is a plain call
+    auto execute = tsAction.property("execute");
+
+    auto tracer = &m_tracer;
+    auto spanName = m_shortcutSpanName;
+    auto spanDetail = m_tracer.intern(id);
+    auto recorder = &m_recorder;
+    auto metrics = &m_metrics;
 
     // NOTE: Lambda MUST capture by copy, otherwise it is an undefined behavior
-    m_controller.registerAction({id, desk, keybinding, [=]() {
-                                     auto callback = tsAction.property("execute");
-                                     qDebug(Bi) << "Shortcut triggered! Id:" << id;
-                                     callback.callWithInstance(tsAction);
-                                 }});
+    auto callback = [=](int repeatCount) mutable {
+        auto span = TraceSpan(*tracer, spanName, spanDetail);
+        const auto start = Tracer::now();
+        recorder->recordShortcut(id, repeatCount);
+        execute.callWithInstance(tsAction, {repeatCount});
+        metrics->recordShortcut(Tracer::now() - start);
+    };
+
+    return {id, desk, keybinding, callback, repeatable};
+}
+
+void TSProxy::logDebug(const QString &message, const QJSValue &fields)
+{
+    m_metrics.countCall(Metrics::LogCall);
+    // The stream arguments are evaluated only if the level is enabled
+    qCDebug(Bi).noquote() << message << formatFields(fields);
+}
+
+void TSProxy::logInfo(const QString &message, const QJSValue &fields)
+{
+    m_metrics.countCall(Metrics::LogCall);
+    qCInfo(Bi).noquote() << message << formatFields(fields);
+}
+
+void TSProxy::logWarning(const QString &message, const QJSValue &fields)
+{
+    m_metrics.countCall(Metrics::LogCall);
+    qCWarning(Bi).noquote() << message << formatFields(fields);
+}
+
+QByteArray TSProxy::applyLayout(const QString &layoutId, const QJSValue &parameters, const QRectF &area, const QJSValue &weights)
+{
+    m_metrics.countCall(Metrics::LayoutCall);
+    auto span = TraceSpan(m_tracer, m_layoutSpanName, m_tracer.intern(layoutId));
+
+    auto layout = m_nativeEngine.layout(layoutId);
+    if (!layout) {
+        qCWarning(Bi) << "No native implementation of the layout" << layoutId;
+        return {};
+    }
+
+    m_nativeEngine.arrange(layoutId, layoutParameters(*layout, parameters), area.toRect(), tileWeights(weights), m_geometryBuffer);
+    return flatGeometries(m_geometryBuffer);
+}
+
+QVariantList TSProxy::applyLayouts(const QJSValue &requests)
+{
+    m_metrics.countCall(Metrics::LayoutCall);
+    auto span = TraceSpan(m_tracer, m_layoutSpanName, m_tracer.intern(QStringLiteral("batch")));
+
+    const auto requestsCount = requests.property(QStringLiteral("length")).toInt();
+    auto arrangeRequests = std::vector<ArrangeRequest>();
+    arrangeRequests.reserve(requestsCount);
+
+    for (auto i = 0; i < requestsCount; ++i) {
+        const auto request = requests.property(i);
+        auto layoutId = request.property(QStringLiteral("layoutId")).toString();
+        const auto area = request.property(QStringLiteral("area"));
+
+        // Unknown layouts get no geometries, the same as in applyLayout
+        auto layout = m_nativeEngine.layout(layoutId);
+        if (!layout) {
+            qCWarning(Bi) << "No native implementation of the layout" << layoutId;
+        }
+
+        arrangeRequests.push_back({
+            std::move(layoutId),
+            layout ? layoutParameters(*layout, request.property(QStringLiteral("parameters"))) : LayoutParameters(),
+            QRectF(area.property(QStringLiteral("x")).toNumber(),
+                   area.property(QStringLiteral("y")).toNumber(),
+                   area.property(QStringLiteral("width")).toNumber(),
+                   area.property(QStringLiteral("height")).toNumber())
+                .toRect(),
+            tileWeights(request.property(QStringLiteral("weights"))),
+        });
+    }
+
+    m_nativeEngine.arrange(arrangeRequests, m_geometryBuffers);
+
+    auto result = QVariantList();
+    result.reserve(requestsCount);
+    for (auto i = 0; i < requestsCount; ++i) {
+        result.append(QVariant(flatGeometries(m_geometryBuffers[i])));
+    }
+    return result;
+}
+
+int TSProxy::classifyWindow(const QString &resourceClass, const QString &resourceName, const QString &windowRole, const QString &caption) const
+{
+    m_metrics.countCall(Metrics::RulesCall);
+    return m_windowRules.classify(resourceClass, resourceName, windowRole, caption);
+}
+
+int TSProxy::internSurface(int screen, const QString &activity, int desktop)
+{
+    m_metrics.countCall(Metrics::SurfaceCall);
+    return m_surfaceRegistry.intern({screen, desktop, activity});
+}
+
+QJSValue TSProxy::surfaceInfo(int surface) const
+{
+    m_metrics.countCall(Metrics::SurfaceCall);
+    if (!m_surfaceRegistry.contains(surface) || !m_surfaceRegistry.surface(surface).cached) {
+        return QJSValue(QJSValue::NullValue);
+    }
+
+    return surfaceValue(m_surfaceRegistry.surface(surface));
+}
+
+QJSValue TSProxy::cacheSurface(int surface, const QString &activityName, const QRectF &workingArea)
+{
+    m_metrics.countCall(Metrics::SurfaceCall);
+    if (!m_surfaceRegistry.contains(surface)) {
+        return QJSValue(QJSValue::NullValue);
+    }
+
+    const auto &key = m_surfaceRegistry.surface(surface).key;
+    m_surfaceRegistry.cache(surface, m_windowRules.ignoresSurface(activityName, key.screen), workingArea.toRect());
+    return surfaceValue(m_surfaceRegistry.surface(surface));
+}
+
+void TSProxy::invalidateSurfaces()
+{
+    m_metrics.countCall(Metrics::SurfaceCall);
+    m_surfaceRegistry.invalidate();
 }
 
-void TSProxy::log(const QJSValue &value)
+int TSProxy::surfaceLayoutKey(const QString &surfaceId)
 {
-    auto valAsString = value.toString();
-    qDebug(Bi).noquote() << valAsString;
-};
+    m_metrics.countCall(Metrics::SurfaceCall);
+    return m_surfaceRegistry.layoutKey(surfaceId);
+}
+
+QJSValue TSProxy::surfaceValue(const SurfaceRegistry::Surface &surface) const
+{
+    auto result = m_engine->newObject();
+    result.setProperty(QStringLiteral("id"), surface.id);
+    result.setProperty(QStringLiteral("layoutKey"), surface.layoutKey);
+    // The surface values are built only, when the surface is cached again
+    result.setProperty(QStringLiteral("traceId"), m_tracer.intern(surface.id));
+    result.setProperty(QStringLiteral("ignore"), surface.ignored);
+    result.setProperty(QStringLiteral("workingArea"), m_engine->toScriptValue(QRectF(surface.workingArea)));
+    return result;
+}
+
+void TSProxy::scheduleArrange(int surface)
+{
+    m_metrics.countCall(Metrics::ScheduleCall);
+    m_arrangeScheduler.schedule(surface);
+}
+
+void TSProxy::scheduleArrangeAll()
+{
+    m_metrics.countCall(Metrics::ScheduleCall);
+    m_arrangeScheduler.scheduleAll();
+}
+
+QVariantList TSProxy::filterCommits(const QJSValue &commits)
+{
+    m_metrics.countCall(Metrics::CommitCall);
+    auto result = QVariantList();
+
+    auto commitsCount = commits.property(QStringLiteral("length")).toInt();
+    for (auto i = 0; i < commitsCount; ++i) {
+        auto jsCommit = commits.property(i);
+        const auto commit = windowCommit(jsCommit);
+        const auto id = jsCommit.property(QStringLiteral("id")).toString();
+
+        // Even if the commit is skipped, this is where the window is supposed to be
+        if (commit.geometry) {
+            m_windowRegistry.setGeometry(id, *commit.geometry);
+        }
+
+        if (m_commitTable.update(id, commit)) {
+            result.append(i);
+        }
+    }
+
+    return result;
+}
+
+void TSProxy::forgetCommit(const QString &windowId)
+{
+    m_metrics.countCall(Metrics::CommitCall);
+    m_commitTable.forget(windowId);
+}
+
+void TSProxy::writeWindow(const QJSValue &client, const QJSValue &jsCommit)
+{
+    m_metrics.countCall(Metrics::CommitCall);
+    auto object = client.toQObject();
+    if (!object) {
+        return;
+    }
+
+    const auto commit = windowCommit(jsCommit);
+    m_echoTracker.record(jsCommit.property(QStringLiteral("id")).toString(), commit, Tracer::now());
+
+    // The border is changed first, as it resizes the frame around the client
+    if (commit.noBorder) {
+        object->setProperty("noBorder", *commit.noBorder);
+    }
+    if (commit.keepAbove) {
+        object->setProperty("keepAbove", *commit.keepAbove);
+    }
+    if (commit.geometry) {
+        object->setProperty("frameGeometry", QRectF(*commit.geometry));
+    }
+}
+
+bool TSProxy::consumeEcho(const QJSValue &client, const QString &windowId, int property)
+{
+    m_metrics.countCall(Metrics::CommitCall);
+    auto object = client.toQObject();
+    if (!object) {
+        return false;
+    }
+
+    const auto now = Tracer::now();
+    auto sequence = quint64(0);
+    switch (property) {
+    case EchoTracker::Geometry:
+        sequence = m_echoTracker.consumeGeometry(windowId, object->property("frameGeometry").toRectF().toRect(), now);
+        break;
+    case EchoTracker::NoBorder:
+        sequence = m_echoTracker.consumeFlag(windowId, EchoTracker::NoBorder, object->property("noBorder").toBool(), now);
+        break;
+    case EchoTracker::KeepAbove:
+        sequence = m_echoTracker.consumeFlag(windowId, EchoTracker::KeepAbove, object->property("keepAbove").toBool(), now);
+        break;
+    default:
+        qCWarning(Bi) << "Unknown echoed property" << property;
+        return false;
+    }
+
+    if (sequence == 0) {
+        // Changed not by us, so the next commit must be sent as is
+        m_commitTable.forget(windowId);
+        return false;
+    }
+
+    qCDebug(Bi) << "Ignoring the echo of the write" << sequence << "to" << windowId;
+    return true;
+}
+
+quint64 TSProxy::commitsSent() const
+{
+    return m_commitTable.sentCount();
+}
+
+quint64 TSProxy::commitsSkipped() const
+{
+    return m_commitTable.skippedCount();
+}
+
+void TSProxy::addWindow(const QString &id, const QJSValue &properties, bool front)
+{
+    m_metrics.countCall(Metrics::WindowCall);
+    m_windowRegistry.add(id, windowProperties(properties), front);
+}
+
+void TSProxy::removeWindow(const QString &id)
+{
+    m_metrics.countCall(Metrics::WindowCall);
+    m_windowRegistry.remove(id);
+    m_echoTracker.forget(id);
+}
+
+void TSProxy::updateWindow(const QString &id, const QJSValue &properties)
+{
+    m_metrics.countCall(Metrics::WindowCall);
+    m_windowRegistry.update(id, windowProperties(properties));
+}
+
+void TSProxy::moveWindow(const QString &source, const QString &destination, bool after)
+{
+    m_metrics.countCall(Metrics::WindowCall);
+    m_windowRegistry.move(source, destination, after);
+}
+
+void TSProxy::swapWindows(const QString &alpha, const QString &beta)
+{
+    m_metrics.countCall(Metrics::WindowCall);
+    m_windowRegistry.swap(alpha, beta);
+}
+
+void TSProxy::putWindowToFront(const QString &id)
+{
+    m_metrics.countCall(Metrics::WindowCall);
+    m_windowRegistry.putToFront(id);
+}
+
+QStringList TSProxy::windowsOn(int surface, int view)
+{
+    m_metrics.countCall(Metrics::WindowCall);
+    if (!m_surfaceRegistry.contains(surface)) {
+        return {};
+    }
+
+    const auto &ids = m_windowRegistry.windowsOn(m_surfaceRegistry.surface(surface).key, static_cast<WindowRegistry::View>(view));
+
+    auto result = QStringList();
+    result.reserve(static_cast<int>(ids.size()));
+    for (const auto &id : ids) {
+        result.append(id);
+    }
+
+    return result;
+}
+
+void TSProxy::setWindowFocused(const QString &id)
+{
+    m_metrics.countCall(Metrics::WindowCall);
+    m_windowRegistry.setFocused(id);
+}
+
+QString TSProxy::neighborWindow(int surface, const QRectF &basis, const QString &direction)
+{
+    m_metrics.countCall(Metrics::WindowCall);
+    if (!m_surfaceRegistry.contains(surface)) {
+        return {};
+    }
+
+    auto spatialDirection = SpatialIndex::Direction::Up;
+    if (direction == QStringLiteral("down")) {
+        spatialDirection = SpatialIndex::Direction::Down;
+    } else if (direction == QStringLiteral("left")) {
+        spatialDirection = SpatialIndex::Direction::Left;
+    } else if (direction == QStringLiteral("right")) {
+        spatialDirection = SpatialIndex::Direction::Right;
+    }
+
+    return m_windowRegistry.neighbor(m_surfaceRegistry.surface(surface).key, basis.toRect(), spatialDirection);
+}
+
+void TSProxy::beginDrag(const QString &windowId)
+{
+    m_metrics.countCall(Metrics::DragCall);
+    m_commitTable.forget(windowId);
+    m_dragTracker.begin(windowId);
+}
+
+QString TSProxy::endDrag(int x, int y, int surface)
+{
+    m_metrics.countCall(Metrics::DragCall);
+    if (!m_dragTracker.active()) {
+        return {};
+    }
+
+    // The tiles are read only once, so the zones are always those of the
+    // surface of the drop, even if it was arranged during the move
+    auto tiles = std::vector<std::pair<QString, QRect>>();
+    if (m_surfaceRegistry.contains(surface)) {
+        for (const auto &id : m_windowRegistry.windowsOn(m_surfaceRegistry.surface(surface).key, WindowRegistry::View::VisibleTiled)) {
+            tiles.emplace_back(id, m_windowRegistry.geometry(id));
+        }
+    }
+
+    auto target = m_dragTracker.target(tiles, QPoint(x, y));
+    m_dragTracker.end();
+    return target;
+}
+
+int TSProxy::traceName(const QString &name)
+{
+    m_metrics.countCall(Metrics::TraceCall);
+    return m_tracer.intern(name);
+}
+
+double TSProxy::traceBegin() const
+{
+    m_metrics.countCall(Metrics::TraceCall);
+    return static_cast<double>(Tracer::now());
+}
+
+void TSProxy::traceEnd(int name, double start, int detail)
+{
+    m_metrics.countCall(Metrics::TraceCall);
+    const auto end = Tracer::now();
+    m_tracer.record(name, static_cast<qint64>(start), end, detail);
+}
+
+void TSProxy::arrangeEnd(int surfaceTraceId, const QString &layoutId, double layoutStart, double layoutEnd, double commitStart)
+{
+    m_metrics.countCall(Metrics::TraceCall);
+    const auto end = Tracer::now();
+    const auto start = static_cast<qint64>(layoutStart);
+    const auto layoutFinish = static_cast<qint64>(layoutEnd);
+    const auto commitBegin = static_cast<qint64>(commitStart);
+
+    // The parts are adjacent, unless the surface was arranged in a batch
+    if (layoutFinish == commitBegin) {
+        m_tracer.record(m_arrangeSpanName, start, end, surfaceTraceId);
+    } else {
+        m_tracer.record(m_arrangeSpanName, start, layoutFinish, surfaceTraceId);
+        m_tracer.record(m_arrangeSpanName, commitBegin, end, surfaceTraceId);
+    }
+    m_metrics.recordArrange(layoutId, (layoutFinish - start) + (end - commitBegin));
+}
+
+QJsonObject TSProxy::metrics()
+{
+    auto surfaces = QJsonArray();
+    for (auto handle = 0; handle < static_cast<int>(m_surfaceRegistry.size()); ++handle) {
+        const auto &key = m_surfaceRegistry.surface(handle).key;
+        const auto windows = m_windowRegistry.windowsOn(key, WindowRegistry::View::All).size();
+        if (windows == 0) {
+            continue;
+        }
+
+        surfaces.append(QJsonObject{
+            {QStringLiteral("screen"), key.screen},
+            {QStringLiteral("desktop"), key.desktop},
+            {QStringLiteral("activity"), key.activity},
+            {QStringLiteral("windows"), static_cast<qint64>(windows)},
+        });
+    }
+
+    auto result = m_metrics.toJson();
+    result.insert(QStringLiteral("surfaces"), surfaces);
+    result.insert(QStringLiteral("commitsSent"), static_cast<qint64>(m_commitTable.sentCount()));
+    result.insert(QStringLiteral("commitsSkipped"), static_cast<qint64>(m_commitTable.skippedCount()));
+    result.insert(QStringLiteral("echoesIgnored"), static_cast<qint64>(m_echoTracker.echoCount()));
+    return result;
+}
+
+void TSProxy::resetMetrics()
+{
+    m_metrics.reset();
+    m_commitTable.resetCounters();
+    m_echoTracker.resetCounters();
+}
+
+void TSProxy::setRestoredState(std::optional<StateSnapshot> state)
+{
+    m_restoredState = std::move(state);
+}
+
+void TSProxy::restoreState()
+{
+    m_metrics.countCall(Metrics::StateCall);
+    if (!m_restoredState) {
+        return;
+    }
+
+    m_windowRegistry.restoreOrder(m_restoredState->windowOrder);
+
+    for (auto &surface : m_restoredState->surfaces) {
+        const auto layoutKey = m_surfaceRegistry.layoutKey(surface.surfaceId);
+        m_layoutStore.restore(layoutKey, std::move(surface));
+    }
+    m_restoredState.reset();
+}
+
+QString TSProxy::currentLayout(int surface)
+{
+    m_metrics.countCall(Metrics::StateCall);
+    if (!m_surfaceRegistry.contains(surface)) {
+        return {};
+    }
+
+    const auto &info = m_surfaceRegistry.surface(surface);
+    return m_layoutStore.currentLayout(info.layoutKey, info.id);
+}
+
+QString TSProxy::cycleLayout(int surface, int step)
+{
+    m_metrics.countCall(Metrics::StateCall);
+    if (!m_surfaceRegistry.contains(surface)) {
+        return {};
+    }
+
+    const auto &info = m_surfaceRegistry.surface(surface);
+    return m_layoutStore.cycleLayout(info.layoutKey, info.id, step);
+}
+
+QString TSProxy::toggleLayout(int surface, const QString &layoutId)
+{
+    m_metrics.countCall(Metrics::StateCall);
+    if (!m_surfaceRegistry.contains(surface)) {
+        return {};
+    }
+
+    const auto &info = m_surfaceRegistry.surface(surface);
+    return m_layoutStore.toggleLayout(info.layoutKey, info.id, layoutId);
+}
+
+QVariantList TSProxy::layoutValues(int surface, const QString &layoutId)
+{
+    m_metrics.countCall(Metrics::StateCall);
+    if (!m_surfaceRegistry.contains(surface)) {
+        return {};
+    }
+
+    const auto &info = m_surfaceRegistry.surface(surface);
+    auto result = QVariantList();
+    for (auto value : m_layoutStore.values(info.layoutKey, info.id, layoutId)) {
+        result.append(value);
+    }
+    return result;
+}
+
+void TSProxy::storeLayoutValues(int surface, const QString &layoutId, const QJSValue &jsValues)
+{
+    m_metrics.countCall(Metrics::StateCall);
+    if (!m_surfaceRegistry.contains(surface)) {
+        return;
+    }
+
+    auto valuesCount = jsValues.property(QStringLiteral("length")).toInt();
+    auto values = std::vector<qreal>();
+    values.reserve(valuesCount);
+    for (auto i = 0; i < valuesCount; ++i) {
+        values.push_back(jsValues.property(i).toNumber());
+    }
+
+    const auto &info = m_surfaceRegistry.surface(surface);
+    m_layoutStore.setValues(info.layoutKey, info.id, layoutId, std::move(values));
+}
+
+void TSProxy::requestLayoutState()
+{
+    Q_EMIT layoutStateRequested();
+}
+
+StateSnapshot TSProxy::stateSnapshot() const
+{
+    auto snapshot = StateSnapshot();
+    // Do not lose the saved layouts, if the script has not started yet
+    snapshot.surfaces = m_restoredState ? m_restoredState->surfaces : m_layoutStore.states();
+    snapshot.windowOrder = m_windowRegistry.order();
+    return snapshot;
+}
+
+bool TSProxy::startRecording(const QString &path)
+{
+    if (!m_recorder.start(path)) {
+        return false;
+    }
+
+    Q_EMIT recordingChanged();
+    return true;
+}
+
+QString TSProxy::stopRecording()
+{
+    if (!m_recorder.isRecording()) {
+        return {};
+    }
+
+    auto path = m_recorder.stop();
+    Q_EMIT recordingChanged();
+    return path;
+}
+
+bool TSProxy::recording() const
+{
+    return m_recorder.isRecording();
+}
+
+void TSProxy::recordWorkspace(const QJSValue &jsWorkspace)
+{
+    m_metrics.countCall(Metrics::RecordCall);
+    auto workspace = TraceWorkspace();
+    workspace.numScreens = jsWorkspace.property(QStringLiteral("numScreens")).toInt();
+    workspace.desktops = jsWorkspace.property(QStringLiteral("desktops")).toInt();
+    workspace.currentDesktop = jsWorkspace.property(QStringLiteral("currentDesktop")).toInt();
+    workspace.activeScreen = jsWorkspace.property(QStringLiteral("activeScreen")).toInt();
+    workspace.currentActivity = jsWorkspace.property(QStringLiteral("currentActivity")).toString();
+
+    auto jsActivities = jsWorkspace.property(QStringLiteral("activities"));
+    auto activitiesCount = jsActivities.property(QStringLiteral("length")).toInt();
+    for (auto i = 0; i < activitiesCount; ++i) {
+        auto jsActivity = jsActivities.property(i);
+        workspace.activities.emplace_back(jsActivity.property(QStringLiteral("id")).toString(), jsActivity.property(QStringLiteral("name")).toString());
+    }
+
+    auto jsAreas = jsWorkspace.property(QStringLiteral("areas"));
+    auto areasCount = jsAreas.property(QStringLiteral("length")).toInt();
+    for (auto i = 0; i < areasCount; ++i) {
+        auto jsArea = jsAreas.property(i);
+        auto area = TraceArea();
+        area.screen = jsArea.property(QStringLiteral("screen")).toInt();
+        area.desktop = jsArea.property(QStringLiteral("desktop")).toInt();
+        // Read property by property, as both QRect and plain objects are accepted
+        auto jsRect = jsArea.property(QStringLiteral("area"));
+        area.area = QRect(jsRect.property(QStringLiteral("x")).toInt(),
+                          jsRect.property(QStringLiteral("y")).toInt(),
+                          jsRect.property(QStringLiteral("width")).toInt(),
+                          jsRect.property(QStringLiteral("height")).toInt());
+        workspace.areas.push_back(area);
+    }
+
+    auto jsClients = jsWorkspace.property(QStringLiteral("clients"));
+    auto clientsCount = jsClients.property(QStringLiteral("length")).toInt();
+    auto clients = QList<QObject *>();
+    for (auto i = 0; i < clientsCount; ++i) {
+        if (auto client = jsClients.property(i).toQObject()) {
+            clients.append(client);
+        }
+    }
+
+    m_recorder.recordWorkspace(std::move(workspace), clients);
+}
+
+void TSProxy::recordEvent(int type, const QJSValue &client, const QJSValue &value)
+{
+    m_metrics.countCall(Metrics::RecordCall);
+    if (type < TraceEvent::ClientAdded || type >= TraceEvent::ShortcutTriggered) {
+        qCWarning(Bi) << "Unknown recorded event type" << type;
+        return;
+    }
+
+    m_recorder.recordEvent(static_cast<TraceEvent::Type>(type), client.toQObject(), value.toVariant());
+}
+
+QString TSProxy::formatFields(const QJSValue &fields)
+{
+    auto object = fields.isCallable() ? fields.call() : fields;
+    if (object.isUndefined() || object.isNull()) {
+        return {};
+    }
+
+    if (!object.isObject() || object.isError()) {
+        return object.toString();
+    }
+
+    auto result = QStringList();
+    QJSValueIterator it(object);
+    while (it.hasNext()) {
+        it.next();
+        result.append(it.name() + QLatin1Char('=') + it.value().toString());
+    }
+
+    return result.join(QLatin1Char(' '));
+}
+
+LayoutParameters TSProxy::layoutParameters(const Layout &layout, const QJSValue &parameters)
+{
+    auto result = layout.defaultParameters();
+
+    auto readInt = [&parameters](const char *name, int &field) {
+        auto value = parameters.property(QString::fromUtf8(name));
+        if (value.isNumber()) {
+            field = value.toInt();
+        }
+    };
+
+    auto readReal = [&parameters](const char *name, qreal &field) {
+        auto value = parameters.property(QString::fromUtf8(name));
+        if (value.isNumber()) {
+            field = value.toNumber();
+        }
+    };
+
+    readInt("numMaster", result.numMaster);
+    readReal("masterRatio", result.masterRatio);
+    readInt("angle", result.angle);
+    readInt("masterAngle", result.masterAngle);
+    readReal("vsplit", result.vsplit);
+    readReal("lhsplit", result.lhsplit);
+    readReal("rhsplit", result.rhsplit);
+    readReal("space", result.space);
+    readInt("direction", result.direction);
+
+    auto ratios = parameters.property(QStringLiteral("ratios"));
+    if (ratios.isArray()) {
+        auto length = ratios.property(QStringLiteral("length")).toInt();
+        result.ratios.resize(length);
+        for (auto i = 0; i < length; ++i) {
+            result.ratios[i] = ratios.property(i).toNumber();
+        }
+    }
+
+    return result;
+}
+
+std::vector<qreal> TSProxy::tileWeights(const QJSValue &weights)
+{
+    auto result = std::vector<qreal>();
+    auto tilesCount = weights.property(QStringLiteral("length")).toInt();
+    result.reserve(tilesCount);
+    for (auto i = 0; i < tilesCount; ++i) {
+        result.push_back(weights.property(i).toNumber());
+    }
+    return result;
+}
+
+QByteArray TSProxy::flatGeometries(const GeometryBuffer &geometries)
+{
+    // The script gets the byte array as an ArrayBuffer, which is one object
+    // instead of one value per coordinate
+    auto result = QByteArray(geometries.size() * 4 * static_cast<int>(sizeof(qint32)), Qt::Uninitialized);
+    geometries.writeFlat(reinterpret_cast<qint32 *>(result.data()));
+    return result;
+}
+
+WindowCommit TSProxy::windowCommit(const QJSValue &jsCommit)
+{
+    auto commit = WindowCommit();
+
+    auto geometry = jsCommit.property(QStringLiteral("geometry"));
+    if (geometry.isObject()) {
+        commit.geometry = QRect(geometry.property(QStringLiteral("x")).toInt(),
+                                geometry.property(QStringLiteral("y")).toInt(),
+                                geometry.property(QStringLiteral("width")).toInt(),
+                                geometry.property(QStringLiteral("height")).toInt());
+    }
+
+    auto noBorder = jsCommit.property(QStringLiteral("noBorder"));
+    if (noBorder.isBool()) {
+        commit.noBorder = noBorder.toBool();
+    }
+
+    auto keepAbove = jsCommit.property(QStringLiteral("keepAbove"));
+    if (keepAbove.isBool()) {
+        commit.keepAbove = keepAbove.toBool();
+    }
+
+    return commit;
+}
+
+WindowProperties TSProxy::windowProperties(const QJSValue &jsProperties)
+{
+    auto properties = WindowProperties();
+    properties.screen = jsProperties.property(QStringLiteral("screen")).toInt();
+    properties.desktop = jsProperties.property(QStringLiteral("desktop")).toInt();
+    properties.minimized = jsProperties.property(QStringLiteral("minimized")).toBool();
+    properties.tileable = jsProperties.property(QStringLiteral("tileable")).toBool();
+    properties.tiled = jsProperties.property(QStringLiteral("tiled")).toBool();
+
+    auto activities = jsProperties.property(QStringLiteral("activities"));
+    auto activitiesCount = activities.property(QStringLiteral("length")).toInt();
+    for (auto i = 0; i < activitiesCount; ++i) {
+        properties.activities.append(activities.property(i).toString());
+    }
+
+    return properties;
+}
 
 }
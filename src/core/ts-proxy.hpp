@@ -3,12 +3,33 @@
 
 #pragma once
 
+#include <QByteArray>
 #include <QJSValue>
+#include <QJsonObject>
 #include <QObject>
 #include <QQmlEngine>
+#include <QRectF>
+#include <QVariantList>
 
-#include "config.hpp"
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "arrange-scheduler.hpp"
+#include "commit-table.hpp"
+#include "config-snapshot.hpp"
 #include "controller.hpp"
+#include "drag-tracker.hpp"
+#include "echo-tracker.hpp"
+#include "engine/engine.hpp"
+#include "event-recorder.hpp"
+#include "layout-state-store.hpp"
+#include "metrics.hpp"
+#include "state-snapshot.hpp"
+#include "surface-registry.hpp"
+#include "tracer.hpp"
+#include "window-registry.hpp"
+#include "window-rules.hpp"
 
 namespace Bismuth
 {
@@ -19,14 +40,56 @@ namespace Bismuth
 class TSProxy : public QObject
 {
     Q_OBJECT
+
+    /**
+     * Generation of the config returned by jsConfig. It is increased every
+     * time the configuration is changed.
+     */
+    Q_PROPERTY(quint64 configGeneration READ configGeneration NOTIFY configChanged)
+
+    /**
+     * Groups of the settings, that differ between the current and the
+     * previous config. A combination of ConfigSnapshot::Change values.
+     */
+    Q_PROPERTY(int configChanges READ configChanges NOTIFY configChanged)
+
+    /**
+     * Number of window commits, that changed something and were sent to KWin
+     */
+    Q_PROPERTY(quint64 commitsSent READ commitsSent)
+
+    /**
+     * Number of window commits, that were skipped, as KWin already had their values
+     */
+    Q_PROPERTY(quint64 commitsSkipped READ commitsSkipped)
+
+    /**
+     * Whether the events are being recorded. The script must pass the state
+     * of the workspace to recordWorkspace, when the recording starts.
+     */
+    Q_PROPERTY(bool recording READ recording NOTIFY recordingChanged)
+
 public:
-    TSProxy(QQmlEngine *, Bismuth::Controller &, Bismuth::Config &);
+    TSProxy(QQmlEngine *, Bismuth::Controller &, Bismuth::Engine &, Bismuth::ArrangeScheduler &, Bismuth::Tracer &, std::shared_ptr<const ConfigSnapshot>);
 
     /**
-     * Returns the config usable in the legacy TypeScript logic
+     * Returns the config usable in the legacy TypeScript logic.
+     *
+     * The returned object is frozen and shared between the calls until
+     * the configuration changes.
      */
     Q_INVOKABLE QJSValue jsConfig();
 
+    quint64 configGeneration() const;
+    int configChanges() const;
+
+    /**
+     * Replace the config snapshot. The next call to jsConfig will return
+     * the new values.
+     * @param changes combination of ConfigSnapshot::Change values, @see ConfigSnapshot::changesFrom
+     */
+    void setConfig(std::shared_ptr<const ConfigSnapshot>, int changes);
+
     /**
      * Register the actions from the legacy backend
      * @param tsaction
@@ -34,14 +97,367 @@ public:
     Q_INVOKABLE void registerShortcut(const QJSValue &);
 
     /**
-     * Log the value to the default logging category
+     * Register all the actions from the legacy backend at once
+     * @param tsActions array of actions
+     * @see Controller::registerActions
+     */
+    Q_INVOKABLE void registerShortcuts(const QJSValue &tsActions);
+
+    /**
+     * Log the message to the default logging category with the given level.
+     *
+     * Nothing is evaluated, if the level is disabled for the category.
+     * Debug messages are compiled out of the release builds.
+     *
+     * @param message constant part of the message
+     * @param fields optional object or function, returning an object, whose
+     * properties are appended to the message as key=value pairs
+     */
+    Q_INVOKABLE void logDebug(const QString &message, const QJSValue &fields = QJSValue());
+    Q_INVOKABLE void logInfo(const QString &message, const QJSValue &fields = QJSValue());
+    Q_INVOKABLE void logWarning(const QString &message, const QJSValue &fields = QJSValue());
+
+    /**
+     * Compute the geometries of all the tiles on the surface with the native
+     * layout implementation. The tile width limit is already applied to them.
+     * @param layoutId id of the layout, e.g. "TileLayout"
+     * @param parameters layout parameters object, @see LayoutParameters
+     * @param area tiling area
+     * @param weights array of tile weights
+     * @return x, y, width and height of every tile, that fits into the
+     * layout, as the native 32-bit integers
+     */
+    Q_INVOKABLE QByteArray applyLayout(const QString &layoutId, const QJSValue &parameters, const QRectF &area, const QJSValue &weights);
+
+    /**
+     * Compute the geometries of the tiles on several surfaces at once. The
+     * surfaces are arranged in parallel on the worker threads.
+     * @param requests array of objects with the layoutId, parameters, area and
+     * weights properties, the same as the arguments of applyLayout
+     * @return array with the result of applyLayout for every request
+     */
+    Q_INVOKABLE QVariantList applyLayouts(const QJSValue &requests);
+
+    /**
+     * Check the window against the window rules from the config
+     * @return a combination of WindowRules::Flag values
+     */
+    Q_INVOKABLE int classifyWindow(const QString &resourceClass, const QString &resourceName, const QString &windowRole, const QString &caption) const;
+
+    /**
+     * @return handle of the surface, that stays the same for the lifetime of
+     * the script, @see SurfaceRegistry
+     */
+    Q_INVOKABLE int internSurface(int screen, const QString &activity, int desktop);
+
+    /**
+     * @return object with the id, layoutKey, ignore and workingArea
+     * properties of the surface or null, if they are not cached
+     */
+    Q_INVOKABLE QJSValue surfaceInfo(int surface) const;
+
+    /**
+     * Check the surface against the config and cache it with its working area
+     * @param activityName name of the activity of the surface
+     * @param workingArea area of the surface, in which the windows are placed
+     * @return the same as surfaceInfo
+     */
+    Q_INVOKABLE QJSValue cacheSurface(int surface, const QString &activityName, const QRectF &workingArea);
+
+    /**
+     * Drop the cached working areas of all the surfaces. Must be called,
+     * when the screens, the desktops or the activities change.
+     */
+    Q_INVOKABLE void invalidateSurfaces();
+
+    /**
+     * @return layout key of the surfaces with the given id, e.g. the one from the saved state
+     */
+    Q_INVOKABLE int surfaceLayoutKey(const QString &surfaceId);
+
+    /**
+     * Request the arrangement of the surface. The requests are coalesced
+     * and result in one arrangeRequested signal per event loop iteration.
+     * @param surface handle of the surface, @see internSurface
+     */
+    Q_INVOKABLE void scheduleArrange(int surface);
+
+    /**
+     * Request the arrangement of all the visible surfaces
+     */
+    Q_INVOKABLE void scheduleArrangeAll();
+
+    /**
+     * Find the window commits, that change anything since the last commit
+     * of the same window. The commits are remembered as sent.
+     * @param commits array of objects with the window id and optional
+     * geometry, noBorder and keepAbove properties
+     * @return indices of the commits, that must be sent to KWin
+     */
+    Q_INVOKABLE QVariantList filterCommits(const QJSValue &commits);
+
+    /**
+     * Forget the last commit of the window, so that the next one is sent
+     * unconditionally. Must be called, when the window is changed outside of
+     * filterCommits.
+     */
+    Q_INVOKABLE void forgetCommit(const QString &windowId);
+
+    /**
+     * Write the properties of the commit to the KWin client and remember
+     * them, so that their change signals are recognised as echoes
+     * @param commit object with the window id and optional geometry,
+     * noBorder and keepAbove properties
+     */
+    Q_INVOKABLE void writeWindow(const QJSValue &client, const QJSValue &commit);
+
+    /**
+     * Check, whether the change of the client property is the echo of
+     * writeWindow. Otherwise the last commit of the window is forgotten, as
+     * the window was changed not by us.
+     * @param property one of EchoTracker::Property values
+     * @return whether the change must be ignored
+     */
+    Q_INVOKABLE bool consumeEcho(const QJSValue &client, const QString &windowId, int property);
+
+    quint64 commitsSent() const;
+    quint64 commitsSkipped() const;
+
+    /**
+     * Add the window to the window registry
+     * @param id window id
+     * @param properties object with screen, desktop, activities, minimized,
+     * tileable and tiled properties, @see WindowProperties
+     * @param front whether to put the window at the beginning of the list
+     */
+    Q_INVOKABLE void addWindow(const QString &id, const QJSValue &properties, bool front);
+    Q_INVOKABLE void removeWindow(const QString &id);
+    Q_INVOKABLE void updateWindow(const QString &id, const QJSValue &properties);
+    Q_INVOKABLE void moveWindow(const QString &source, const QString &destination, bool after);
+    Q_INVOKABLE void swapWindows(const QString &alpha, const QString &beta);
+    Q_INVOKABLE void putWindowToFront(const QString &id);
+
+    /**
+     * @param surface handle of the surface, @see internSurface
+     * @param view one of WindowRegistry::View values
+     * @return ids of the windows on the surface in their order
+     */
+    Q_INVOKABLE QStringList windowsOn(int surface, int view);
+
+    /**
+     * Mark the window as the most recently focused one
+     */
+    Q_INVOKABLE void setWindowFocused(const QString &id);
+
+    /**
+     * Find the closest tiled window in the direction from the given area.
+     * The geometries of the tiles are the ones, last passed to filterCommits.
+     * @param surface handle of the surface, @see internSurface
+     * @param basis the area to look from, usually the geometry of the current window
+     * @param direction one of "up", "down", "left", "right"
+     * @return id of the window or an empty string if there is none
+     */
+    Q_INVOKABLE QString neighborWindow(int surface, const QRectF &basis, const QString &direction);
+
+    /**
+     * Start an interactive move of the window. The last commit of the
+     * window is forgotten, as it is moved not by us.
+     */
+    Q_INVOKABLE void beginDrag(const QString &windowId);
+
+    /**
+     * Finish the interactive move. The drop zones are the layout geometries
+     * of the visible tiles on the surface, where the window is dropped.
+     * @param surface handle of the surface, that the window is dropped on
+     * @return id of the tile, that contains the center of the dropped window,
+     * or an empty string, if there is none or several tiles overlap there
+     */
+    Q_INVOKABLE QString endDrag(int x, int y, int surface);
+
+    /**
+     * Intern the name or the detail of the trace spans. Called once, when the
+     * span is set up, so that the spans are recorded without the strings.
+     * @return id of the string, that is passed to traceEnd
+     */
+    Q_INVOKABLE int traceName(const QString &name);
+
+    /**
+     * Begin a trace span in the TypeScript code
+     * @return timestamp of the span beginning, that must be passed to traceEnd
+     */
+    Q_INVOKABLE double traceBegin() const;
+
+    /**
+     * Record the trace span, that began at @p start and ends now
+     * @param name id of the span name, e.g. "arrange", @see traceName
+     * @param detail optional id of the span detail, e.g. the surface id, or -1
+     */
+    Q_INVOKABLE void traceEnd(int name, double start, int detail = -1);
+
+    /**
+     * Record the trace spans of the surface arrangement, and count its
+     * duration for the layout. In a batch the other surfaces are laid out
+     * between the layout and the commit of the surface, so only the time
+     * of the two own parts is counted. The commit ends now.
+     * @param surfaceTraceId id of the surface in the trace spans, @see SurfaceInfo
+     * @param layoutId id of the current layout of the surface
+     */
+    Q_INVOKABLE void arrangeEnd(int surfaceTraceId, const QString &layoutId, double layoutStart, double layoutEnd, double commitStart);
+
+    /**
+     * @return the counters of the tiling pipeline with the number of the
+     * managed windows on every surface and the sent and skipped commits
+     * @see Metrics::toJson
+     */
+    QJsonObject metrics();
+
+    /**
+     * Start counting the metrics from zero
+     */
+    void resetMetrics();
+
+    /**
+     * Set the state, that was saved by the previous instance of the script
+     */
+    void setRestoredState(std::optional<StateSnapshot>);
+
+    /**
+     * Restore the saved window order in the window registry and the saved
+     * layouts in the layout state store. Must be called once, after the
+     * existing windows are added and before the first arrangement. The saved
+     * state is dropped afterwards.
+     */
+    Q_INVOKABLE void restoreState();
+
+    /**
+     * @param surface handle of the surface, @see internSurface
+     * @return id of the current layout of the surface, @see LayoutStateStore
+     */
+    Q_INVOKABLE QString currentLayout(int surface);
+
+    /**
+     * Switch the surface to the next or the previous enabled layout
+     * @param step 1 or -1
+     * @return id of the new current layout
+     */
+    Q_INVOKABLE QString cycleLayout(int surface, int step);
+
+    /**
+     * Switch the surface to the layout or back to the previous one
+     * @return id of the new current layout
+     */
+    Q_INVOKABLE QString toggleLayout(int surface, const QString &layoutId);
+
+    /**
+     * @return parameters of the layout on the surface, the ones returned by
+     * its saveState, or an empty array, if they were never stored
+     */
+    Q_INVOKABLE QVariantList layoutValues(int surface, const QString &layoutId);
+
+    /**
+     * Remember the parameters of the layout on the surface
+     * @param values array of numbers, returned by saveState of the layout
+     */
+    Q_INVOKABLE void storeLayoutValues(int surface, const QString &layoutId, const QJSValue &values);
+
+    /**
+     * Ask the script to store the parameters of the layouts, that are not
+     * in the layout state store yet
      */
-    Q_INVOKABLE void log(const QJSValue &);
+    void requestLayoutState();
+
+    /**
+     * @return the state of the layouts and the current window order
+     */
+    StateSnapshot stateSnapshot() const;
+
+    /**
+     * Start recording the events into the event trace at @p path
+     * @return whether the trace file was opened
+     * @see EventRecorder
+     */
+    bool startRecording(const QString &path);
+
+    /**
+     * @return path of the written event trace or an empty string, if nothing was recorded
+     */
+    QString stopRecording();
+
+    bool recording() const;
+
+    /**
+     * Write the state of the workspace, that the recorded events start from
+     * @param workspace object with the numScreens, desktops, currentDesktop,
+     * activeScreen and currentActivity properties of the KWin workspace,
+     * activities array of {id, name} objects, areas array of {screen,
+     * desktop, area} objects and clients array of the KWin clients
+     */
+    Q_INVOKABLE void recordWorkspace(const QJSValue &workspace);
+
+    /**
+     * Record the event, that the script has received from KWin
+     * @param type one of TraceEvent::Type values
+     * @param client KWin client or null for the workspace events
+     * @param value argument of the workspace signal, @see EventRecorder::recordEvent
+     */
+    Q_INVOKABLE void recordEvent(int type, const QJSValue &client, const QJSValue &value = QJSValue());
+
+Q_SIGNALS:
+    /**
+     * Emitted when the configuration was changed
+     */
+    void configChanged();
+
+    /**
+     * Emitted when the scheduled arrangement should be done
+     * @see ArrangeScheduler::arrangeRequested
+     */
+    void arrangeRequested(const QList<int> &surfaces, bool allSurfaces);
+
+    /**
+     * Emitted, when the parameters of the layouts should be passed to storeLayoutValues
+     */
+    void layoutStateRequested();
+
+    /**
+     * Emitted, when the recording of the events starts or stops
+     */
+    void recordingChanged();
 
 private:
+    QJSValue createJSConfig() const;
+    Bismuth::Action action(const QJSValue &tsAction);
+    static QString formatFields(const QJSValue &);
+    static WindowProperties windowProperties(const QJSValue &);
+    static WindowCommit windowCommit(const QJSValue &);
+    static LayoutParameters layoutParameters(const Layout &, const QJSValue &parameters);
+    static std::vector<qreal> tileWeights(const QJSValue &weights);
+    static QByteArray flatGeometries(const GeometryBuffer &);
+    QJSValue surfaceValue(const SurfaceRegistry::Surface &) const;
+
     QQmlEngine *m_engine;
-    Bismuth::Config &m_config;
+    std::shared_ptr<const ConfigSnapshot> m_config;
+    QJSValue m_jsConfig; ///< Cached result of createJSConfig for the current snapshot
+    int m_configChanges; ///< Changes of the current snapshot since the previous one
+    WindowRules m_windowRules;
+    CommitTable m_commitTable;
+    EchoTracker m_echoTracker;
+    WindowRegistry m_windowRegistry;
+    SurfaceRegistry m_surfaceRegistry;
+    GeometryBuffer m_geometryBuffer; ///< Reused by every applyLayout call
+    std::vector<GeometryBuffer> m_geometryBuffers; ///< Reused by every applyLayouts call
+    std::optional<StateSnapshot> m_restoredState; ///< Saved by the previous instance, until restoreState is called
+    LayoutStateStore m_layoutStore;
+    DragTracker m_dragTracker;
+    EventRecorder m_recorder;
+    mutable Metrics m_metrics; ///< Counted also by the const bridge calls
     Bismuth::Controller &m_controller;
+    Bismuth::Engine &m_nativeEngine;
+    Bismuth::ArrangeScheduler &m_arrangeScheduler;
+    Bismuth::Tracer &m_tracer;
+    int m_layoutSpanName; ///< Interned names of the native spans
+    int m_shortcutSpanName;
+    int m_arrangeSpanName;
 };
 
 }
@@ -0,0 +1,299 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include "window-registry.hpp"
+
+#include <algorithm>
+#include <functional>
+
+namespace Bismuth
+{
+
+bool SurfaceKey::operator==(const SurfaceKey &rhs) const
+{
+    return screen == rhs.screen && desktop == rhs.desktop && activity == rhs.activity;
+}
+
+std::size_t SurfaceKeyHash::operator()(const SurfaceKey &key) const
+{
+    auto result = std::hash<QString>()(key.activity);
+    result ^= std::hash<int>()(key.screen) + 0x9e3779b9 + (result << 6) + (result >> 2);
+    result ^= std::hash<int>()(key.desktop) + 0x9e3779b9 + (result << 6) + (result >> 2);
+    return result;
+}
+
+void WindowRegistry::add(const QString &id, const WindowProperties &properties, bool front)
+{
+    if (m_index.count(id) > 0) {
+        update(id, properties);
+        return;
+    }
+
+    auto &list = m_screens[properties.screen];
+    auto position = list.insert(front ? list.begin() : list.end(), {id, properties, QRect(), 0});
+    m_index.emplace(id, position);
+
+    invalidate(properties.screen);
+}
+
+void WindowRegistry::remove(const QString &id)
+{
+    auto it = m_index.find(id);
+    if (it == m_index.end()) {
+        return;
+    }
+
+    const auto screen = it->second->properties.screen;
+    m_screens[screen].erase(it->second);
+    m_index.erase(it);
+
+    invalidate(screen);
+}
+
+void WindowRegistry::update(const QString &id, const WindowProperties &properties)
+{
+    auto it = m_index.find(id);
+    if (it == m_index.end()) {
+        return;
+    }
+
+    auto &entry = *it->second;
+    const auto oldScreen = entry.properties.screen;
+    entry.properties = properties;
+
+    if (oldScreen != properties.screen) {
+        auto &newList = m_screens[properties.screen];
+        newList.splice(newList.end(), m_screens[oldScreen], it->second);
+        invalidate(oldScreen);
+    }
+
+    invalidate(properties.screen);
+}
+
+void WindowRegistry::move(const QString &source, const QString &destination, bool after)
+{
+    auto sourceIt = m_index.find(source);
+    auto destinationIt = m_index.find(destination);
+    if (sourceIt == m_index.end() || destinationIt == m_index.end() || sourceIt == destinationIt) {
+        return;
+    }
+
+    const auto screen = sourceIt->second->properties.screen;
+    if (destinationIt->second->properties.screen != screen) {
+        return;
+    }
+
+    // Splicing within the same list keeps all the iterators valid
+    auto &list = m_screens[screen];
+    list.splice(after ? std::next(destinationIt->second) : destinationIt->second, list, sourceIt->second);
+
+    invalidate(screen);
+}
+
+void WindowRegistry::swap(const QString &alpha, const QString &beta)
+{
+    auto alphaIt = m_index.find(alpha);
+    auto betaIt = m_index.find(beta);
+    if (alphaIt == m_index.end() || betaIt == m_index.end() || alphaIt == betaIt) {
+        return;
+    }
+
+    const auto screen = alphaIt->second->properties.screen;
+    if (betaIt->second->properties.screen != screen) {
+        return;
+    }
+
+    // Exchange the list nodes' contents, and then the index entries, pointing to them
+    std::swap(*alphaIt->second, *betaIt->second);
+    std::swap(alphaIt->second, betaIt->second);
+
+    invalidate(screen);
+}
+
+void WindowRegistry::putToFront(const QString &id)
+{
+    auto it = m_index.find(id);
+    if (it == m_index.end()) {
+        return;
+    }
+
+    const auto screen = it->second->properties.screen;
+    auto &list = m_screens[screen];
+    list.splice(list.begin(), list, it->second);
+
+    invalidate(screen);
+}
+
+std::vector<QString> WindowRegistry::order() const
+{
+    auto screens = std::vector<int>();
+    screens.reserve(m_screens.size());
+    for (auto &[screen, list] : m_screens) {
+        screens.push_back(screen);
+    }
+    std::sort(screens.begin(), screens.end());
+
+    auto result = std::vector<QString>();
+    result.reserve(m_index.size());
+    for (auto screen : screens) {
+        for (auto &entry : m_screens.at(screen)) {
+            result.push_back(entry.id);
+        }
+    }
+    return result;
+}
+
+void WindowRegistry::restoreOrder(const std::vector<QString> &order)
+{
+    auto ranks = std::unordered_map<QString, std::size_t>();
+    ranks.reserve(order.size());
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        ranks.emplace(order[i], i);
+    }
+
+    auto rank = [&ranks](const Entry &entry) {
+        auto it = ranks.find(entry.id);
+        return it != ranks.end() ? it->second : ranks.size();
+    };
+
+    // The sort is stable and relinks the nodes, so the index stays valid
+    for (auto &[screen, list] : m_screens) {
+        list.sort([&rank](const Entry &lhs, const Entry &rhs) {
+            return rank(lhs) < rank(rhs);
+        });
+        invalidate(screen);
+    }
+}
+
+void WindowRegistry::setGeometry(const QString &id, const QRect &geometry)
+{
+    auto it = m_index.find(id);
+    if (it == m_index.end() || it->second->geometry == geometry) {
+        return;
+    }
+
+    it->second->geometry = geometry;
+
+    // The views do not depend on the geometry, only the indices of the tiles do
+    const auto &properties = it->second->properties;
+    for (auto &[surfaceKey, surface] : m_surfaces) {
+        if (surface.tiles && isOn(properties, surfaceKey)) {
+            surface.tiles.reset();
+        }
+    }
+}
+
+QRect WindowRegistry::geometry(const QString &id) const
+{
+    auto it = m_index.find(id);
+    return it != m_index.end() ? it->second->geometry : QRect();
+}
+
+void WindowRegistry::setFocused(const QString &id)
+{
+    auto it = m_index.find(id);
+    if (it == m_index.end()) {
+        return;
+    }
+
+    // The order of the tiles does not depend on the focus, so nothing is invalidated
+    it->second->focusSequence = ++m_focusCounter;
+}
+
+const std::vector<QString> &WindowRegistry::windowsOn(const SurfaceKey &surfaceKey, View view)
+{
+    return surface(surfaceKey).views[static_cast<std::size_t>(view)];
+}
+
+QString WindowRegistry::neighbor(const SurfaceKey &surfaceKey, const QRect &basis, SpatialIndex::Direction direction)
+{
+    auto &cached = surface(surfaceKey);
+    const auto &tiles = cached.views[static_cast<std::size_t>(View::VisibleTiled)];
+
+    if (!cached.tiles) {
+        auto geometries = std::vector<QRect>();
+        geometries.reserve(tiles.size());
+        for (const auto &id : tiles) {
+            geometries.push_back(m_index.at(id)->geometry);
+        }
+        cached.tiles.emplace(std::move(geometries));
+    }
+
+    auto tile = cached.tiles->neighbor(basis, direction, [this, &tiles](int tile) {
+        return m_index.at(tiles[tile])->focusSequence;
+    });
+
+    return tile >= 0 ? tiles[tile] : QString();
+}
+
+bool WindowRegistry::isOn(const WindowProperties &properties, const SurfaceKey &surface)
+{
+    return properties.screen == surface.screen && (properties.desktop == -1 || properties.desktop == surface.desktop)
+        && (properties.activities.isEmpty() || properties.activities.contains(surface.activity));
+}
+
+void WindowRegistry::invalidate(int screen)
+{
+    for (auto it = m_surfaces.begin(); it != m_surfaces.end();) {
+        if (it->first.screen == screen) {
+            it = m_surfaces.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+WindowRegistry::Surface &WindowRegistry::surface(const SurfaceKey &surfaceKey)
+{
+    auto it = m_surfaces.find(surfaceKey);
+    if (it == m_surfaces.end()) {
+        it = m_surfaces.emplace(surfaceKey, computeSurface(surfaceKey)).first;
+    }
+
+    return it->second;
+}
+
+WindowRegistry::Surface WindowRegistry::computeSurface(const SurfaceKey &surface) const
+{
+    auto result = Surface();
+    auto &views = result.views;
+
+    auto list = m_screens.find(surface.screen);
+    if (list == m_screens.end()) {
+        return result;
+    }
+
+    auto &all = views[static_cast<std::size_t>(View::All)];
+    auto &visible = views[static_cast<std::size_t>(View::Visible)];
+    auto &visibleTileable = views[static_cast<std::size_t>(View::VisibleTileable)];
+    auto &visibleTiled = views[static_cast<std::size_t>(View::VisibleTiled)];
+    auto &tileable = views[static_cast<std::size_t>(View::Tileable)];
+
+    for (auto &entry : list->second) {
+        const auto &properties = entry.properties;
+        if (!isOn(properties, surface)) {
+            continue;
+        }
+
+        all.push_back(entry.id);
+        if (properties.tileable) {
+            tileable.push_back(entry.id);
+        }
+
+        if (properties.minimized) {
+            continue;
+        }
+
+        visible.push_back(entry.id);
+        if (properties.tileable) {
+            visibleTileable.push_back(entry.id);
+        }
+        if (properties.tiled) {
+            visibleTiled.push_back(entry.id);
+        }
+    }
+
+    return result;
+}
+
+}
@@ -0,0 +1,168 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <QRect>
+#include <QString>
+#include <QStringList>
+
+#include <array>
+#include <list>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "spatial-index.hpp"
+
+namespace Bismuth
+{
+
+/**
+ * Properties of a window, that define where it is visible and whether it is tiled
+ */
+struct WindowProperties {
+    int screen = 0;
+    int desktop = -1; ///< -1 if the window is on all desktops
+    QStringList activities{}; ///< Empty if the window is on all activities
+    bool minimized = false;
+    bool tileable = false;
+    bool tiled = false;
+};
+
+/**
+ * Location of a surface: a screen on a virtual desktop in an activity
+ */
+struct SurfaceKey {
+    int screen = 0;
+    int desktop = 0;
+    QString activity{};
+
+    bool operator==(const SurfaceKey &rhs) const;
+};
+
+struct SurfaceKeyHash {
+    std::size_t operator()(const SurfaceKey &key) const;
+};
+
+/**
+ * Ordered storage of the managed windows.
+ *
+ * The windows are kept in a separate ordered list for every screen, so that
+ * reordering is done in constant time. The lists of windows on a surface and
+ * the spatial index of its tiles are computed once and cached until a window
+ * of the same screen changes. A new geometry drops only the spatial index.
+ */
+class WindowRegistry
+{
+public:
+    enum class View {
+        All, ///< All windows on the surface, including minimized
+        Visible, ///< Windows, that are not minimized
+        VisibleTileable, ///< Visible windows in one of the tileable states
+        VisibleTiled, ///< Visible windows in one of the tiled states
+        Tileable, ///< Tileable windows, including minimized
+    };
+
+    /**
+     * Add the window to the beginning or to the end of its screen list
+     */
+    void add(const QString &id, const WindowProperties &properties, bool front = false);
+    void remove(const QString &id);
+
+    /**
+     * Update the window properties. If the screen changes, the window goes
+     * to the end of the new screen list.
+     */
+    void update(const QString &id, const WindowProperties &properties);
+
+    /**
+     * Move @p source window before or after the @p destination one.
+     * Windows on different screens are not reordered.
+     */
+    void move(const QString &source, const QString &destination, bool after);
+
+    /**
+     * Exchange positions of the windows. Windows on different screens are not reordered.
+     */
+    void swap(const QString &alpha, const QString &beta);
+
+    /**
+     * Move the window to the beginning of its screen list
+     */
+    void putToFront(const QString &id);
+
+    /**
+     * @return ids of all the windows, screen by screen, in their order
+     */
+    std::vector<QString> order() const;
+
+    /**
+     * Reorder the windows as in the given list, e.g. the one saved by order().
+     * Windows, that are not in the list, go after the listed ones of the same
+     * screen and keep their relative order.
+     */
+    void restoreOrder(const std::vector<QString> &order);
+
+    /**
+     * Set the geometry, assigned to the window by the layout. Only the
+     * spatial indices of the surfaces with the window are rebuilt.
+     */
+    void setGeometry(const QString &id, const QRect &geometry);
+
+    /**
+     * @return the geometry, assigned to the window by the layout, or an empty
+     * rectangle, if there is no such window
+     */
+    QRect geometry(const QString &id) const;
+
+    /**
+     * Mark the window as the most recently focused one
+     */
+    void setFocused(const QString &id);
+
+    /**
+     * @return ids of the windows on the surface in their order
+     */
+    const std::vector<QString> &windowsOn(const SurfaceKey &surface, View view);
+
+    /**
+     * Find the closest tiled window in the direction from the given area.
+     * The most recently focused one wins among the equally close windows.
+     * @return id of the window or an empty string if there is none
+     */
+    QString neighbor(const SurfaceKey &surface, const QRect &basis, SpatialIndex::Direction direction);
+
+private:
+    struct Entry {
+        QString id;
+        WindowProperties properties;
+        QRect geometry{};
+        quint64 focusSequence = 0; ///< The greater, the more recently the window was focused
+    };
+    using List = std::list<Entry>;
+
+    static constexpr std::size_t viewCount = 5;
+
+    /**
+     * Cached data of one surface
+     */
+    struct Surface {
+        std::array<std::vector<QString>, viewCount> views;
+        std::optional<SpatialIndex> tiles; ///< Index of the windows in the VisibleTiled view
+    };
+
+    static bool isOn(const WindowProperties &, const SurfaceKey &);
+
+    void invalidate(int screen);
+    Surface &surface(const SurfaceKey &);
+    Surface computeSurface(const SurfaceKey &) const;
+
+    std::unordered_map<int, List> m_screens; ///< Windows of every screen in their order
+    std::unordered_map<QString, List::iterator> m_index; ///< Position of every window in its screen list
+    std::unordered_map<SurfaceKey, Surface, SurfaceKeyHash> m_surfaces; ///< Cached data of the surfaces
+    quint64 m_focusCounter = 0;
+};
+
+}
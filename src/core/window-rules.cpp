@@ -0,0 +1,191 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include "window-rules.hpp"
+
+#include <algorithm>
+#include <deque>
+
+namespace Bismuth
+{
+
+namespace
+{
+/**
+ * Number of the cached class combinations. The roles of some applications
+ * are unique per window, so the cache is dropped, when it grows this large.
+ */
+constexpr std::size_t classCacheLimit = 256;
+
+/**
+ * Parts of the desktop shell, that must never be tiled
+ */
+bool isShellClass(const QString &resourceClass)
+{
+    return resourceClass == QStringLiteral("plasmashell") || resourceClass == QStringLiteral("ksmserver")
+        || resourceClass == QStringLiteral("org.kde.plasmashell") || resourceClass == QStringLiteral("krunner") || resourceClass == QStringLiteral("kded5");
+}
+}
+
+SubstringMatcher::SubstringMatcher()
+    : m_nodes(1)
+    , m_allTags(0)
+{
+}
+
+void SubstringMatcher::addPattern(const QString &pattern, int tag)
+{
+    auto node = 0;
+    const auto data = pattern.utf16();
+    for (auto i = 0; i < pattern.size(); ++i) {
+        const auto character = data[i];
+        auto next = child(node, character);
+        if (next < 0) {
+            next = static_cast<int>(m_nodes.size());
+            auto &edges = m_nodes[node].next;
+            auto position = std::lower_bound(edges.begin(), edges.end(), std::make_pair(character, 0));
+            edges.insert(position, {character, next});
+            m_nodes.emplace_back();
+        }
+        node = next;
+    }
+
+    m_nodes[node].tags |= tag;
+    m_allTags |= tag;
+}
+
+void SubstringMatcher::build()
+{
+    // Breadth-first, so that the fallback of every node is computed before its children
+    std::deque<int> queue;
+    for (const auto &edge : m_nodes[0].next) {
+        m_nodes[edge.second].fail = 0;
+        queue.push_back(edge.second);
+    }
+
+    while (!queue.empty()) {
+        const auto node = queue.front();
+        queue.pop_front();
+
+        for (const auto &edge : m_nodes[node].next) {
+            auto fallback = m_nodes[node].fail;
+            while (fallback != 0 && child(fallback, edge.first) < 0) {
+                fallback = m_nodes[fallback].fail;
+            }
+
+            const auto target = child(fallback, edge.first);
+            m_nodes[edge.second].fail = (target >= 0 && target != edge.second) ? target : 0;
+            m_nodes[edge.second].tags |= m_nodes[m_nodes[edge.second].fail].tags;
+
+            queue.push_back(edge.second);
+        }
+    }
+}
+
+int SubstringMatcher::match(const QString &text) const
+{
+    // Empty pattern matches everything, just like String.indexOf does
+    auto tags = m_nodes[0].tags;
+    if (m_nodes.size() == 1 || tags == m_allTags) {
+        return tags;
+    }
+
+    auto node = 0;
+    const auto data = text.utf16();
+    for (auto i = 0; i < text.size(); ++i) {
+        const auto character = data[i];
+        auto next = child(node, character);
+        while (next < 0 && node != 0) {
+            node = m_nodes[node].fail;
+            next = child(node, character);
+        }
+        node = next < 0 ? 0 : next;
+
+        tags |= m_nodes[node].tags;
+        if (tags == m_allTags) {
+            break;
+        }
+    }
+
+    return tags;
+}
+
+int SubstringMatcher::child(int node, ushort character) const
+{
+    const auto &edges = m_nodes[node].next;
+    auto position = std::lower_bound(edges.begin(), edges.end(), std::make_pair(character, 0));
+    if (position != edges.end() && position->first == character) {
+        return position->second;
+    }
+    return -1;
+}
+
+WindowRules::WindowRules(std::shared_ptr<const ConfigSnapshot> config)
+{
+    setConfig(std::move(config));
+}
+
+void WindowRules::setConfig(std::shared_ptr<const ConfigSnapshot> config)
+{
+    m_ignoreClasses = {config->ignoreClass.cbegin(), config->ignoreClass.cend()};
+    m_floatingClasses = {config->floatingClass.cbegin(), config->floatingClass.cend()};
+    m_ignoreRoles = {config->ignoreRole.cbegin(), config->ignoreRole.cend()};
+    m_ignoreActivities = {config->ignoreActivity.cbegin(), config->ignoreActivity.cend()};
+    m_ignoreScreens = {config->ignoreScreen.cbegin(), config->ignoreScreen.cend()};
+
+    m_titleMatcher = SubstringMatcher();
+    for (const auto &title : config->ignoreTitle) {
+        m_titleMatcher.addPattern(title, Ignore);
+    }
+    for (const auto &title : config->floatingTitle) {
+        m_titleMatcher.addPattern(title, Float);
+    }
+    m_titleMatcher.build();
+
+    m_classCache.clear();
+}
+
+int WindowRules::classify(const QString &resourceClass, const QString &resourceName, const QString &windowRole, const QString &caption) const
+{
+    auto flags = classifyByClass(resourceClass, resourceName, windowRole);
+
+    // The title is checked only if it could change the result
+    if (!(flags & Ignore)) {
+        flags |= m_titleMatcher.match(caption);
+    }
+
+    return (flags & (Ignore | Float)) ? flags : Tile;
+}
+
+bool WindowRules::ignoresSurface(const QString &activityName, int screen) const
+{
+    return m_ignoreActivities.count(activityName) > 0 || m_ignoreScreens.count(screen) > 0;
+}
+
+int WindowRules::classifyByClass(const QString &resourceClass, const QString &resourceName, const QString &windowRole) const
+{
+    // Null character can not be a part of any of the keys
+    const auto key = resourceClass + QChar() + resourceName + QChar() + windowRole;
+
+    auto cached = m_classCache.find(key);
+    if (cached != m_classCache.end()) {
+        return cached->second;
+    }
+
+    auto flags = 0;
+    if (isShellClass(resourceClass) || m_ignoreClasses.count(resourceClass) > 0 || m_ignoreClasses.count(resourceName) > 0
+        || m_ignoreRoles.count(windowRole) > 0) {
+        flags |= Ignore;
+    }
+    if (m_floatingClasses.count(resourceClass) > 0 || m_floatingClasses.count(resourceName) > 0) {
+        flags |= Float;
+    }
+
+    if (m_classCache.size() >= classCacheLimit) {
+        m_classCache.clear();
+    }
+    m_classCache.emplace(key, flags);
+    return flags;
+}
+
+}
@@ -0,0 +1,105 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <QString>
+
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "config-snapshot.hpp"
+
+namespace Bismuth
+{
+
+/**
+ * Finds any of the patterns in a text in a single pass (Aho-Corasick).
+ *
+ * Every pattern has a tag. The match result is the bitwise OR of the tags
+ * of all the patterns, that occur in the text.
+ */
+class SubstringMatcher
+{
+public:
+    SubstringMatcher();
+
+    /**
+     * Add a pattern to the matcher. build() must be called afterwards.
+     */
+    void addPattern(const QString &pattern, int tag);
+
+    /**
+     * Compute the fallback transitions. Must be called after all the patterns are added.
+     */
+    void build();
+
+    /**
+     * @return tags of all the patterns, that are substrings of @p text
+     */
+    int match(const QString &text) const;
+
+private:
+    struct Node {
+        std::vector<std::pair<ushort, int>> next; ///< Transitions, sorted by character
+        int fail = 0; ///< Longest proper suffix, that is also in the trie
+        int tags = 0; ///< Tags of the patterns, that end in this node or its suffixes
+    };
+
+    int child(int node, ushort character) const;
+
+    std::vector<Node> m_nodes;
+    int m_allTags;
+};
+
+/**
+ * Compiled window rules from the configuration.
+ *
+ * Class and role lists are stored in hash sets, title substrings are
+ * compiled into one matcher. The result for every combination of the
+ * resource class, name and role is cached, as there are usually many
+ * windows of the same application.
+ */
+class WindowRules
+{
+public:
+    enum Flag {
+        Tile = 0x1, ///< No rule applies to the window
+        Float = 0x2, ///< The window should be floating
+        Ignore = 0x4, ///< The window should not be managed at all
+    };
+
+    explicit WindowRules(std::shared_ptr<const ConfigSnapshot> config);
+
+    /**
+     * Recompile the rules. Drops the cache.
+     */
+    void setConfig(std::shared_ptr<const ConfigSnapshot> config);
+
+    /**
+     * @return a combination of Flag values, that apply to the window
+     */
+    int classify(const QString &resourceClass, const QString &resourceName, const QString &windowRole, const QString &caption) const;
+
+    /**
+     * @return whether the windows on the given activity and screen should not be tiled
+     */
+    bool ignoresSurface(const QString &activityName, int screen) const;
+
+private:
+    int classifyByClass(const QString &resourceClass, const QString &resourceName, const QString &windowRole) const;
+
+    std::unordered_set<QString> m_ignoreClasses;
+    std::unordered_set<QString> m_floatingClasses;
+    std::unordered_set<QString> m_ignoreRoles;
+    std::unordered_set<QString> m_ignoreActivities;
+    std::unordered_set<int> m_ignoreScreens;
+    SubstringMatcher m_titleMatcher;
+
+    mutable std::unordered_map<QString, int> m_classCache; ///< Flags by the class, name and role, bounded by the size
+};
+
+}
@@ -6,6 +6,7 @@
 
 #include "bismuth.h"
 #include "bismuth_config.h"
+#include "core_interface.h"
 #include "kwin_interface.h"
 
 #include <QDBusInterface>
@@ -21,6 +22,7 @@ K_PLUGIN_CLASS_WITH_JSON(BismuthSettings, "metadata.json")
 BismuthSettings::BismuthSettings(QObject *parent, const QVariantList &args)
     : KQuickAddons::ManagedConfigModule(parent, args)
     , m_config(new Bismuth::Config(this))
+    , m_scriptEnabled(m_config->bismuthEnabled())
 {
     KAboutData *aboutData = new KAboutData(QStringLiteral("kcm_bismuth"),
                                            i18nc("@title", "Window Tiling"),
@@ -35,6 +37,12 @@ BismuthSettings::BismuthSettings(QObject *parent, const QVariantList &args)
     setButtons(Help | Apply | Default);
 
     qmlRegisterAnonymousType<Bismuth::Config>("org.kde.bismuth.private", 1);
+
+    // Let the running script know, that the config has changed
+    const auto items = m_config->items();
+    for (auto item : items) {
+        item->setWriteFlags(KConfigBase::Notify);
+    }
 }
 
 Bismuth::Config *BismuthSettings::config() const
@@ -45,17 +53,33 @@ Bismuth::Config *BismuthSettings::config() const
 void BismuthSettings::save()
 {
     KQuickAddons::ManagedConfigModule::save();
-    reloadKWinScript();
+
+    if (m_config->bismuthEnabled() != m_scriptEnabled) {
+        m_scriptEnabled = m_config->bismuthEnabled();
+        toggleKWinScript(m_scriptEnabled);
+    } else if (m_scriptEnabled) {
+        applyConfig();
+    }
 }
 
-void BismuthSettings::reloadKWinScript() const
+void BismuthSettings::toggleKWinScript(bool enabled) const
 {
     OrgKdeKwinScriptingInterface kwinInterface(QStringLiteral("org.kde.KWin"), QStringLiteral("/Scripting"), QDBusConnection::sessionBus());
 
-    // Unload Bismuth, so that it can reload its configuration
-    kwinInterface.unloadScript(QStringLiteral("bismuth")).waitForFinished(); // Sync call
-    // Load unloaded scripts
-    kwinInterface.start(); // Async call
+    if (enabled) {
+        // Load the enabled scripts, that are not loaded yet
+        kwinInterface.start(); // Async call
+    } else {
+        kwinInterface.unloadScript(QStringLiteral("bismuth")); // Async call
+    }
+}
+
+void BismuthSettings::applyConfig() const
+{
+    OrgKdeBismuthCoreInterface coreInterface(QStringLiteral("org.kde.bismuth"), QStringLiteral("/Core"), QDBusConnection::sessionBus());
+
+    // The running script applies only the changed settings and keeps the windows where they are
+    coreInterface.reloadConfig(); // Async call
 }
 
 #include "bismuth.moc"
@@ -25,7 +25,16 @@ public Q_SLOTS:
     void save() override;
 
 private:
-    void reloadKWinScript() const;
+    /**
+     * Load or unload the KWin script, when the tiling is enabled or disabled
+     */
+    void toggleKWinScript(bool enabled) const;
+
+    /**
+     * Ask the running script to apply the saved configuration
+     */
+    void applyConfig() const;
 
     Bismuth::Config *m_config;
+    bool m_scriptEnabled; ///< Whether the script was enabled, when the config was last saved
 };
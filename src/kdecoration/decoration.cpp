@@ -5,11 +5,9 @@
 
 #include <QPainter>
 
-#include <KConfigGroup>
 #include <KDecoration2/DecoratedClient>
 #include <KDecoration2/DecorationSettings>
 #include <KPluginFactory>
-#include <KSharedConfig>
 
 K_PLUGIN_FACTORY_WITH_JSON(BismuthDecorationFactory, "metadata.json", registerPlugin<Bismuth::Decoration>();)
 
@@ -17,16 +15,21 @@ namespace Bismuth
 {
 Decoration::Decoration(QObject *parent, const QVariantList &args)
     : KDecoration2::Decoration(parent, args)
+    , m_active(false)
+    , m_palette()
+    , m_borderStrips()
+    , m_borderStripsRect()
+    , m_borderStripsMargins()
 {
 }
 
 void Decoration::init()
 {
-    m_kdeglobalsWatcher = KConfigWatcher::create(KSharedConfig::openConfig("kdeglobals"));
+    m_palette = Palette::instance();
+    m_active = client().lock()->isActive();
 
     setBorderSizes();
     connectEvents();
-    updateColors();
 }
 
 void Decoration::paint(QPainter *painter, const QRect &repaintRegion)
@@ -35,33 +38,51 @@ void Decoration::paint(QPainter *painter, const QRect &repaintRegion)
         return;
     }
 
-    paintBorders(*painter);
+    paintBorders(*painter, repaintRegion);
 }
 
-void Decoration::paintBorders(QPainter &p)
+void Decoration::paintBorders(QPainter &p, const QRect &repaintRegion)
 {
-    auto client = this->client().lock();
-    auto windowRect = rect();
+    const auto &brush = m_palette->brush(m_active);
 
-    p.save();
-    p.setPen(Qt::NoPen);
-
-    if (client->isActive()) {
-        p.setBrush(m_activeColor);
-    } else {
-        p.setBrush(m_inactiveColor);
+    // Nothing is painted, if only the client area is updated
+    for (auto &strip : borderStrips()) {
+        const auto area = strip.intersected(repaintRegion);
+        if (!area.isEmpty()) {
+            p.fillRect(area, brush);
+        }
     }
+}
 
-    p.drawRect(windowRect);
-    p.restore();
+void Decoration::updateBorders()
+{
+    for (auto &strip : borderStrips()) {
+        if (!strip.isEmpty()) {
+            update(strip);
+        }
+    }
 }
 
-void Decoration::updateColors()
+const std::array<QRect, 4> &Decoration::borderStrips()
 {
-    auto colorsConfig = KSharedConfig::openConfig("kdeglobals");
-    auto group = colorsConfig->group("Colors:Window");
-    m_activeColor = group.readEntry("DecorationFocus", QColor(255, 0, 0));
-    m_inactiveColor = group.readEntry("BackgroundNormal", QColor(0, 0, 0));
+    const auto windowRect = rect();
+    const auto margins = borders();
+    if (windowRect == m_borderStripsRect && margins == m_borderStripsMargins) {
+        return m_borderStrips;
+    }
+
+    // Side strips go between the top and the bottom ones, so that the strips do not overlap
+    const auto sideHeight = windowRect.height() - margins.top() - margins.bottom();
+    m_borderStrips = {
+        QRect(windowRect.left(), windowRect.top(), windowRect.width(), margins.top()),
+        QRect(windowRect.left(), windowRect.bottom() - margins.bottom() + 1, windowRect.width(), margins.bottom()),
+        QRect(windowRect.left(), windowRect.top() + margins.top(), margins.left(), sideHeight),
+        QRect(windowRect.right() - margins.right() + 1, windowRect.top() + margins.top(), margins.right(), sideHeight),
+    };
+    m_borderStripsRect = windowRect;
+    m_borderStripsMargins = margins;
+
+    return m_borderStrips;
 }
 
 void Decoration::setBorderSizes()
@@ -83,18 +104,12 @@ void Decoration::connectEvents()
 
     // No idea why regular connection does not work
     connect(clientPtr, &KDecoration2::DecoratedClient::activeChanged, this, [this](bool value) {
-        this->update();
+        m_active = value;
+        updateBorders();
     });
     connect(settingsPtr, &KDecoration2::DecorationSettings::borderSizeChanged, this, &Decoration::setBorderSizes);
 
-    connect(m_kdeglobalsWatcher.data(), &KConfigWatcher::configChanged, this, [this](const KConfigGroup &group, const QByteArrayList &names) {
-        if (group.name() == QStringLiteral("General")) {
-            if (names.contains(QByteArrayLiteral("ColorScheme")) || names.contains(QByteArrayLiteral("AccentColor"))) {
-                updateColors();
-                this->update();
-            }
-        }
-    });
+    connect(m_palette.get(), &Palette::changed, this, &Decoration::updateBorders);
 }
 
 int Decoration::borderSize() const
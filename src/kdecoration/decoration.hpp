@@ -3,11 +3,17 @@
 
 #pragma once
 
+#include <QMargins>
+#include <QRect>
 #include <QVariant>
 
-#include <KConfigWatcher>
 #include <KDecoration2/Decoration>
 
+#include <array>
+#include <memory>
+
+#include "palette.hpp"
+
 namespace Bismuth
 {
 class Decoration : public KDecoration2::Decoration
@@ -32,18 +38,33 @@ public Q_SLOTS:
     void init() override;
 
 private:
-    void paintBorders(QPainter &painter);
+    /**
+     * Paint the parts of the borders, that are inside the region
+     */
+    void paintBorders(QPainter &painter, const QRect &repaintRegion);
+
+    /**
+     * Schedule the repaint of the borders only, the client area is never painted
+     */
+    void updateBorders();
 
-    void updateColors();
     void setBorderSizes();
     void connectEvents();
 
     int borderSize() const;
 
-    QColor m_activeColor;
-    QColor m_inactiveColor;
+    /**
+     * @return top, bottom, left and right border strips. They are recomputed
+     * only when the size of the window or the borders change.
+     */
+    const std::array<QRect, 4> &borderStrips();
+
+    bool m_active; ///< Cached state of the client, so that it is not locked on every paint
+    std::shared_ptr<Palette> m_palette;
 
-    KConfigWatcher::Ptr m_kdeglobalsWatcher;
+    std::array<QRect, 4> m_borderStrips;
+    QRect m_borderStripsRect; ///< Window rect, the strips were computed for
+    QMargins m_borderStripsMargins; ///< Borders, the strips were computed for
 };
 
 }
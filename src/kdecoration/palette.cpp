@@ -0,0 +1,58 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include "palette.hpp"
+
+#include <QColor>
+
+#include <KConfigGroup>
+#include <KSharedConfig>
+
+namespace Bismuth
+{
+
+std::shared_ptr<Palette> Palette::instance()
+{
+    // Not owned here, so that the watcher goes away with the last decoration
+    static std::weak_ptr<Palette> s_instance;
+
+    auto result = s_instance.lock();
+    if (!result) {
+        result = std::shared_ptr<Palette>(new Palette());
+        s_instance = result;
+    }
+    return result;
+}
+
+Palette::Palette()
+    : QObject()
+    , m_kdeglobalsWatcher(KConfigWatcher::create(KSharedConfig::openConfig("kdeglobals")))
+    , m_activeBrush()
+    , m_inactiveBrush()
+{
+    readColors();
+
+    connect(m_kdeglobalsWatcher.data(), &KConfigWatcher::configChanged, this, [this](const KConfigGroup &group, const QByteArrayList &names) {
+        if (group.name() == QStringLiteral("General")) {
+            if (names.contains(QByteArrayLiteral("ColorScheme")) || names.contains(QByteArrayLiteral("AccentColor"))) {
+                readColors();
+                Q_EMIT changed();
+            }
+        }
+    });
+}
+
+const QBrush &Palette::brush(bool active) const
+{
+    return active ? m_activeBrush : m_inactiveBrush;
+}
+
+void Palette::readColors()
+{
+    auto colorsConfig = KSharedConfig::openConfig("kdeglobals");
+    auto group = colorsConfig->group("Colors:Window");
+    m_activeBrush = QBrush(group.readEntry("DecorationFocus", QColor(255, 0, 0)));
+    m_inactiveBrush = QBrush(group.readEntry("BackgroundNormal", QColor(0, 0, 0)));
+}
+
+}
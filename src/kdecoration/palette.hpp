@@ -0,0 +1,49 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <QBrush>
+#include <QObject>
+
+#include <KConfigWatcher>
+
+#include <memory>
+
+namespace Bismuth
+{
+
+/**
+ * Border colors, shared by all the decorations in the process.
+ *
+ * There is only one watcher of the color scheme, and the colors are parsed
+ * once per change, no matter how many windows are decorated.
+ */
+class Palette : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * @return the palette, that is alive while at least one decoration holds it
+     */
+    static std::shared_ptr<Palette> instance();
+
+    const QBrush &brush(bool active) const;
+
+Q_SIGNALS:
+    /**
+     * Emitted once after the colors are re-read, so that all the decorations repaint together
+     */
+    void changed();
+
+private:
+    Palette();
+
+    void readColors();
+
+    KConfigWatcher::Ptr m_kdeglobalsWatcher;
+    QBrush m_activeBrush;
+    QBrush m_inactiveBrush;
+};
+
+}
@@ -3,6 +3,17 @@
 //
 // SPDX-License-Identifier: MIT
 
+/**
+ * Groups of the changed settings. Must be in sync with the native ConfigSnapshot::Change.
+ */
+export enum ConfigChange {
+  Layouts = 0x1,
+  Arrangement = 0x2,
+  Rules = 0x4,
+  Surfaces = 0x8,
+  Behavior = 0x10,
+}
+
 export interface Config {
   experimentalBackend: boolean;
 
@@ -31,10 +31,17 @@ export interface Action {
    */
   readonly defaultKeybinding: string;
 
+  /**
+   * Whether the auto-repeats of the shortcut could be coalesced into one
+   * execution with the accumulated repeat count
+   */
+  readonly repeatable: boolean;
+
   /**
    * Execute action. This is basically a Command Design Pattern method.
+   * @param repeatCount number of the coalesced shortcut triggers
    */
-  execute(): void;
+  execute(repeatCount?: number): void;
 
   /**
    * Execute action, but ignoring any overrides in the process
@@ -47,6 +54,14 @@ export interface Action {
  * actions. Such as a template of action execution.
  */
 abstract class ActionImpl implements Action {
+  public readonly repeatable: boolean = false;
+
+  /**
+   * Repeat count of the current execution. Only repeatable actions get
+   * more than one.
+   */
+  protected repeatCount = 1;
+
   constructor(
     protected engine: Engine,
     public key: string,
@@ -60,15 +75,17 @@ abstract class ActionImpl implements Action {
    * defined in the layout and if not found executes the default
    * behavior.
    */
-  public execute(): void {
-    this.log.log(`Executing action: ${this.key}`);
+  public execute(repeatCount = 1): void {
+    this.log.debug("Executing action", () => ({ key: this.key, repeatCount }));
 
+    this.repeatCount = repeatCount;
     const currentLayout = this.engine.currentLayoutOnCurrentSurface();
     if (currentLayout.executeAction) {
       currentLayout.executeAction(this.engine, this);
     } else {
       this.executeWithoutLayoutOverride();
     }
+    this.repeatCount = 1;
 
     // TODO: Maybe it worth moving this into engine?
     this.engine.arrange();
@@ -185,6 +202,8 @@ export class MoveActiveWindowToPreviousPosition
 }
 
 export class MoveActiveWindowUp extends ActionImpl implements Action {
+  public readonly repeatable = true;
+
   constructor(protected engine: Engine, protected log: Log) {
     super(
       engine,
@@ -196,11 +215,13 @@ export class MoveActiveWindowUp extends ActionImpl implements Action {
   }
 
   public executeWithoutLayoutOverride(): void {
-    this.engine.swapDirOrMoveFloat("up");
+    this.engine.swapDirOrMoveFloat("up", this.repeatCount);
   }
 }
 
 export class MoveActiveWindowDown extends ActionImpl implements Action {
+  public readonly repeatable = true;
+
   constructor(protected engine: Engine, protected log: Log) {
     super(
       engine,
@@ -212,11 +233,13 @@ export class MoveActiveWindowDown extends ActionImpl implements Action {
   }
 
   public executeWithoutLayoutOverride(): void {
-    this.engine.swapDirOrMoveFloat("down");
+    this.engine.swapDirOrMoveFloat("down", this.repeatCount);
   }
 }
 
 export class MoveActiveWindowLeft extends ActionImpl implements Action {
+  public readonly repeatable = true;
+
   constructor(protected engine: Engine, protected log: Log) {
     super(
       engine,
@@ -228,11 +251,13 @@ export class MoveActiveWindowLeft extends ActionImpl implements Action {
   }
 
   public executeWithoutLayoutOverride(): void {
-    this.engine.swapDirOrMoveFloat("left");
+    this.engine.swapDirOrMoveFloat("left", this.repeatCount);
   }
 }
 
 export class MoveActiveWindowRight extends ActionImpl implements Action {
+  public readonly repeatable = true;
+
   constructor(protected engine: Engine, protected log: Log) {
     super(
       engine,
@@ -244,11 +269,13 @@ export class MoveActiveWindowRight extends ActionImpl implements Action {
   }
 
   public executeWithoutLayoutOverride(): void {
-    this.engine.swapDirOrMoveFloat("right");
+    this.engine.swapDirOrMoveFloat("right", this.repeatCount);
   }
 }
 
 export class IncreaseActiveWindowWidth extends ActionImpl implements Action {
+  public readonly repeatable = true;
+
   constructor(protected engine: Engine, protected log: Log) {
     super(
       engine,
@@ -262,12 +289,14 @@ export class IncreaseActiveWindowWidth extends ActionImpl implements Action {
   public executeWithoutLayoutOverride(): void {
     const win = this.engine.currentWindow();
     if (win) {
-      this.engine.resizeWindow(win, "east", 1);
+      this.engine.resizeWindow(win, "east", this.repeatCount);
     }
   }
 }
 
 export class IncreaseActiveWindowHeight extends ActionImpl implements Action {
+  public readonly repeatable = true;
+
   constructor(protected engine: Engine, protected log: Log) {
     super(
       engine,
@@ -281,12 +310,14 @@ export class IncreaseActiveWindowHeight extends ActionImpl implements Action {
   public executeWithoutLayoutOverride(): void {
     const win = this.engine.currentWindow();
     if (win) {
-      this.engine.resizeWindow(win, "south", 1);
+      this.engine.resizeWindow(win, "south", this.repeatCount);
     }
   }
 }
 
 export class DecreaseActiveWindowWidth extends ActionImpl implements Action {
+  public readonly repeatable = true;
+
   constructor(protected engine: Engine, protected log: Log) {
     super(
       engine,
@@ -300,12 +331,14 @@ export class DecreaseActiveWindowWidth extends ActionImpl implements Action {
   public executeWithoutLayoutOverride(): void {
     const win = this.engine.currentWindow();
     if (win) {
-      this.engine.resizeWindow(win, "east", -1);
+      this.engine.resizeWindow(win, "east", -this.repeatCount);
     }
   }
 }
 
 export class DecreaseActiveWindowHeight extends ActionImpl implements Action {
+  public readonly repeatable = true;
+
   constructor(protected engine: Engine, protected log: Log) {
     super(
       engine,
@@ -319,7 +352,7 @@ export class DecreaseActiveWindowHeight extends ActionImpl implements Action {
   public executeWithoutLayoutOverride(): void {
     const win = this.engine.currentWindow();
     if (win) {
-      this.engine.resizeWindow(win, "south", -1);
+      this.engine.resizeWindow(win, "south", -this.repeatCount);
     }
   }
 }
@@ -10,11 +10,12 @@ import { WindowState } from "../engine/window";
 import { Driver, DriverImpl } from "../driver";
 import { DriverSurface } from "../driver/surface";
 
-import { Config } from "../config";
+import { Config, ConfigChange } from "../config";
 import { Log } from "../util/log";
 
 import * as Action from "./action";
 import { TSProxy } from "../extern/proxy";
+import { NativeLayoutBatch } from "../engine/layout/native_layout_batch";
 
 /**
  * Entry point of the script (apart from QML). Handles the user input (shortcuts)
@@ -29,6 +30,18 @@ export interface Controller {
    * A bunch of surfaces, that represent the user's screens.
    */
   readonly screens: DriverSurface[];
+
+  /**
+   * Proxy to the native core. Used by the experimental backend.
+   */
+  readonly proxy: TSProxy;
+
+  /**
+   * Native layout requests, that are computed together, when several
+   * surfaces are arranged. Null, if every request is computed at once.
+   */
+  nativeLayoutBatch: NativeLayoutBatch | null;
+
   /**
    * Current active window. In other words the window, that has focus.
    */
@@ -52,6 +65,30 @@ export interface Controller {
    */
   onCurrentSurfaceChanged(): void;
 
+  /**
+   * Request the arrangement of the windows. Requests made while handling
+   * one batch of events are coalesced into one arrangement per surface.
+   * @param surface the surface to arrange. All visible surfaces if not specified.
+   */
+  scheduleArrange(surface?: DriverSurface): void;
+
+  /**
+   * Do the arrangement, that was requested with scheduleArrange
+   * @param surfaces handles of the surfaces to arrange
+   * @param allSurfaces whether all visible surfaces should be arranged
+   */
+  onArrangeRequested(surfaces: number[], allSurfaces: boolean): void;
+
+  /**
+   * React to configuration change, e.g. when the user has applied the settings
+   */
+  onConfigChanged(): void;
+
+  /**
+   * Pass the state of the layouts to the native side, so that it can be saved
+   */
+  onLayoutStateRequested(): void;
+
   /**
    * React to screen update. For example, when the new screen has connected.
    */
@@ -163,12 +200,13 @@ export interface Controller {
 export class ControllerImpl implements Controller {
   private engine: Engine;
   private driver: Driver;
+  public nativeLayoutBatch: NativeLayoutBatch | null = null;
   public constructor(
     qmlObjects: Bismuth.Qml.Main,
     kwinApi: KWin.Api,
     private config: Config,
     private log: Log,
-    private proxy: TSProxy
+    public readonly proxy: TSProxy
   ) {
     this.engine = new EngineImpl(this, config, log);
     this.driver = new DriverImpl(qmlObjects, kwinApi, this, config, log, proxy);
@@ -183,6 +221,9 @@ export class ControllerImpl implements Controller {
 
     this.driver.manageWindows();
 
+    // The state of the previous instance, so that nothing is rearranged twice
+    this.proxy.restoreState();
+
     this.engine.arrange();
   }
 
@@ -210,17 +251,68 @@ export class ControllerImpl implements Controller {
     this.driver.showNotification(text, icon, hint);
   }
 
+  public scheduleArrange(surface?: DriverSurface): void {
+    if (surface) {
+      this.proxy.scheduleArrange(surface.handle);
+    } else {
+      this.proxy.scheduleArrangeAll();
+    }
+  }
+
+  public onArrangeRequested(surfaces: number[], allSurfaces: boolean): void {
+    if (allSurfaces) {
+      this.engine.arrange();
+    } else {
+      this.engine.arrangeSurfaces(surfaces);
+    }
+  }
+
   public onSurfaceUpdate(): void {
-    this.engine.arrange();
+    this.scheduleArrange();
+  }
+
+  public onConfigChanged(): void {
+    const changes = this.proxy.configChanges;
+    this.log.debug("onConfigChanged", () => ({
+      gen: this.proxy.configGeneration,
+      changes,
+    }));
+    const keepFloatAbove = this.config.keepFloatAbove;
+    // Everyone holds the reference to the same config object, so update it in place
+    Object.assign(this.config, this.proxy.jsConfig());
+
+    // Schedules only the surfaces of the reclassified windows
+    if (changes & ConfigChange.Rules) {
+      this.driver.applyIgnoreRules();
+      this.engine.applyWindowRules();
+    }
+
+    if (this.config.keepFloatAbove !== keepFloatAbove) {
+      this.engine.applyFloatSettings();
+    }
+
+    // The behavior settings are read on the next user action, nothing has moved
+    if (
+      changes &
+      (ConfigChange.Layouts | ConfigChange.Arrangement | ConfigChange.Surfaces)
+    ) {
+      this.scheduleArrange();
+    }
+  }
+
+  public onLayoutStateRequested(): void {
+    this.engine.layouts.flush();
   }
 
   public onCurrentSurfaceChanged(): void {
-    this.log.log(["onCurrentSurfaceChanged", { srf: this.currentSurface }]);
-    this.engine.arrange();
+    this.log.debug("onCurrentSurfaceChanged", () => ({
+      srf: this.currentSurface,
+    }));
+    this.scheduleArrange();
   }
 
   public onWindowAdded(window: EngineWindow): void {
-    this.log.log(["onWindowAdded", { window }]);
+    this.log.debug("onWindowAdded", () => ({ window }));
     this.engine.manage(window);
 
     /* move window to next surface if the current surface is "full" */
@@ -238,55 +330,42 @@ export class ControllerImpl implements Controller {
       }
     }
 
-    this.engine.arrange();
+    this.scheduleArrange(window.surface);
   }
 
   public onWindowRemoved(window: EngineWindow): void {
-    this.log.log(`[Controller#onWindowRemoved] Window removed: ${window}`);
+    this.log.debug("onWindowRemoved", () => ({ window }));
 
     this.engine.unmanage(window);
 
     if (this.engine.isLayoutMonocleAndMinimizeRest()) {
       // Switch to the next window if needed
       if (!this.currentWindow) {
-        this.log.log(
-          `[Controller#onWindowRemoved] Switching to the minimized window`
-        );
+        this.log.debug("onWindowRemoved: switching to the minimized window");
         this.engine.focusOrder(1, true);
       }
     }
 
-    this.engine.arrange();
+    this.scheduleArrange(window.surface);
   }
 
-  public onWindowMoveStart(_window: EngineWindow): void {
-    /* do nothing */
+  public onWindowMoveStart(window: EngineWindow): void {
+    this.engine.windows.beginDrag(window);
   }
 
   public onWindowMove(_window: EngineWindow): void {
-    /* do nothing */
+    /* the drop target is resolved only, when the window is dropped */
   }
 
   public onWindowMoveOver(window: EngineWindow): void {
-    this.log.log(["onWindowMoveOver", { window }]);
+    this.log.debug("onWindowMoveOver", () => ({ window }));
 
     /* swap window by dragging */
-    if (window.state === WindowState.Tiled) {
-      const tiles = this.engine.windows.visibleTiledWindowsOn(
-        this.currentSurface
-      );
-      const windowCenter = window.actualGeometry.center;
-
-      const targets = tiles.filter(
-        (tile) =>
-          tile !== window && tile.actualGeometry.includesPoint(windowCenter)
-      );
-
-      if (targets.length === 1) {
-        this.engine.windows.swap(window, targets[0]);
-        this.engine.arrange();
-        return;
-      }
+    const target = this.engine.windows.endDrag(window);
+    if (window.state === WindowState.Tiled && target) {
+      this.engine.windows.swap(window, target);
+      this.scheduleArrange(this.currentSurface);
+      return;
     }
 
     /* ... or float window */
@@ -298,7 +377,7 @@ export class ControllerImpl implements Controller {
         if (distance > 30) {
           window.floatGeometry = window.actualGeometry;
           window.state = WindowState.Floating;
-          this.engine.arrange();
+          this.scheduleArrange(window.surface);
           this.engine.showNotification("Window Untiled");
           return;
         }
@@ -314,57 +393,59 @@ export class ControllerImpl implements Controller {
   }
 
   public onWindowResize(win: EngineWindow): void {
-    this.log.log(`[Controller#onWindowResize] Window is resizing: ${win}`);
+    this.log.debug("onWindowResize", () => ({ window: win }));
 
     if (win.state === WindowState.Tiled) {
       this.engine.adjustLayout(win);
-      this.engine.arrange();
+      this.scheduleArrange(win.surface);
     }
   }
 
   public onWindowResizeOver(win: EngineWindow): void {
-    this.log.log(
-      `[Controller#onWindowResizeOver] Window resize is over: ${win}`
-    );
+    this.log.debug("onWindowResizeOver", () => ({ window: win }));
 
     if (win.tiled) {
       this.engine.adjustLayout(win);
-      this.engine.arrange();
+      this.scheduleArrange(win.surface);
     }
   }
 
   public onWindowMaximizeChanged(
-    _window: EngineWindow,
+    window: EngineWindow,
     _maximized: boolean
   ): void {
-    this.engine.arrange();
+    window.refresh();
+    this.scheduleArrange(window.surface);
   }
 
   public onWindowGeometryChanged(window: EngineWindow): void {
-    this.log.log(["onWindowGeometryChanged", { window }]);
+    this.log.debug("onWindowGeometryChanged", () => ({ window }));
   }
 
-  public onWindowScreenChanged(_window: EngineWindow): void {
+  public onWindowScreenChanged(window: EngineWindow): void {
+    window.refresh();
     //TODO only arrange the surface the window came from and went to
-    this.engine.arrange();
+    this.scheduleArrange();
   }
 
   // NOTE: accepts `null` to simplify caller. This event is a catch-all hack
   // by itself anyway.
   public onWindowChanged(window: EngineWindow | null, comment?: string): void {
     if (window) {
-      this.log.log(["onWindowChanged", { window, comment }]);
+      this.log.debug("onWindowChanged", () => ({ window, comment }));
+      window.refresh();
 
       if (comment === "unminimized") {
         this.currentWindow = window;
       }
 
-      this.engine.arrange();
+      this.scheduleArrange(window.surface);
     }
   }
 
   public onWindowFocused(win: EngineWindow): void {
     win.timestamp = new Date().getTime();
+    this.proxy.setWindowFocused(win.id);
 
     // Minimize other windows if Monocle and config.monocleMinimizeRest
     if (this.engine.isLayoutMonocleAndMinimizeRest()) {
@@ -373,7 +454,7 @@ export class ControllerImpl implements Controller {
   }
 
   public onWindowShadeChanged(win: EngineWindow): void {
-    this.log.log(`onWindowShadeChanged, window: ${win}`);
+    this.log.debug("onWindowShadeChanged", () => ({ window: win }));
 
     // NOTE: Float shaded windows and change their state back once unshaded
     // For some reason shaded windows break our tiling geometry,
@@ -384,7 +465,7 @@ export class ControllerImpl implements Controller {
       win.state = win.statePreviouslyAskedToChangeTo;
     }
 
-    this.engine.arrange();
+    this.scheduleArrange(win.surface);
   }
 
   public manageWindow(win: EngineWindow): void {
@@ -440,8 +521,6 @@ export class ControllerImpl implements Controller {
       new Action.RotatePart(this.engine, this.log),
     ];
 
-    for (const action of allPossibleActions) {
-      this.proxy.registerShortcut(action);
-    }
+    this.proxy.registerShortcuts(allPossibleActions);
   }
 }
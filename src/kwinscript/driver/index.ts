@@ -5,7 +5,9 @@
 
 import { DriverSurface } from "./surface";
 import { DriverSurfaceImpl } from "./surface";
-import { DriverWindowImpl } from "./window";
+import { DriverSurfaceRegistry } from "./surface";
+import { DriverWindowImpl, EchoProperty } from "./window";
+import { RecordedEvent, snapshotWorkspace } from "./recorder";
 
 import { Controller } from "../controller";
 
@@ -13,7 +15,7 @@ import { EngineWindow, EngineWindowImpl } from "../engine/window";
 
 import { WindowState } from "../engine/window";
 
-import { Config } from "../config";
+import { Config, ConfigChange } from "../config";
 import { Log } from "../util/log";
 import { TSProxy } from "../extern/proxy";
 
@@ -55,6 +57,13 @@ export interface Driver {
    */
   manageWindows(): void;
 
+  /**
+   * Manage the windows, that are not ignored by the window rules anymore,
+   * and stop managing the windows, that are ignored now. Must be called,
+   * when the rules change.
+   */
+  applyIgnoreRules(): void;
+
   /**
    * Destroy all callbacks and other non-GC resources
    */
@@ -63,13 +72,10 @@ export interface Driver {
 
 export class DriverImpl implements Driver {
   public get currentSurface(): DriverSurface {
-    return new DriverSurfaceImpl(
+    return this.surfaces.get(
       this.kwinApi.workspace.activeScreen,
       this.kwinApi.workspace.currentActivity,
-      this.kwinApi.workspace.currentDesktop,
-      this.qml.activityInfo,
-      this.config,
-      this.kwinApi
+      this.kwinApi.workspace.currentDesktop
     );
   }
 
@@ -102,13 +108,10 @@ export class DriverImpl implements Driver {
     const screensArr = [];
     for (let screen = 0; screen < this.kwinApi.workspace.numScreens; screen++) {
       screensArr.push(
-        new DriverSurfaceImpl(
+        this.surfaces.get(
           screen,
           this.kwinApi.workspace.currentActivity,
-          this.kwinApi.workspace.currentDesktop,
-          this.qml.activityInfo,
-          this.config,
-          this.kwinApi
+          this.kwinApi.workspace.currentDesktop
         )
       );
     }
@@ -117,13 +120,26 @@ export class DriverImpl implements Driver {
 
   private controller: Controller;
   private windowMap: WrapperMap<KWin.Client, EngineWindow>;
+  private surfaces: DriverSurfaceRegistry;
   private entered: boolean;
+  private recording: boolean;
+
+  /**
+   * Interned name of the event trace spans
+   */
+  private readonly eventSpan: number;
 
   private qml: Bismuth.Qml.Main;
   private kwinApi: KWin.Api;
 
   private registeredConnections: SignalCallbackPair[];
 
+  /**
+   * Connections of the managed windows and of the docks by their ids, so
+   * that they are dropped, when a window stops being managed
+   */
+  private windowConnections: { [id: string]: SignalCallbackPair[] };
+
   /**
    * @param qmlObjects objects from QML gui. Required for the interaction with QML, as we cannot access globals.
    * @param kwinApi KWin scripting API. Required for interaction with KWin, as we cannot access globals.
@@ -138,48 +154,71 @@ export class DriverImpl implements Driver {
     private proxy: TSProxy
   ) {
     this.registeredConnections = [];
-
-    // TODO: find a better way to to this
-    if (this.config.preventMinimize && this.config.monocleMinimizeRest) {
-      log.log("preventMinimize is disabled because of monocleMinimizeRest");
-      this.config.preventMinimize = false;
-    }
+    this.windowConnections = {};
+    this.eventSpan = proxy.traceName("event");
 
     this.controller = controller;
+    this.surfaces = new DriverSurfaceRegistry(
+      qmlObjects.activityInfo,
+      kwinApi,
+      proxy
+    );
     this.windowMap = new WrapperMap(
       (client: KWin.Client) => DriverWindowImpl.generateID(client),
       (client: KWin.Client) =>
         new EngineWindowImpl(
-          new DriverWindowImpl(client, this.qml, this.config, this.kwinApi),
+          new DriverWindowImpl(
+            client,
+            this.config,
+            this.kwinApi,
+            this.proxy,
+            this.surfaces
+          ),
           this.config,
-          this.log
+          this.log,
+          this.proxy
         )
     );
     this.entered = false;
+    this.recording = proxy.recording;
     this.qml = qmlObjects;
     this.kwinApi = kwinApi;
   }
 
   public bindEvents(): void {
     const onClientAdded = (client: KWin.Client): void => {
-      this.log.log(`Client added: ${client}`);
+      this.record(RecordedEvent.ClientAdded, client);
+      this.log.debug("Client added", () => ({ client }));
+
+      if (client.dock) {
+        this.bindDockEvents(client);
+        this.invalidateSurfaces();
+      }
 
       const window = this.windowMap.add(client);
       this.controller.onWindowAdded(window);
       if (window.state === WindowState.Unmanaged) {
-        this.log.log(
-          `Window becomes unmanaged and gets removed :( The client was ${client}`
-        );
+        this.log.debug("Window becomes unmanaged and gets removed", () => ({
+          client,
+        }));
         this.windowMap.remove(client);
       } else {
-        this.log.log(`Client is ok, can manage. Bind events now...`);
+        this.log.debug("Client is ok, can manage. Bind events now...");
         this.bindWindowEvents(window, client);
       }
     };
 
     const onClientRemoved = (client: KWin.Client): void => {
+      this.record(RecordedEvent.ClientRemoved, client);
+
+      if (client.dock) {
+        this.unbindEvents(DriverWindowImpl.generateID(client));
+        this.invalidateSurfaces();
+      }
+
       const window = this.windowMap.get(client);
       if (window) {
+        this.proxy.forgetCommit(window.id);
         this.controller.onWindowRemoved(window);
         this.windowMap.remove(client);
       }
@@ -190,6 +229,11 @@ export class DriverImpl implements Driver {
       h: boolean,
       v: boolean
     ): void => {
+      this.record(
+        RecordedEvent.ClientMaximizeSet,
+        client,
+        (h ? 1 : 0) | (v ? 2 : 0)
+      );
       const maximized = h === true && v === true;
       const window = this.windowMap.get(client);
       if (window) {
@@ -199,6 +243,7 @@ export class DriverImpl implements Driver {
     };
 
     const onClientMinimized = (client: KWin.Client): void => {
+      this.record(RecordedEvent.ClientMinimized, client);
       if (this.config.preventMinimize) {
         client.minimized = false;
         this.kwinApi.workspace.activeClient = client;
@@ -210,18 +255,72 @@ export class DriverImpl implements Driver {
       }
     };
 
-    const onClientUnminimized = (client: KWin.Client): void =>
+    const onClientUnminimized = (client: KWin.Client): void => {
+      this.record(RecordedEvent.ClientUnminimized, client);
       this.controller.onWindowChanged(
         this.windowMap.get(client),
         "unminimized"
       );
+    };
+
+    this.connect(this.kwinApi.workspace.currentActivityChanged, () => {
+      this.record(
+        RecordedEvent.CurrentActivityChanged,
+        null,
+        this.kwinApi.workspace.currentActivity
+      );
+      this.controller.onCurrentSurfaceChanged();
+    });
 
-    this.connect(this.kwinApi.workspace.currentActivityChanged, () =>
-      this.controller.onCurrentSurfaceChanged()
+    this.connect(this.kwinApi.workspace.currentDesktopChanged, () => {
+      this.record(
+        RecordedEvent.CurrentDesktopChanged,
+        null,
+        this.kwinApi.workspace.currentDesktop
+      );
+      this.controller.onCurrentSurfaceChanged();
+    });
+
+    // The working areas of the surfaces are cached until the screens, the
+    // desktops, the activities or the docks change
+    const onSurfacesChanged = (): void => this.invalidateSurfaces();
+
+    this.connect(
+      this.kwinApi.workspace.numberScreensChanged,
+      onSurfacesChanged
     );
+    this.connect(this.kwinApi.workspace.screenResized, onSurfacesChanged);
+    this.connect(
+      this.kwinApi.workspace.numberDesktopsChanged,
+      onSurfacesChanged
+    );
+    this.connect(this.kwinApi.workspace.activitiesChanged, onSurfacesChanged);
 
-    this.connect(this.kwinApi.workspace.currentDesktopChanged, () =>
-      this.controller.onCurrentSurfaceChanged()
+    this.connect(this.proxy.configChanged, () => {
+      // The ids and the ignore flags were rebuilt by the native side
+      if (this.proxy.configChanges & ConfigChange.Surfaces) {
+        this.surfaces.invalidate(false);
+      }
+      this.controller.onConfigChanged();
+    });
+
+    this.connect(this.proxy.layoutStateRequested, () =>
+      this.controller.onLayoutStateRequested()
+    );
+
+    this.connect(this.proxy.recordingChanged, () => {
+      this.recording = this.proxy.recording;
+      if (this.recording) {
+        this.proxy.recordWorkspace(
+          snapshotWorkspace(this.kwinApi, this.qml.activityInfo)
+        );
+      }
+    });
+
+    this.connect(
+      this.proxy.arrangeRequested,
+      (surfaces: number[], allSurfaces: boolean) =>
+        this.controller.onArrangeRequested(surfaces, allSurfaces)
     );
 
     this.connect(this.kwinApi.workspace.clientAdded, onClientAdded);
@@ -235,6 +334,9 @@ export class DriverImpl implements Driver {
     const clients = this.kwinApi.workspace.clientList();
     // TODO: provide interface for using the "for of" cycle
     for (let i = 0; i < clients.length; i++) {
+      if (clients[i].dock) {
+        this.bindDockEvents(clients[i]);
+      }
       this.manageWindow(clients[i]);
     }
   }
@@ -257,19 +359,55 @@ export class DriverImpl implements Driver {
     this.controller.manageWindow(window);
   }
 
+  public applyIgnoreRules(): void {
+    const clients = this.kwinApi.workspace.clientList();
+    for (let i = 0; i < clients.length; i++) {
+      const client = clients[i];
+      const window = this.windowMap.get(client);
+
+      // The window was ignored, when it was added
+      if (!window) {
+        this.manageWindow(client);
+        const managed = this.windowMap.get(client);
+        if (managed) {
+          this.log.debug("Window is not ignored anymore", () => ({ client }));
+          this.controller.scheduleArrange(managed.surface);
+        }
+        continue;
+      }
+
+      if (window.shouldIgnore) {
+        this.log.debug("Window is ignored now", () => ({ window }));
+        this.unbindEvents(window.id);
+        // Give the window its border back, if the tiling has removed it
+        window.window.commit(undefined, false);
+        this.proxy.forgetCommit(window.id);
+        this.controller.onWindowRemoved(window);
+        this.windowMap.remove(client);
+      }
+    }
+  }
+
   public showNotification(text: string, icon?: string, hint?: string): void {
     this.qml.popupDialog.show(text, icon, hint);
   }
 
   public drop(): void {
-    this.log.log(`Dropping all registered callbacks... Goodbye.`);
-    for (const pair of this.registeredConnections) {
+    this.log.debug("Dropping all registered callbacks... Goodbye.");
+    this.disconnect(this.registeredConnections);
+  }
+
+  /**
+   * Disconnect the callbacks from their signals
+   */
+  private disconnect(connections: SignalCallbackPair[]): void {
+    for (const pair of connections) {
       try {
         pair.signal.disconnect(pair.callback);
       } catch (e: any) {
         // Error is thrown, when the object is already deleted,
         // ignore it then and delete other callbacks
-        this.log.log(`Callback was already deleted. Ignoring it.`);
+        this.log.debug("Callback was already deleted. Ignoring it.");
       }
     }
   }
@@ -294,6 +432,15 @@ export class DriverImpl implements Driver {
     signal.connect(pair.callback);
   }
 
+  /**
+   * Drop the cached surfaces with their working areas and arrange the
+   * windows in the new areas
+   */
+  private invalidateSurfaces(): void {
+    this.surfaces.invalidate(true);
+    this.controller.onSurfaceUpdate();
+  }
+
   /**
    * Run the given function in a protected(?) context to prevent nested event
    * handling.
@@ -309,25 +456,49 @@ export class DriverImpl implements Driver {
     }
 
     this.entered = true;
+    const traceStart = this.proxy.traceBegin();
     try {
       callback();
     } catch (e: any) {
-      // eslint-disable-next-line @typescript-eslint/no-unsafe-argument, @typescript-eslint/no-unsafe-member-access
-      this.log.log(`Oops! ${e.name}: ${e.message}. `);
+      this.log.warning("Oops!", () => ({
+        // eslint-disable-next-line @typescript-eslint/no-unsafe-member-access
+        name: e.name,
+        // eslint-disable-next-line @typescript-eslint/no-unsafe-member-access
+        message: e.message,
+      }));
     } finally {
       this.entered = false;
+      this.proxy.traceEnd(this.eventSpan, traceStart);
+    }
+  }
+
+  /**
+   * Write the event to the event trace, if it is being recorded. Only the
+   * events, that reach the handlers, are recorded, so that the replay
+   * skips the same events as the script did.
+   */
+  private record(
+    event: RecordedEvent,
+    client: KWin.Client | null,
+    value?: number | string
+  ): void {
+    if (this.recording) {
+      this.proxy.recordEvent(event, client, value);
     }
   }
 
   private bindWindowEvents(window: EngineWindow, client: KWin.Client): void {
+    const firstConnection = this.registeredConnections.length;
     let moving = false;
     let resizing = false;
 
     this.connect(client.moveResizedChanged, () => {
-      this.log.log([
-        "moveResizedChanged",
-        { window, move: client.move, resize: client.resize },
-      ]);
+      this.record(RecordedEvent.MoveResizedChanged, client);
+      this.log.debug("moveResizedChanged", () => ({
+        window,
+        move: client.move,
+        resize: client.resize,
+      }));
       if (moving !== client.move) {
         moving = client.move;
         if (moving) {
@@ -347,9 +518,21 @@ export class DriverImpl implements Driver {
     });
 
     this.connect(client.frameGeometryChanged, () => {
+      this.record(RecordedEvent.FrameGeometryChanged, client);
+
+      // The commit of the dragged window is forgotten, when the drag begins
       if (moving) {
         this.controller.onWindowMove(window);
-      } else if (resizing) {
+        return;
+      }
+
+      // KWin echoes our own writes, often after the handler, that made them,
+      // has finished. Anything else invalidates the committed geometry.
+      if (this.proxy.consumeEcho(client, window.id, EchoProperty.Geometry)) {
+        return;
+      }
+
+      if (resizing) {
         this.controller.onWindowResize(window);
       } else {
         if (!window.actualGeometry.equals(window.geometry)) {
@@ -358,30 +541,90 @@ export class DriverImpl implements Driver {
       }
     });
 
+    // The flags are not handled by the engine, but the next commit must
+    // write them again, if they were changed not by us
+    this.connect(client.noBorderChanged, () => {
+      this.proxy.consumeEcho(client, window.id, EchoProperty.NoBorder);
+    });
+
+    this.connect(client.keepAboveChanged, () => {
+      this.proxy.consumeEcho(client, window.id, EchoProperty.KeepAbove);
+    });
+
     this.connect(client.activeChanged, () => {
+      this.record(RecordedEvent.ActiveChanged, client);
       if (client.active) {
         this.controller.onWindowFocused(window);
       }
     });
 
     this.connect(client.screenChanged, () => {
+      this.record(RecordedEvent.ScreenChanged, client);
       this.controller.onWindowScreenChanged(window);
     });
 
-    this.connect(client.activitiesChanged, () =>
+    this.connect(client.activitiesChanged, () => {
+      this.record(RecordedEvent.ActivitiesChanged, client);
       this.controller.onWindowChanged(
         window,
         "activity=" + client.activities.join(",")
-      )
-    );
+      );
+    });
 
-    this.connect(client.desktopChanged, () =>
-      this.controller.onWindowChanged(window, `desktop=${client.desktop}`)
-    );
+    this.connect(client.desktopChanged, () => {
+      this.record(RecordedEvent.DesktopChanged, client);
+      this.controller.onWindowChanged(window, `desktop=${client.desktop}`);
+    });
+
+    this.connect(client.fullScreenChanged, () => {
+      this.record(RecordedEvent.FullScreenChanged, client);
+      this.controller.onWindowChanged(
+        window,
+        `fullScreen=${client.fullScreen}`
+      );
+    });
 
     this.connect(client.shadeChanged, () => {
+      this.record(RecordedEvent.ShadeChanged, client);
       this.controller.onWindowShadeChanged(window);
     });
+
+    this.windowConnections[window.id] =
+      this.registeredConnections.slice(firstConnection);
+  }
+
+  /**
+   * Docks take a part of the working area, so the cached working areas are
+   * dropped, when a dock is moved or resized
+   */
+  private bindDockEvents(client: KWin.Client): void {
+    const firstConnection = this.registeredConnections.length;
+
+    this.connect(client.frameGeometryChanged, () => {
+      this.log.debug("Dock geometry changed", () => ({ client }));
+      this.invalidateSurfaces();
+    });
+
+    this.windowConnections[DriverWindowImpl.generateID(client)] =
+      this.registeredConnections.slice(firstConnection);
+  }
+
+  /**
+   * Disconnect the callbacks, that bindWindowEvents or bindDockEvents has
+   * connected
+   * @param id id of the window or of the dock
+   */
+  private unbindEvents(id: string): void {
+    const connections = this.windowConnections[id];
+    if (!connections) {
+      return;
+    }
+    delete this.windowConnections[id];
+
+    this.disconnect(connections);
+    this.registeredConnections = this.registeredConnections.filter(
+      (pair) => connections.indexOf(pair) < 0
+    );
   }
 }
 
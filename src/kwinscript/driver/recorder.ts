@@ -0,0 +1,70 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+//
+// SPDX-License-Identifier: MIT
+
+import { RecordedArea, RecordedWorkspace } from "../extern/proxy";
+
+/**
+ * Events, that are written to the event trace. Must be in sync with the
+ * native TraceEvent::Type.
+ */
+export enum RecordedEvent {
+  ClientAdded = 0,
+  ClientRemoved = 1,
+  ClientMaximizeSet = 2,
+  ClientMinimized = 3,
+  ClientUnminimized = 4,
+  CurrentDesktopChanged = 5,
+  CurrentActivityChanged = 6,
+  FrameGeometryChanged = 7,
+  MoveResizedChanged = 8,
+  ActiveChanged = 9,
+  ScreenChanged = 10,
+  ActivitiesChanged = 11,
+  DesktopChanged = 12,
+  FullScreenChanged = 13,
+  ShadeChanged = 14,
+}
+
+/**
+ * Collect the state of the workspace, that the recorded events start from
+ */
+export function snapshotWorkspace(
+  kwinApi: KWin.Api,
+  activityInfo: Plasma.TaskManager.ActivityInfo
+): RecordedWorkspace {
+  const workspace = kwinApi.workspace;
+
+  const areas: RecordedArea[] = [];
+  for (let screen = 0; screen < workspace.numScreens; screen++) {
+    for (let desktop = 1; desktop <= workspace.desktops; desktop++) {
+      areas.push({
+        screen,
+        desktop,
+        area: workspace.clientArea(
+          0, // This is PlacementArea
+          screen,
+          desktop
+        ),
+      });
+    }
+  }
+
+  const activities = [];
+  const activityIds = activityInfo.runningActivities();
+  for (let i = 0; i < activityIds.length; i++) {
+    const id = activityIds[i];
+    activities.push({ id, name: activityInfo.activityName(id) });
+  }
+
+  return {
+    numScreens: workspace.numScreens,
+    desktops: workspace.desktops,
+    currentDesktop: workspace.currentDesktop,
+    activeScreen: workspace.activeScreen,
+    currentActivity: workspace.currentActivity,
+    activities,
+    areas,
+    clients: workspace.clientList(),
+  };
+}
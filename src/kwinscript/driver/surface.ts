@@ -3,8 +3,7 @@
 //
 // SPDX-License-Identifier: MIT
 
-import { Config } from "../config";
-import { TSProxy } from "../extern/proxy";
+import { SurfaceInfo, TSProxy } from "../extern/proxy";
 import { Rect } from "../util/rect";
 
 /**
@@ -18,6 +17,36 @@ export interface DriverSurface {
    */
   readonly id: string;
 
+  /**
+   * Native handle, the same for the same screen, activity and desktop
+   */
+  readonly handle: number;
+
+  /**
+   * Interned id. Equal for the surfaces, that share the layouts.
+   */
+  readonly layoutKey: number;
+
+  /**
+   * Interned id of the surface in the trace spans
+   */
+  readonly traceId: number;
+
+  /**
+   * The screen of the surface
+   */
+  readonly screen: number;
+
+  /**
+   * The activity of the surface
+   */
+  readonly activity: string;
+
+  /**
+   * The virtual desktop of the surface
+   */
+  readonly desktop: number;
+
   /**
    * Should the surface be completely ignored by the script.
    */
@@ -36,62 +65,103 @@ export interface DriverSurface {
 
 export class DriverSurfaceImpl implements DriverSurface {
   public readonly id: string;
+  public readonly layoutKey: number;
+  public readonly traceId: number;
   public readonly ignore: boolean;
   public readonly workingArea: Rect;
 
   constructor(
+    public readonly handle: number,
     public readonly screen: number,
     public readonly activity: string,
     public readonly desktop: number,
+    info: SurfaceInfo,
+    private registry: DriverSurfaceRegistry
+  ) {
+    this.id = info.id;
+    this.layoutKey = info.layoutKey;
+    this.traceId = info.traceId;
+    this.ignore = info.ignore;
+    this.workingArea = Rect.fromQRect(info.workingArea);
+  }
+
+  public next(): DriverSurface | null {
+    return this.registry.next(this);
+  }
+
+  public toString(): string {
+    const activityName = this.registry.activityName(this.activity);
+    return `DriverSurface(${this.screen}, ${activityName}, ${this.desktop})`;
+  }
+}
+
+/**
+ * Surfaces, that were already looked up. The surface objects are shared
+ * until invalidate is called, the native side keeps their working areas and
+ * ids between the invalidations of the script cache.
+ */
+export class DriverSurfaceRegistry {
+  private surfaces: DriverSurfaceImpl[];
+
+  constructor(
     private activityInfo: Plasma.TaskManager.ActivityInfo,
-    private config: Config,
-    private kwinApi: KWin.Api
+    private kwinApi: KWin.Api,
+    private proxy: TSProxy
   ) {
-    this.id = this.generateId();
+    this.surfaces = [];
+  }
 
-    const activityName = activityInfo.activityName(activity);
-    this.ignore =
-      this.config.ignoreActivity.indexOf(activityName) >= 0 ||
-      this.config.ignoreScreen.indexOf(screen) >= 0;
+  public get(screen: number, activity: string, desktop: number): DriverSurface {
+    const handle = this.proxy.internSurface(screen, activity, desktop);
 
-    this.workingArea = Rect.fromQRect(
-      this.kwinApi.workspace.clientArea(
-        0, // This is PlacementArea
+    let surface = this.surfaces[handle];
+    if (!surface) {
+      const info =
+        this.proxy.surfaceInfo(handle) ||
+        this.proxy.cacheSurface(
+          handle,
+          this.activityName(activity),
+          this.kwinApi.workspace.clientArea(
+            0, // This is PlacementArea
+            screen,
+            desktop
+          )
+        );
+      surface = new DriverSurfaceImpl(
+        handle,
         screen,
-        desktop
-      )
-    );
+        activity,
+        desktop,
+        info,
+        this
+      );
+      this.surfaces[handle] = surface;
+    }
+    return surface;
   }
 
-  public next(): DriverSurface | null {
+  public next(surface: DriverSurface): DriverSurface | null {
     // This is the last virtual desktop
-    if (this.desktop === this.kwinApi.workspace.desktops) {
+    if (surface.desktop === this.kwinApi.workspace.desktops) {
       return null;
     }
 
-    return new DriverSurfaceImpl(
-      this.screen,
-      this.activity,
-      this.desktop + 1,
-      this.activityInfo,
-      this.config,
-      this.kwinApi
-    );
+    return this.get(surface.screen, surface.activity, surface.desktop + 1);
   }
 
-  public toString(): string {
-    const activityName = this.activityInfo.activityName(this.activity);
-    return `DriverSurface(${this.screen}, ${activityName}, ${this.desktop})`;
+  public activityName(activity: string): string {
+    return this.activityInfo.activityName(activity);
   }
 
-  private generateId(): string {
-    let path = String(this.screen);
-    if (this.config.layoutPerActivity) {
-      path += `@${this.activity}`;
-    }
-    if (this.config.layoutPerDesktop) {
-      path += `"#${this.desktop}`;
+  /**
+   * Drop the cached surfaces. Must be called, when the screens, the desktops,
+   * the activities or the config of the surfaces change.
+   * @param native whether to drop the native cache of the working areas too
+   */
+  public invalidate(native: boolean): void {
+    this.surfaces = [];
+    if (native) {
+      this.proxy.invalidateSurfaces();
     }
-    return path;
   }
 }
@@ -3,13 +3,36 @@
 //
 // SPDX-License-Identifier: MIT
 
-import { DriverSurface, DriverSurfaceImpl } from "./surface";
+import {
+  DriverSurface,
+  DriverSurfaceImpl,
+  DriverSurfaceRegistry,
+} from "./surface";
 
 import { Rect } from "../util/rect";
-import { clip, matchWords } from "../util/func";
+import { clip } from "../util/func";
 import { Config } from "../config";
 import { Log } from "../util/log";
-import { TSProxy } from "../extern/proxy";
+import { TSProxy, WindowCommit } from "../extern/proxy";
+
+/**
+ * Window rules from the config. Must be in sync with the native WindowRules::Flag.
+ */
+export enum WindowRule {
+  Tile = 0x1,
+  Float = 0x2,
+  Ignore = 0x4,
+}
+
+/**
+ * Client properties, whose changes may be echoes of our own writes. Must be in
+ * sync with the native EchoTracker::Property.
+ */
+export enum EchoProperty {
+  Geometry = 0,
+  NoBorder = 1,
+  KeepAbove = 2,
+}
 
 /**
  * KWin window representation.
@@ -50,6 +73,16 @@ export interface DriverWindow {
    */
   readonly screen: number;
 
+  /**
+   * The virtual desktop of the window. -1 if the window is on all desktops.
+   */
+  readonly desktop: number;
+
+  /**
+   * The activities of the window. Empty if the window is on all activities.
+   */
+  readonly activities: string[];
+
   /**
    * Whether the window is focused right now
    */
@@ -106,26 +139,10 @@ export class DriverWindowImpl implements DriverWindow {
   }
 
   public get shouldIgnore(): boolean {
-    const resourceClass = String(this.client.resourceClass);
-    const resourceName = String(this.client.resourceName);
-    const windowRole = String(this.client.windowRole);
-    return (
-      this.client.specialWindow ||
-      resourceClass === "plasmashell" ||
-      resourceClass === "ksmserver" ||
-      resourceClass === "org.kde.plasmashell" ||
-      resourceClass === "krunner" ||
-      resourceClass === "kded5" ||
-      this.config.ignoreClass.indexOf(resourceClass) >= 0 ||
-      this.config.ignoreClass.indexOf(resourceName) >= 0 ||
-      matchWords(this.client.caption, this.config.ignoreTitle) >= 0 ||
-      this.config.ignoreRole.indexOf(windowRole) >= 0
-    );
+    return this.client.specialWindow || (this.rules & WindowRule.Ignore) !== 0;
   }
 
   public get shouldFloat(): boolean {
-    const resourceClass = String(this.client.resourceClass);
-    const resourceName = String(this.client.resourceName);
     return (
       this.client.modal ||
       !this.client.resizeable ||
@@ -134,9 +151,19 @@ export class DriverWindowImpl implements DriverWindow {
           this.client.splash ||
           this.client.utility ||
           this.client.transient)) ||
-      this.config.floatingClass.indexOf(resourceClass) >= 0 ||
-      this.config.floatingClass.indexOf(resourceName) >= 0 ||
-      matchWords(this.client.caption, this.config.floatingTitle) >= 0
+      (this.rules & WindowRule.Float) !== 0
+    );
+  }
+
+  /**
+   * Window rules from the config, that apply to this window
+   */
+  private get rules(): WindowRule {
+    return this.proxy.classifyWindow(
+      String(this.client.resourceClass),
+      String(this.client.resourceName),
+      String(this.client.windowRole),
+      String(this.client.caption)
     );
   }
 
@@ -144,6 +171,14 @@ export class DriverWindowImpl implements DriverWindow {
     return this.client.screen;
   }
 
+  public get desktop(): number {
+    return this.client.desktop;
+  }
+
+  public get activities(): string[] {
+    return this.client.activities;
+  }
+
   public get minimized(): boolean {
     return this.client.minimized;
   }
@@ -176,14 +211,7 @@ export class DriverWindowImpl implements DriverWindow {
         ? this.client.desktop
         : this.kwinApi.workspace.currentDesktop;
 
-    return new DriverSurfaceImpl(
-      this.client.screen,
-      activity,
-      desktop,
-      this.qml.activityInfo,
-      this.config,
-      this.kwinApi
-    );
+    return this.surfaces.get(this.client.screen, activity, desktop);
   }
 
   public set surface(surf: DriverSurface) {
@@ -203,15 +231,16 @@ export class DriverWindowImpl implements DriverWindow {
    * Create a window from the KWin client object
    *
    * @param client the client the window represents
-   * @param qml root qml object of the script
    * @param config
    * @param log
+   * @param surfaces surfaces of the driver, that the window can be on
    */
   constructor(
     public readonly client: KWin.Client,
-    private qml: Bismuth.Qml.Main,
     private config: Config,
-    private kwinApi: KWin.Api
+    private kwinApi: KWin.Api,
+    private proxy: TSProxy,
+    private surfaces: DriverSurfaceRegistry
   ) {
     this.id = DriverWindowImpl.generateID(client);
     this.maximized = false;
@@ -242,6 +271,9 @@ export class DriverWindowImpl implements DriverWindow {
       return;
     }
 
+    // The values are written natively, so that their echoes are recognised
+    const commit: WindowCommit = { id: this.id };
+
     if (noBorder !== undefined) {
       if (!this.noBorderManaged && noBorder) {
         /* Backup border state when transitioning from unmanaged to managed */
@@ -254,10 +286,10 @@ export class DriverWindowImpl implements DriverWindow {
 
       if (noBorder) {
         /* (Re)entering managed mode: remove border. */
-        this.client.noBorder = true;
+        commit.noBorder = true;
       } else if (this.noBorderManaged) {
         /* Exiting managed mode: restore original value. */
-        this.client.noBorder = this.noBorderOriginal;
+        commit.noBorder = this.noBorderOriginal;
       }
 
       /* update mode */
@@ -265,7 +297,7 @@ export class DriverWindowImpl implements DriverWindow {
     }
 
     if (keepAbove !== undefined) {
-      this.client.keepAbove = keepAbove;
+      commit.keepAbove = keepAbove;
     }
 
     if (geometry !== undefined) {
@@ -286,8 +318,10 @@ export class DriverWindowImpl implements DriverWindow {
           geometry = this.adjustGeometry(geometry);
         }
       }
-      this.client.frameGeometry = geometry.toQRect();
+      commit.geometry = geometry;
     }
+
+    this.proxy.writeWindow(this.client, commit);
   }
 
   public toString(): string {
@@ -14,10 +14,12 @@ import { Controller } from "../controller";
 import { DriverSurface } from "../driver/surface";
 
 import { Rect, RectDelta } from "../util/rect";
-import { overlap, wrapIndex } from "../util/func";
+import { wrapIndex } from "../util/func";
 import { Config } from "../config";
+import { WindowCommit } from "../extern/proxy";
 import { Log } from "../util/log";
 import { WindowsLayout } from "./layout";
+import { NativeLayoutBatch } from "./layout/native_layout_batch";
 
 export type Direction = "up" | "down" | "left" | "right";
 export type CompassDirection = "east" | "west" | "south" | "north";
@@ -42,6 +44,27 @@ export interface Engine {
    */
   arrange(): void;
 
+  /**
+   * Arrange the windows only on the given surfaces. Surfaces, that are not
+   * currently visible, are skipped.
+   * @param surfaces handles of the surfaces to arrange
+   */
+  arrangeSurfaces(surfaces: number[]): void;
+
+  /**
+   * Re-evaluate the window rules after they were changed. The windows, that
+   * should float or tile now, change their state, and their surfaces are
+   * scheduled for the arrangement. The windows, whose rules are the same,
+   * keep the state, the user has chosen.
+   */
+  applyWindowRules(): void;
+
+  /**
+   * Write the settings of the floating windows, i.e. whether they are kept
+   * above, to the floating windows again. Their geometry is left as is.
+   */
+  applyFloatSettings(): void;
+
   /**
    * Register the given window to WM.
    */
@@ -67,14 +90,14 @@ export interface Engine {
    *
    * @param window a floating window
    */
-  resizeFloat(window: EngineWindow, dir: CompassDirection, step: Step): void;
+  resizeFloat(window: EngineWindow, dir: CompassDirection, step: number): void;
 
   /**
    * Resize the current tile by adjusting the layout.
    *
    * Used by grow/shrink shortcuts.
    */
-  resizeTile(basis: EngineWindow, dir: CompassDirection, step: Step): void;
+  resizeTile(basis: EngineWindow, dir: CompassDirection, step: number): void;
 
   /**
    * Resize the given window, by moving border inward or outward.
@@ -82,9 +105,14 @@ export interface Engine {
    * The actual behavior depends on the state of the given window.
    *
    * @param dir which border
-   * @param step which direction. 1 means outward, -1 means inward.
+   * @param step which direction and how many steps. Positive means outward,
+   * negative means inward.
    */
-  resizeWindow(window: EngineWindow, dir: CompassDirection, step: Step): void;
+  resizeWindow(
+    window: EngineWindow,
+    dir: CompassDirection,
+    step: number
+  ): void;
 
   /**
    * @returns the layout we have on the surface of the active window
@@ -113,7 +141,13 @@ export interface Engine {
    */
   swapOrder(window: EngineWindow, step: Step): void;
 
-  swapDirOrMoveFloat(dir: Direction): void;
+  /**
+   * Move the current floating window or swap the current tile with its
+   * neighbor in the given direction.
+   * @param steps number of steps to move a floating window by or number of
+   * the tiles to pass
+   */
+  swapDirOrMoveFloat(dir: Direction, steps?: number): void;
 
   /**
    * Set the current window as the "master".
@@ -165,17 +199,45 @@ export interface Engine {
   showLayoutNotification(): void;
 }
 
+/**
+ * Screen, whose layout is applied, but which is not committed yet
+ */
+interface ScreenArrangement {
+  screenSurface: DriverSurface;
+  layout: WindowsLayout;
+  workingArea: Rect;
+  visibleWindows: EngineWindow[];
+  tileableWindows: EngineWindow[];
+
+  /**
+   * When the layout of the screen began
+   */
+  layoutStart: number;
+
+  /**
+   * When the layout of the screen ended, if the other screens of the batch
+   * were laid out before the screen is committed
+   */
+  layoutEnd?: number;
+}
+
 export class EngineImpl implements Engine {
   public layouts: LayoutStore;
   public windows: WindowStore;
 
+  /**
+   * Interned name of the commit trace spans
+   */
+  private readonly commitSpan: number;
+
   constructor(
     private controller: Controller,
     private config: Config,
     private log: Log
   ) {
-    this.layouts = new LayoutStore(this.config);
-    this.windows = new WindowStoreImpl();
+    this.layouts = new LayoutStore(this.config, this.controller.proxy);
+    this.windows = new WindowStoreImpl(this.controller.proxy);
+    this.commitSpan = this.controller.proxy.traceName("commit");
   }
 
   public adjustLayout(basis: EngineWindow): void {
@@ -196,7 +258,7 @@ export class EngineImpl implements Engine {
   public resizeFloat(
     window: EngineWindow,
     dir: CompassDirection,
-    step: Step
+    step: number
   ): void {
     const srf = window.surface;
 
@@ -230,7 +292,7 @@ export class EngineImpl implements Engine {
   public resizeTile(
     basis: EngineWindow,
     dir: CompassDirection,
-    step: Step
+    step: number
   ): void {
     const srf = basis.surface;
 
@@ -294,7 +356,7 @@ export class EngineImpl implements Engine {
   public resizeWindow(
     window: EngineWindow,
     dir: CompassDirection,
-    step: Step
+    step: number
   ): void {
     const state = window.state;
     if (EngineWindowImpl.isFloatingState(state)) {
@@ -305,11 +367,24 @@ export class EngineImpl implements Engine {
   }
 
   public arrange(): void {
-    this.log.log("arrange");
+    this.log.debug("arrange");
 
-    this.controller.screens.forEach((driverSurface: DriverSurface) => {
-      this.arrangeScreen(driverSurface);
-    });
+    this.arrangeScreens(this.controller.screens);
+  }
+
+  public arrangeSurfaces(surfaces: number[]): void {
+    this.log.debug("arrangeSurfaces", () => ({ surfaces }));
+
+    // The native list is not an iterable array, so the set is filled by index
+    const handles = new Set<number>();
+    for (let i = 0; i < surfaces.length; i++) {
+      handles.add(surfaces[i]);
+    }
+    this.arrangeScreens(
+      this.controller.screens.filter((driverSurface: DriverSurface) =>
+        handles.has(driverSurface.handle)
+      )
+    );
   }
 
   /**
@@ -318,6 +393,52 @@ export class EngineImpl implements Engine {
    * @param screenSurface screen's surface, on which windows should be arranged
    */
   public arrangeScreen(screenSurface: DriverSurface): void {
+    this.commitScreen(this.layoutScreen(screenSurface));
+  }
+
+  /**
+   * Arrange tiles on several screens. With the native backend, the layouts
+   * of all the screens are computed at once and in parallel, then the
+   * screens are committed one by one.
+   */
+  private arrangeScreens(screenSurfaces: DriverSurface[]): void {
+    if (!this.config.experimentalBackend || screenSurfaces.length < 2) {
+      screenSurfaces.forEach((driverSurface: DriverSurface) => {
+        this.arrangeScreen(driverSurface);
+      });
+      return;
+    }
+
+    const batch = new NativeLayoutBatch();
+    this.controller.nativeLayoutBatch = batch;
+    try {
+      // Every screen is timed only for its own work. Its layout ends, where
+      // the layout of the next screen or the flush of the batch begins.
+      const arrangements = screenSurfaces.map(
+        (driverSurface: DriverSurface) => this.layoutScreen(driverSurface)
+      );
+      for (let i = 0; i + 1 < arrangements.length; i++) {
+        arrangements[i].layoutEnd = arrangements[i + 1].layoutStart;
+      }
+      arrangements[arrangements.length - 1].layoutEnd =
+        this.controller.proxy.traceBegin();
+
+      batch.flush(this.controller.proxy);
+      arrangements.forEach((arrangement: ScreenArrangement) => {
+        this.commitScreen(arrangement);
+      });
+    } finally {
+      this.controller.nativeLayoutBatch = null;
+    }
+  }
+
+  /**
+   * Decide the state of the windows on the screen and apply the layout to the
+   * tiles. With a native layout batch, the tiles get their geometries, when
+   * the batch is flushed.
+   */
+  private layoutScreen(screenSurface: DriverSurface): ScreenArrangement {
+    const layoutStart = this.controller.proxy.traceBegin();
     const layout = this.layouts.getCurrentLayout(screenSurface);
 
     const workingArea = screenSurface.workingArea;
@@ -328,7 +449,10 @@ export class EngineImpl implements Engine {
     // Set correct window state for new windows
     visibleWindows.forEach((win: EngineWindow) => {
       if (win.state === WindowState.Undecided) {
-        win.state = win.shouldFloat ? WindowState.Floating : WindowState.Tiled;
+        win.floatedByRules = win.shouldFloat;
+        win.state = win.floatedByRules
+          ? WindowState.Floating
+          : WindowState.Tiled;
       }
     });
 
@@ -343,7 +467,32 @@ export class EngineImpl implements Engine {
       layout.apply(this.controller, tileableWindows, tilingArea);
     }
 
-    // If enabled, limit the windows' width
+    return {
+      screenSurface,
+      layout,
+      workingArea,
+      visibleWindows,
+      tileableWindows,
+      layoutStart,
+    };
+  }
+
+  /**
+   * Finish the arrangement of the screen, after its tiles got their
+   * geometries, and send the changes to KWin
+   */
+  private commitScreen(arrangement: ScreenArrangement): void {
+    const commitStart = this.controller.proxy.traceBegin();
+    const {
+      screenSurface,
+      layout,
+      workingArea,
+      visibleWindows,
+      tileableWindows,
+    } = arrangement;
+
+    // If enabled, limit the windows' width. The native layouts limit it
+    // themselves, then this pass has only the maximized sole tile to change.
     if (
       this.config.limitTileWidthRatio > 0 &&
       !(layout instanceof MonocleLayout)
@@ -364,9 +513,65 @@ export class EngineImpl implements Engine {
         });
     }
 
-    // Commit window assigned properties
-    visibleWindows.forEach((win: EngineWindow) => win.commit());
-    this.log.log(["arrangeScreen/finished", { screenSurface }]);
+    // Commit window assigned properties. Only the windows, whose properties
+    // have changed since the last commit, are sent to KWin.
+    const committedWindows: EngineWindow[] = [];
+    const requests: WindowCommit[] = [];
+    visibleWindows.forEach((win: EngineWindow) => {
+      const request = win.commitRequest();
+      if (request) {
+        committedWindows.push(win);
+        requests.push(request);
+      }
+    });
+    this.controller.proxy
+      .filterCommits(requests)
+      .forEach((i: number) => committedWindows[i].applyCommit(requests[i]));
+    this.controller.proxy.traceEnd(
+      this.commitSpan,
+      commitStart,
+      screenSurface.traceId
+    );
+
+    this.log.debug("arrangeScreen/finished", () => ({ screenSurface }));
+    this.controller.proxy.arrangeEnd(
+      screenSurface.traceId,
+      layout.classID,
+      arrangement.layoutStart,
+      arrangement.layoutEnd !== undefined ? arrangement.layoutEnd : commitStart,
+      commitStart
+    );
+  }
+
+  public applyWindowRules(): void {
+    this.windows.allWindows().forEach((win: EngineWindow) => {
+      const shouldFloat = win.shouldFloat;
+      if (shouldFloat === win.floatedByRules) {
+        return;
+      }
+      win.floatedByRules = shouldFloat;
+
+      if (shouldFloat && win.tiled) {
+        win.state = WindowState.Floating;
+      } else if (!shouldFloat && win.state === WindowState.Floating) {
+        win.state = WindowState.Tiled;
+      } else {
+        return;
+      }
+
+      this.log.debug("applyWindowRules", () => ({ win, shouldFloat }));
+      this.controller.scheduleArrange(win.surface);
+    });
+  }
+
+  public applyFloatSettings(): void {
+    // The floating windows are committed only, when they start floating
+    this.windows.allWindows().forEach((win: EngineWindow) => {
+      if (EngineWindowImpl.isFloatingState(win.state)) {
+        this.controller.proxy.forgetCommit(win.id);
+        win.window.commit(undefined, undefined, this.config.keepFloatAbove);
+      }
+    });
   }
 
   public currentLayoutOnCurrentSurface(): WindowsLayout {
@@ -463,13 +668,15 @@ export class EngineImpl implements Engine {
     const vdst = wrapIndex(vsrc + step, visibles.length);
     const dstWin = visibles[vdst];
 
-    this.windows.move(window, dstWin);
+    // Moving forward puts the window after its neighbor, backward - before
+    this.windows.move(window, dstWin, vdst > vsrc);
   }
 
   /**
    * Swap the position of the current window with a neighbor at the given direction.
+   * @param steps number of the tiles to pass in the direction
    */
-  public swapDirection(dir: Direction): void {
+  public swapDirection(dir: Direction, steps = 1): void {
     const window = this.controller.currentWindow;
     if (window === null) {
       /* if no current window, select the first tile. */
@@ -482,18 +689,26 @@ export class EngineImpl implements Engine {
       return;
     }
 
-    const neighbor = this.getNeighborByDirection(window, dir);
-    if (neighbor) {
+    // The tiles are not arranged between the steps, so every next neighbor
+    // is searched from the place of the previous one
+    let place = window;
+    for (let step = 0; step < steps; step++) {
+      const neighbor = this.getNeighborByDirection(place, dir);
+      if (!neighbor) {
+        break;
+      }
       this.windows.swap(window, neighbor);
+      place = neighbor;
     }
   }
 
   /**
-   * Move the given window towards the given direction by one step.
+   * Move the given window towards the given direction.
    * @param window a floating window
    * @param dir which direction
+   * @param steps how many steps to move by
    */
-  public moveFloat(window: EngineWindow, dir: Direction): void {
+  public moveFloat(window: EngineWindow, dir: Direction, steps = 1): void {
     const srf = window.surface;
 
     // TODO: configurable step size?
@@ -517,13 +732,13 @@ export class EngineImpl implements Engine {
     }
 
     const geometry = window.actualGeometry;
-    const x = geometry.x + hStepSize * hStep;
-    const y = geometry.y + vStepSize * vStep;
+    const x = geometry.x + hStepSize * hStep * steps;
+    const y = geometry.y + vStepSize * vStep * steps;
 
     window.forceSetGeometry(new Rect(x, y, geometry.width, geometry.height));
   }
 
-  public swapDirOrMoveFloat(dir: Direction): void {
+  public swapDirOrMoveFloat(dir: Direction, steps = 1): void {
     const window = this.controller.currentWindow;
     if (!window) {
       return;
@@ -531,9 +746,9 @@ export class EngineImpl implements Engine {
 
     const state = window.state;
     if (EngineWindowImpl.isFloatingState(state)) {
-      this.moveFloat(window, dir);
+      this.moveFloat(window, dir, steps);
     } else if (EngineWindowImpl.isTiledState(state)) {
-      this.swapDirection(dir);
+      this.swapDirection(dir, steps);
     }
   }
 
@@ -602,106 +817,11 @@ export class EngineImpl implements Engine {
     );
   }
 
-  private getNeighborCandidates(
-    basis: EngineWindow,
-    dir: Direction
-  ): EngineWindow[] {
-    const visibleWindowsOnCurrentSurface = this.windows.visibleTiledWindowsOn(
-      this.controller.currentSurface
-    );
-
-    // Flipping all inputs' signs allows for the same logic to find closest windows in either direction
-    const sign = dir === "down" || dir === "right" ? 1 : -1;
-
-    if (dir === "up" || dir === "down") {
-      return visibleWindowsOnCurrentSurface.filter(
-        (window): boolean =>
-          window.geometry.y * sign > basis.geometry.y * sign &&
-          overlap(
-            basis.geometry.x,
-            basis.geometry.maxX,
-            window.geometry.x,
-            window.geometry.maxX
-          )
-      );
-    } else {
-      return visibleWindowsOnCurrentSurface.filter(
-        (window): boolean =>
-          window.geometry.x * sign > basis.geometry.x * sign &&
-          overlap(
-            basis.geometry.y,
-            basis.geometry.maxY,
-            window.geometry.y,
-            window.geometry.maxY
-          )
-      );
-    }
-  }
-
-  private getClosestRelativWindowCorner(
-    windowArray: EngineWindow[],
-    dir: Direction
-  ): number {
-    return windowArray.reduce(
-      (prevValue, window): number => {
-        switch (dir) {
-          case "up":
-            return Math.max(window.geometry.maxY, prevValue);
-          case "down":
-            return Math.min(window.geometry.y, prevValue);
-          case "left":
-            return Math.max(window.geometry.maxX, prevValue);
-          case "right":
-            return Math.min(window.geometry.x, prevValue);
-        }
-      },
-      dir === "up" || dir === "left" ? 0 : Infinity
-    );
-  }
-
-  private getClosestRelativeWindow(
-    windowArray: EngineWindow[],
-    dir: Direction,
-    closestPoint: number
-  ): EngineWindow[] {
-    return windowArray.filter((window): boolean => {
-      // adjust closestPoint for potential misalignment of tiled windows
-      switch (dir) {
-        case "up":
-          return window.geometry.maxY > closestPoint - 5;
-        case "down":
-          return window.geometry.y < closestPoint + 5;
-        case "left":
-          return window.geometry.maxX > closestPoint - 5;
-        case "right":
-          return window.geometry.x < closestPoint + 5;
-      }
-    });
-  }
-
   private getNeighborByDirection(
     basis: EngineWindow,
     dir: Direction
   ): EngineWindow | null {
-    const neighborCandidates = this.getNeighborCandidates(basis, dir);
-
-    if (neighborCandidates.length === 0) {
-      return null;
-    }
-
-    const closestWindowCorner = this.getClosestRelativWindowCorner(
-      neighborCandidates,
-      dir
-    );
-
-    const closestWindows = this.getClosestRelativeWindow(
-      neighborCandidates,
-      dir,
-      closestWindowCorner
-    );
-
-    // Return the most recently used window
-    return closestWindows.sort((a, b) => b.timestamp - a.timestamp)[0];
+    return this.windows.neighborOf(basis, dir, this.controller.currentSurface);
   }
 
   public showNotification(text: string, icon?: string, hint?: string): void {
@@ -4,6 +4,7 @@
 // SPDX-License-Identifier: MIT
 
 import { WindowsLayout } from ".";
+import LayoutUtils from "./layout_utils";
 
 import { Engine } from "..";
 import { WindowState, EngineWindow } from "../window";
@@ -16,6 +17,7 @@ import {
 import { Controller } from "../../controller";
 
 import { Rect } from "../../util/rect";
+import { Config } from "../../config";
 
 export enum CascadeDirection {
   NorthWest = 0,
@@ -62,15 +64,30 @@ export default class CascadeLayout implements WindowsLayout {
     return String(CascadeDirection[this.dir]);
   }
 
-  constructor(private dir: CascadeDirection = CascadeDirection.SouthEast) {
+  constructor(
+    private config: Config,
+    private dir: CascadeDirection = CascadeDirection.SouthEast
+  ) {
     /* nothing */
   }
 
   public apply(
-    _controller: Controller,
+    controller: Controller,
     tileables: EngineWindow[],
     area: Rect
   ): void {
+    if (this.config.experimentalBackend) {
+      tileables.forEach((tileable) => (tileable.state = WindowState.Tiled));
+      LayoutUtils.applyNative(
+        controller,
+        CascadeLayout.id,
+        { direction: this.dir },
+        area,
+        tileables
+      );
+      return;
+    }
+
     const [vertStep, horzStep] = CascadeLayout.decomposeDirection(this.dir);
 
     // TODO: adjustable step size
@@ -100,7 +117,17 @@ export default class CascadeLayout implements WindowsLayout {
   }
 
   public clone(): CascadeLayout {
-    return new CascadeLayout(this.dir);
+    return new CascadeLayout(this.config, this.dir);
+  }
+
+  public saveState(): number[] {
+    return [this.dir];
+  }
+
+  public restoreState(values: number[]): void {
+    if (values.length === 1) {
+      this.dir = ((Math.round(values[0]) % 8) + 8) % 8;
+    }
   }
 
   public executeAction(engine: Engine, action: Action): void {
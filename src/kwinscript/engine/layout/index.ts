@@ -16,6 +16,11 @@ export abstract class WindowsLayout {
 
   static readonly id: string;
 
+  /**
+   * Id of the layout class, the same as the static id.
+   */
+  abstract readonly classID: string;
+
   /**
    * Human-readable name of the layout.
    */
@@ -52,5 +57,16 @@ export abstract class WindowsLayout {
 
   executeAction?(engine: Engine, action: Action): void;
 
+  /**
+   * @returns the adjustable parameters of the layout, e.g. the master ratio,
+   * that should survive the script reload
+   */
+  saveState?(): number[];
+
+  /**
+   * Set the parameters, returned by saveState. Invalid values are ignored.
+   */
+  restoreState?(values: number[]): void;
+
   abstract toString(): string;
 }
@@ -3,6 +3,10 @@
 //
 // SPDX-License-Identifier: MIT
 
+import { EngineWindow } from "../window";
+
+import { Controller } from "../../controller";
+import { LayoutParameters } from "../../extern/proxy";
 import { clip } from "../../util/func";
 import { Rect, RectDelta } from "../../util/rect";
 
@@ -229,4 +233,87 @@ export default class LayoutUtils {
       : geometries.map((geometry) => [geometry.y, geometry.height]);
     return LayoutUtils.calculateWeights(parts);
   }
+
+  /**
+   * Round the angle to the closest one, a layout part can be rotated by
+   * @param value angle in degrees, e.g. restored from the saved state
+   */
+  public static toAngle(value: number): 0 | 90 | 180 | 270 {
+    return ((((Math.round(value / 90) % 4) + 4) % 4) * 90) as
+      | 0
+      | 90
+      | 180
+      | 270;
+  }
+
+  /**
+   * Place the tiles with the native layout implementation. All the geometries
+   * are computed in one call to the core. The tile width limit is already
+   * applied to them.
+   *
+   * During the arrangement of several surfaces, the request is added to the
+   * batch of the controller, and the tiles get their geometries, when the
+   * batch is flushed.
+   * @param controller    The controller, which provides the core proxy
+   * @param layoutId      The id of the layout to apply
+   * @param parameters    Current per-surface parameters of the layout
+   * @param area          The area to place the tiles in
+   * @param tiles         The tiles to be placed
+   */
+  public static applyNative(
+    controller: Controller,
+    layoutId: string,
+    parameters: LayoutParameters,
+    area: Rect,
+    tiles: EngineWindow[]
+  ): void {
+    const batch = controller.nativeLayoutBatch;
+    if (batch) {
+      batch.add(layoutId, parameters, area, tiles);
+      return;
+    }
+
+    const buffer = controller.proxy.applyLayout(
+      layoutId,
+      parameters,
+      area.toQRect(),
+      tiles.map((tile) => tile.weight)
+    );
+    LayoutUtils.toGeometries(buffer, tiles).forEach((geometry, i) => {
+      tiles[i].geometry = geometry;
+    });
+  }
+
+  /**
+   * Convert the result of the native layout to the geometries of the tiles.
+   * Tiles, whose geometry has not changed, keep their current rect object.
+   * @param buffer  Integer x, y, width and height of every tile
+   * @param tiles   The placed tiles
+   * @returns Geometries of the tiles, that fit into the layout
+   */
+  public static toGeometries(
+    buffer: ArrayBuffer,
+    tiles: EngineWindow[]
+  ): Rect[] {
+    const values = new Int32Array(buffer);
+    const geometries: Rect[] = [];
+    for (let i = 0; i * 4 < values.length; i++) {
+      const x = values[i * 4];
+      const y = values[i * 4 + 1];
+      const width = values[i * 4 + 2];
+      const height = values[i * 4 + 3];
+
+      const current = tiles[i].geometry;
+      geometries.push(
+        current &&
+          current.x === x &&
+          current.y === y &&
+          current.width === width &&
+          current.height === height
+          ? current
+          : new Rect(x, y, width, height)
+      );
+    }
+    return geometries;
+  }
 }
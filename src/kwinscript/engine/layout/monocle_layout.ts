@@ -4,6 +4,7 @@
 // SPDX-License-Identifier: MIT
 
 import { WindowsLayout } from ".";
+import LayoutUtils from "./layout_utils";
 
 import { WindowState, EngineWindow } from "../window";
 
@@ -44,9 +45,20 @@ export default class MonocleLayout implements WindowsLayout {
       tile.state = this.config.monocleMaximize
         ? WindowState.Maximized
         : WindowState.Tiled;
-
-      tile.geometry = area;
     });
+
+    if (this.config.experimentalBackend) {
+      LayoutUtils.applyNative(
+        controller,
+        MonocleLayout.id,
+        {},
+        area,
+        tileables
+      );
+      return;
+    }
+
+    tileables.forEach((tile) => (tile.geometry = area));
   }
 
   public clone(): this {
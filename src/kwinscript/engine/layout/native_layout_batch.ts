@@ -0,0 +1,58 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+import { EngineWindow } from "../window";
+import LayoutUtils from "./layout_utils";
+
+import {
+  LayoutParameters,
+  NativeLayoutRequest,
+  TSProxy,
+} from "../../extern/proxy";
+import { Rect } from "../../util/rect";
+
+/**
+ * Native layout requests of several surfaces, that are computed at once.
+ * The core arranges the surfaces of a batch in parallel.
+ */
+export class NativeLayoutBatch {
+  private requests: NativeLayoutRequest[] = [];
+  private tiles: EngineWindow[][] = [];
+
+  /**
+   * Remember the request. The tiles get their geometries in flush.
+   */
+  public add(
+    layoutId: string,
+    parameters: LayoutParameters,
+    area: Rect,
+    tiles: EngineWindow[]
+  ): void {
+    this.requests.push({
+      layoutId,
+      parameters,
+      area: area.toQRect(),
+      weights: tiles.map((tile) => tile.weight),
+    });
+    this.tiles.push(tiles);
+  }
+
+  /**
+   * Compute all the requests and assign the geometries to their tiles
+   */
+  public flush(proxy: TSProxy): void {
+    if (this.requests.length === 0) {
+      return;
+    }
+
+    proxy.applyLayouts(this.requests).forEach((buffer, i) => {
+      const tiles = this.tiles[i];
+      LayoutUtils.toGeometries(buffer, tiles).forEach((geometry, j) => {
+        tiles[j].geometry = geometry;
+      });
+    });
+
+    this.requests = [];
+    this.tiles = [];
+  }
+}
@@ -4,6 +4,7 @@
 // SPDX-License-Identifier: MIT
 
 import { WindowsLayout } from ".";
+import LayoutUtils from "./layout_utils";
 
 import { WindowState, EngineWindow } from "../window";
 
@@ -111,8 +112,29 @@ export default class QuarterLayout implements WindowsLayout {
     return other;
   }
 
+  public saveState(): number[] {
+    return [this.lhsplit, this.rhsplit, this.vsplit];
+  }
+
+  public restoreState(values: number[]): void {
+    if (values.length !== 3) {
+      return;
+    }
+
+    const [lhsplit, rhsplit, vsplit] = values.map((value) =>
+      clip(
+        value,
+        1 - QuarterLayout.MAX_PROPORTION,
+        QuarterLayout.MAX_PROPORTION
+      )
+    );
+    this.lhsplit = lhsplit;
+    this.rhsplit = rhsplit;
+    this.vsplit = vsplit;
+  }
+
   public apply(
-    _controller: Controller,
+    controller: Controller,
     tileables: EngineWindow[],
     area: Rect
   ): void {
@@ -126,6 +148,17 @@ export default class QuarterLayout implements WindowsLayout {
         .forEach((tile) => (tile.state = WindowState.TiledAfloat));
     }
 
+    if (this.config.experimentalBackend) {
+      LayoutUtils.applyNative(
+        controller,
+        QuarterLayout.id,
+        { vsplit: this.vsplit, lhsplit: this.lhsplit, rhsplit: this.rhsplit },
+        area,
+        tileables
+      );
+      return;
+    }
+
     if (tileables.length === 1) {
       tileables[0].geometry = area;
       return;
@@ -5,10 +5,12 @@
 
 import { HalfSplitLayoutPart } from "./layout_part";
 import { FillLayoutPart } from "./layout_part";
+import LayoutUtils from "./layout_utils";
 import { WindowsLayout } from ".";
 
 import { WindowState, EngineWindow } from "../window";
 
+import { clip } from "../../util/func";
 import { Rect, RectDelta } from "../../util/rect";
 import { Config } from "../../config";
 import { Controller } from "../../controller";
@@ -38,7 +40,6 @@ export default class SpiralLayout implements WindowsLayout {
       new FillLayoutPart()
     );
     this.parts.angle = 0;
-    this.parts.gap = this.config.tileLayoutGap;
   }
 
   public adjust(
@@ -47,11 +48,12 @@ export default class SpiralLayout implements WindowsLayout {
     basis: EngineWindow,
     delta: RectDelta
   ): void {
+    this.updateGaps();
     this.parts.adjust(area, tiles, basis, delta);
   }
 
   public apply(
-    _controller: Controller,
+    controller: Controller,
     tileables: EngineWindow[],
     area: Rect
   ): void {
@@ -59,17 +61,70 @@ export default class SpiralLayout implements WindowsLayout {
 
     this.bore(tileables.length);
 
+    if (this.config.experimentalBackend) {
+      LayoutUtils.applyNative(
+        controller,
+        SpiralLayout.id,
+        { ratios: this.ratios() },
+        area,
+        tileables
+      );
+      return;
+    }
+
+    this.updateGaps();
     this.parts.apply(area, tileables).forEach((geometry, i) => {
       tileables[i].geometry = geometry;
     });
   }
 
+  public saveState(): number[] {
+    return this.ratios();
+  }
+
+  public restoreState(values: number[]): void {
+    this.bore(values.length);
+
+    let part: SpiralLayoutPart | FillLayoutPart = this.parts;
+    for (const ratio of values) {
+      if (!(part instanceof HalfSplitLayoutPart)) {
+        break;
+      }
+      part.ratio = clip(ratio, 0, 1);
+      part = part.secondary;
+    }
+  }
+
   //handleShortcut?(ctx: EngineContext, input: Shortcut, data?: any): boolean;
 
   public toString(): string {
     return "Spiral()";
   }
 
+  /**
+   * Collect the split ratios of all the nesting levels of the spiral
+   */
+  private ratios(): number[] {
+    const ratios: number[] = [];
+    let part: SpiralLayoutPart | FillLayoutPart = this.parts;
+    while (part instanceof HalfSplitLayoutPart) {
+      ratios.push(part.ratio);
+      part = part.secondary;
+    }
+    return ratios;
+  }
+
+  /**
+   * Set the configured gap on all the nesting levels
+   */
+  private updateGaps(): void {
+    let part: SpiralLayoutPart | FillLayoutPart = this.parts;
+    while (part instanceof HalfSplitLayoutPart) {
+      part.gap = this.config.tileLayoutGap;
+      part = part.secondary;
+    }
+  }
+
   private bore(depth: number): void {
     if (this.depth >= depth) {
       return;
@@ -85,7 +140,6 @@ export default class SpiralLayout implements WindowsLayout {
     let npart: SpiralLayoutPart;
     while (i < depth - 1) {
       npart = new HalfSplitLayoutPart(new FillLayoutPart(), lastFillPart);
-      npart.gap = this.config.tileLayoutGap;
       switch ((i + 1) % 4) {
         case 0:
           npart.angle = 0;
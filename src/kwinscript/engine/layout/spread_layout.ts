@@ -4,6 +4,7 @@
 // SPDX-License-Identifier: MIT
 
 import { WindowsLayout } from ".";
+import LayoutUtils from "./layout_utils";
 
 import { WindowState, EngineWindow } from "../window";
 
@@ -13,7 +14,9 @@ import {
   IncreaseMasterAreaWindowCount,
 } from "../../controller/action";
 
+import { clip } from "../../util/func";
 import { Rect } from "../../util/rect";
+import { Config } from "../../config";
 import { Controller } from "../../controller";
 import { Engine } from "..";
 
@@ -25,12 +28,15 @@ export default class SpreadLayout implements WindowsLayout {
 
   private space: number; /* in ratio */
 
-  constructor() {
+  private config: Config;
+
+  constructor(config: Config) {
+    this.config = config;
     this.space = 0.07;
   }
 
   public apply(
-    _controller: Controller,
+    controller: Controller,
     tileables: EngineWindow[],
     area: Rect
   ): void {
@@ -38,6 +44,17 @@ export default class SpreadLayout implements WindowsLayout {
     tileables.forEach((tileable) => (tileable.state = WindowState.Tiled));
     const tiles = tileables;
 
+    if (this.config.experimentalBackend) {
+      LayoutUtils.applyNative(
+        controller,
+        SpreadLayout.id,
+        { space: this.space },
+        area,
+        tiles
+      );
+      return;
+    }
+
     let numTiles = tiles.length;
     const spaceWidth = Math.floor(area.width * this.space);
     let cardWidth = area.width - spaceWidth * (numTiles - 1);
@@ -60,11 +77,21 @@ export default class SpreadLayout implements WindowsLayout {
   }
 
   public clone(): WindowsLayout {
-    const other = new SpreadLayout();
+    const other = new SpreadLayout(this.config);
     other.space = this.space;
     return other;
   }
 
+  public saveState(): number[] {
+    return [this.space];
+  }
+
+  public restoreState(values: number[]): void {
+    if (values.length === 1) {
+      this.space = clip(values[0], 0.04, 0.1);
+    }
+  }
+
   public executeAction(_engine: Engine, action: Action): void {
     if (action instanceof DecreaseMasterAreaWindowCount) {
       // TODO: define arbitrary constants
@@ -4,6 +4,7 @@
 // SPDX-License-Identifier: MIT
 
 import { WindowsLayout } from ".";
+import LayoutUtils from "./layout_utils";
 
 import { WindowState, EngineWindow } from "../window";
 
@@ -13,7 +14,9 @@ import {
   IncreaseMasterAreaWindowCount,
 } from "../../controller/action";
 
+import { clip } from "../../util/func";
 import { Rect } from "../../util/rect";
+import { Config } from "../../config";
 import { Controller } from "../../controller";
 import { Engine } from "..";
 
@@ -25,12 +28,15 @@ export default class StairLayout implements WindowsLayout {
 
   private space: number; /* in PIXELS */
 
-  constructor() {
+  private config: Config;
+
+  constructor(config: Config) {
+    this.config = config;
     this.space = 24;
   }
 
   public apply(
-    _controller: Controller,
+    controller: Controller,
     tileables: EngineWindow[],
     area: Rect
   ): void {
@@ -38,6 +44,17 @@ export default class StairLayout implements WindowsLayout {
     tileables.forEach((tileable) => (tileable.state = WindowState.Tiled));
     const tiles = tileables;
 
+    if (this.config.experimentalBackend) {
+      LayoutUtils.applyNative(
+        controller,
+        StairLayout.id,
+        { space: this.space },
+        area,
+        tiles
+      );
+      return;
+    }
+
     const len = tiles.length;
     const space = this.space;
 
@@ -56,11 +73,21 @@ export default class StairLayout implements WindowsLayout {
   }
 
   public clone(): WindowsLayout {
-    const other = new StairLayout();
+    const other = new StairLayout(this.config);
     other.space = this.space;
     return other;
   }
 
+  public saveState(): number[] {
+    return [this.space];
+  }
+
+  public restoreState(values: number[]): void {
+    if (values.length === 1) {
+      this.space = clip(Math.round(values[0]), 16, 160);
+    }
+  }
+
   public executeAction(_engine: Engine, action: Action): void {
     if (action instanceof DecreaseMasterAreaWindowCount) {
       // TODO: define arbitrary constants
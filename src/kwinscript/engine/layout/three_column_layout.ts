@@ -145,7 +145,7 @@ export default class ThreeColumnLayout implements WindowsLayout {
   }
 
   public apply(
-    _controller: Controller,
+    controller: Controller,
     tileables: EngineWindow[],
     area: Rect
   ): void {
@@ -153,6 +153,17 @@ export default class ThreeColumnLayout implements WindowsLayout {
     tileables.forEach((tileable) => (tileable.state = WindowState.Tiled));
     const tiles = tileables;
 
+    if (this.config.experimentalBackend) {
+      LayoutUtils.applyNative(
+        controller,
+        ThreeColumnLayout.id,
+        { numMaster: this.masterSize, masterRatio: this.masterRatio },
+        area,
+        tiles
+      );
+      return;
+    }
+
     if (tiles.length <= this.masterSize) {
       /* only master */
       LayoutUtils.splitAreaWeighted(
@@ -212,6 +223,24 @@ export default class ThreeColumnLayout implements WindowsLayout {
     return other;
   }
 
+  public saveState(): number[] {
+    return [this.masterRatio, this.masterSize];
+  }
+
+  public restoreState(values: number[]): void {
+    if (values.length !== 2) {
+      return;
+    }
+
+    const [masterRatio, masterSize] = values;
+    this.masterRatio = clip(
+      masterRatio,
+      ThreeColumnLayout.MIN_MASTER_RATIO,
+      ThreeColumnLayout.MAX_MASTER_RATIO
+    );
+    this.masterSize = clip(Math.round(masterSize), 1, 10);
+  }
+
   public executeAction(engine: Engine, action: Action): void {
     if (action instanceof IncreaseMasterAreaWindowCount) {
       this.resizeMaster(engine, +1);
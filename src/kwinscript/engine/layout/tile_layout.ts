@@ -4,6 +4,7 @@
 // SPDX-License-Identifier: MIT
 
 import { WindowsLayout } from ".";
+import LayoutUtils from "./layout_utils";
 import {
   RotateLayoutPart,
   HalfSplitLayoutPart,
@@ -72,12 +73,6 @@ export default class TileLayout implements WindowsLayout {
         new StackLayoutPart(this.config)
       )
     );
-
-    const masterPart = this.parts.inner;
-    masterPart.gap =
-      masterPart.primary.inner.gap =
-      masterPart.secondary.gap =
-        this.config.tileLayoutGap;
   }
 
   public adjust(
@@ -86,16 +81,34 @@ export default class TileLayout implements WindowsLayout {
     basis: EngineWindow,
     delta: RectDelta
   ): void {
+    this.updateGaps();
     this.parts.adjust(area, tiles, basis, delta);
   }
 
   public apply(
-    _controller: Controller,
+    controller: Controller,
     tileables: EngineWindow[],
     area: Rect
   ): void {
     tileables.forEach((tileable) => (tileable.state = WindowState.Tiled));
 
+    if (this.config.experimentalBackend) {
+      LayoutUtils.applyNative(
+        controller,
+        TileLayout.id,
+        {
+          numMaster: this.numMaster,
+          masterRatio: this.masterRatio,
+          angle: this.parts.angle,
+          masterAngle: this.parts.inner.primary.angle,
+        },
+        area,
+        tileables
+      );
+      return;
+    }
+
+    this.updateGaps();
     this.parts.apply(area, tileables).forEach((geometry, i) => {
       tileables[i].geometry = geometry;
     });
@@ -108,6 +121,31 @@ export default class TileLayout implements WindowsLayout {
     return other;
   }
 
+  public saveState(): number[] {
+    return [
+      this.numMaster,
+      this.masterRatio,
+      this.parts.angle,
+      this.parts.inner.primary.angle,
+    ];
+  }
+
+  public restoreState(values: number[]): void {
+    if (values.length !== 4) {
+      return;
+    }
+
+    const [numMaster, masterRatio, angle, masterAngle] = values;
+    this.numMaster = clip(Math.round(numMaster), 0, 10);
+    this.masterRatio = clip(
+      masterRatio,
+      TileLayout.MIN_MASTER_RATIO,
+      TileLayout.MAX_MASTER_RATIO
+    );
+    this.parts.angle = LayoutUtils.toAngle(angle);
+    this.parts.inner.primary.angle = LayoutUtils.toAngle(masterAngle);
+  }
+
   public executeAction(engine: Engine, action: Action): void {
     if (action instanceof DecreaseLayoutMasterAreaSize) {
       this.masterRatio = clip(
@@ -146,4 +184,15 @@ export default class TileLayout implements WindowsLayout {
   public toString(): string {
     return `TileLayout(nmaster=${this.numMaster}, ratio=${this.masterRatio})`;
   }
+
+  /**
+   * Take the gap from the config, as the layout outlives its changes
+   */
+  private updateGaps(): void {
+    const masterPart = this.parts.inner;
+    masterPart.gap =
+      masterPart.primary.inner.gap =
+      masterPart.secondary.gap =
+        this.config.tileLayoutGap;
+  }
 }
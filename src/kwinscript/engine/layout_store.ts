@@ -9,8 +9,8 @@ import { WindowsLayout } from "./layout";
 
 import { DriverSurface } from "../driver/surface";
 
-import { wrapIndex } from "../util/func";
 import { Config } from "../config";
+import { TSProxy } from "../extern/proxy";
 import MonocleLayout from "./layout/monocle_layout";
 import TileLayout from "./layout/tile_layout";
 import CascadeLayout from "./layout/cascade_layout";
@@ -20,67 +20,98 @@ import SpreadLayout from "./layout/spread_layout";
 import StairLayout from "./layout/stair_layout";
 import ThreeColumnLayout from "./layout/three_column_layout";
 
-export class LayoutStoreEntry {
-  public get currentLayout(): WindowsLayout {
-    return this.loadLayout(this.currentID);
-  }
+/**
+ * Layouts of the surfaces.
+ *
+ * Every layout has one instance, shared by all the surfaces. The instance
+ * holds the parameters of the surface, that used it last. The parameters of
+ * the other surfaces and the current layouts of all the surfaces are kept
+ * compact in the native layout state store, which also evicts the surfaces,
+ * that were not used for a long time.
+ */
+export default class LayoutStore {
+  private layouts: { [id: string]: WindowsLayout };
 
-  private currentIndex: number | null;
-  private currentID: string;
-  private layouts: { [key: string]: WindowsLayout };
-  private previousID: string;
+  /**
+   * The surfaces, whose parameters are in the shared layouts
+   */
+  private owners: { [id: string]: DriverSurface };
 
-  private config: Config;
+  /**
+   * Parameters of the new layouts, for the surfaces, that have none stored
+   */
+  private defaults: { [id: string]: number[] };
 
-  constructor(config: Config) {
-    this.config = config;
-    this.currentIndex = 0;
-    this.currentID = this.config.layoutOrder[0];
+  constructor(private config: Config, private proxy: TSProxy) {
     this.layouts = {};
-    this.previousID = this.currentID;
-
-    this.loadLayout(this.currentID);
+    this.owners = {};
+    this.defaults = {};
   }
 
-  public cycleLayout(step: -1 | 1): WindowsLayout {
-    this.previousID = this.currentID;
-    this.currentIndex =
-      this.currentIndex !== null
-        ? wrapIndex(this.currentIndex + step, this.config.layoutOrder.length)
-        : 0;
-    this.currentID = this.config.layoutOrder[this.currentIndex];
-    return this.loadLayout(this.currentID);
+  public getCurrentLayout(srf: DriverSurface): WindowsLayout {
+    return srf.ignore
+      ? FloatingLayout.instance
+      : this.loadLayout(this.proxy.currentLayout(srf.handle), srf);
   }
 
-  public toggleLayout(targetID: string): WindowsLayout {
-    const targetLayout = this.loadLayout(targetID);
-
-    // Toggle if requested, set otherwise
-    if (this.currentID === targetID) {
-      this.currentID = this.previousID;
-      this.previousID = targetID;
-    } else {
-      this.previousID = this.currentID;
-      this.currentID = targetID;
+  public cycleLayout(srf: DriverSurface, step: 1 | -1): WindowsLayout | null {
+    if (srf.ignore) {
+      return null;
     }
+    return this.loadLayout(this.proxy.cycleLayout(srf.handle, step), srf);
+  }
 
-    this.updateCurrentIndex();
-    return targetLayout;
+  public toggleLayout(
+    surf: DriverSurface,
+    layoutClassID: string
+  ): WindowsLayout | null {
+    if (surf.ignore) {
+      return null;
+    }
+    return this.loadLayout(
+      this.proxy.toggleLayout(surf.handle, layoutClassID),
+      surf
+    );
   }
 
-  private updateCurrentIndex(): void {
-    const idx = this.config.layoutOrder.indexOf(this.currentID);
-    this.currentIndex = idx === -1 ? null : idx;
+  /**
+   * Pass the parameters, that are held by the layouts, to the native store,
+   * so that they are saved
+   */
+  public flush(): void {
+    Object.keys(this.owners).forEach((id) => this.storeParameters(id));
   }
 
-  private loadLayout(ID: string): WindowsLayout {
-    let layout = this.layouts[ID];
+  /**
+   * @returns the shared layout with the parameters of the surface
+   */
+  private loadLayout(id: string, srf: DriverSurface): WindowsLayout {
+    let layout = this.layouts[id];
     if (!layout) {
-      layout = this.layouts[ID] = this.createLayoutFromId(ID);
+      layout = this.layouts[id] = this.createLayoutFromId(id);
+      this.defaults[id] = layout.saveState ? layout.saveState() : [];
     }
+
+    const owner = this.owners[id];
+    if (layout.restoreState && (!owner || owner.layoutKey !== srf.layoutKey)) {
+      this.storeParameters(id);
+
+      const values = this.proxy.layoutValues(srf.handle, id);
+      layout.restoreState(values.length > 0 ? values : this.defaults[id]);
+    }
+    this.owners[id] = srf;
+
     return layout;
   }
 
+  private storeParameters(id: string): void {
+    const layout = this.layouts[id];
+    const owner = this.owners[id];
+    if (owner && layout.saveState) {
+      this.proxy.storeLayoutValues(owner.handle, id, layout.saveState());
+    }
+  }
+
   private createLayoutFromId(id: string): WindowsLayout {
     if (id == MonocleLayout.id) {
       return new MonocleLayout(this.config);
@@ -89,9 +120,9 @@ export class LayoutStoreEntry {
     } else if (id == SpiralLayout.id) {
       return new SpiralLayout(this.config);
     } else if (id == SpreadLayout.id) {
-      return new SpreadLayout();
+      return new SpreadLayout(this.config);
     } else if (id == StairLayout.id) {
-      return new StairLayout();
+      return new StairLayout(this.config);
     } else if (id == ThreeColumnLayout.id) {
       return new ThreeColumnLayout(this.config);
     } else if (id == TileLayout.id) {
@@ -101,41 +132,3 @@ export class LayoutStoreEntry {
     }
   }
 }
-
-export default class LayoutStore {
-  private store: { [key: string]: LayoutStoreEntry };
-
-  constructor(private config: Config) {
-    this.store = {};
-  }
-
-  public getCurrentLayout(srf: DriverSurface): WindowsLayout {
-    return srf.ignore
-      ? FloatingLayout.instance
-      : this.getEntry(srf.id).currentLayout;
-  }
-
-  public cycleLayout(srf: DriverSurface, step: 1 | -1): WindowsLayout | null {
-    if (srf.ignore) {
-      return null;
-    }
-    return this.getEntry(srf.id).cycleLayout(step);
-  }
-
-  public toggleLayout(
-    surf: DriverSurface,
-    layoutClassID: string
-  ): WindowsLayout | null {
-    if (surf.ignore) {
-      return null;
-    }
-    return this.getEntry(surf.id).toggleLayout(layoutClassID);
-  }
-
-  private getEntry(key: string): LayoutStoreEntry {
-    if (!this.store[key]) {
-      this.store[key] = new LayoutStoreEntry(this.config);
-    }
-    return this.store[key];
-  }
-}
@@ -7,6 +7,7 @@ import { DriverWindow } from "../driver/window";
 import { DriverSurface } from "../driver/surface";
 
 import { Config } from "../config";
+import { TSProxy, WindowCommit, WindowProperties } from "../extern/proxy";
 import { Log } from "../util/log";
 import { Rect, RectDelta } from "../util/rect";
 
@@ -91,6 +92,12 @@ export interface EngineWindow {
    */
   readonly shouldIgnore: boolean;
 
+  /**
+   * Value of shouldFloat, when the state of the window was decided.
+   * Tells the windows, whose rules were changed since then.
+   */
+  floatedByRules: boolean;
+
   /**
    * State to which the window was asked to be changed
    * previously. This can be the same state, as the current
@@ -158,6 +165,30 @@ export interface EngineWindow {
    * I.e. make the changes visible to the end user.
    */
   commit(): void;
+
+  /**
+   * Properties, that are tracked by the native window registry
+   */
+  readonly properties: WindowProperties;
+
+  /**
+   * Update the window properties in the native window registry.
+   * Must be called, when the window is changed by KWin.
+   */
+  refresh(): void;
+
+  /**
+   * Properties, that commit would write to KWin.
+   * @returns null, if nothing would be written
+   */
+  commitRequest(): WindowCommit | null;
+
+  /**
+   * Write the properties to KWin, bypassing the commit diffing.
+   * Used to apply the requests, that are already filtered in a batch.
+   * @param request the result of commitRequest
+   */
+  applyCommit(request: WindowCommit): void;
 }
 
 export class EngineWindowImpl implements EngineWindow {
@@ -200,6 +231,8 @@ export class EngineWindowImpl implements EngineWindow {
 
   public set minimized(min: boolean) {
     this.window.minimized = min;
+    // KWin signals are not handled, while the script changes the window
+    this.refresh();
   }
 
   public get tileable(): boolean {
@@ -225,6 +258,7 @@ export class EngineWindowImpl implements EngineWindow {
   public floatGeometry: Rect;
   public geometry: Rect;
   public timestamp: number;
+  public floatedByRules: boolean;
 
   /**
    * The current state of the window.
@@ -270,6 +304,7 @@ export class EngineWindowImpl implements EngineWindow {
     }
 
     this.internalState = value;
+    this.refresh();
   }
 
   public get statePreviouslyAskedToChangeTo(): WindowState {
@@ -282,21 +317,36 @@ export class EngineWindowImpl implements EngineWindow {
 
   public set surface(srf: DriverSurface) {
     this.window.surface = srf;
+    this.refresh();
+  }
+
+  public get properties(): WindowProperties {
+    return {
+      screen: this.window.screen,
+      desktop: this.window.desktop,
+      activities: this.window.activities,
+      minimized: this.window.minimized,
+      tileable: this.tileable,
+      tiled: this.tiled,
+    };
+  }
+
+  public refresh(): void {
+    this.proxy.updateWindow(this.id, this.properties);
   }
 
   public get weight(): number {
-    const srfID = this.window.surface.id;
-    const winWeight: number | undefined = this.weightMap[srfID];
+    const key = this.window.surface.layoutKey;
+    const winWeight: number | undefined = this.weightMap[key];
     if (winWeight === undefined) {
-      this.weightMap[srfID] = 1.0;
+      this.weightMap[key] = 1.0;
       return 1.0;
     }
     return winWeight;
   }
 
   public set weight(value: number) {
-    const srfID = this.window.surface.id;
-    this.weightMap[srfID] = value;
+    this.weightMap[this.window.surface.layoutKey] = value;
   }
 
   public get isDialog(): boolean {
@@ -306,11 +356,16 @@ export class EngineWindowImpl implements EngineWindow {
   private internalState: WindowState;
   private internalStatePreviouslyAskedToChangeTo: WindowState;
   private shouldCommitFloat: boolean;
-  private weightMap: { [key: string]: number };
+  private weightMap: { [layoutKey: number]: number };
 
   private config: Config;
 
-  constructor(window: DriverWindow, config: Config, private log: Log) {
+  constructor(
+    window: DriverWindow,
+    config: Config,
+    private log: Log,
+    private proxy: TSProxy
+  ) {
     this.config = config;
 
     this.id = window.id;
@@ -323,60 +378,72 @@ export class EngineWindowImpl implements EngineWindow {
 
     this.internalState = WindowState.Unmanaged;
     this.shouldCommitFloat = this.shouldFloat;
+    this.floatedByRules = this.shouldCommitFloat;
     this.weightMap = {};
   }
 
   public commit(): void {
+    // This commit is not tracked, so the next one must not be skipped
+    this.proxy.forgetCommit(this.id);
+
+    const request = this.commitRequest();
+    if (request) {
+      this.applyCommit(request);
+    }
+  }
+
+  public commitRequest(): WindowCommit | null {
     const state = this.state;
-    // this.log.log(["Window#commit", { state: WindowState[state] }]);
+    // this.log.debug("Window#commit", () => ({ state: WindowState[state] }));
     switch (state) {
       case WindowState.NativeMaximized:
-        this.window.commit(
-          this.window.surface.workingArea,
-          undefined,
-          undefined
-        );
-        break;
+        return { id: this.id, geometry: this.window.surface.workingArea };
 
       case WindowState.NativeFullscreen:
-        this.window.commit(undefined, undefined, undefined);
-        break;
+        return null;
 
       case WindowState.Floating:
+      case WindowState.TiledAfloat:
         if (!this.shouldCommitFloat) {
-          break;
+          return null;
         }
-        this.window.commit(
-          this.floatGeometry,
-          false,
-          this.config.keepFloatAbove
-        );
-        this.shouldCommitFloat = false;
-        break;
+        return {
+          id: this.id,
+          geometry: this.floatGeometry,
+          noBorder: false,
+          keepAbove: this.config.keepFloatAbove,
+        };
 
       case WindowState.Maximized:
-        this.window.commit(this.geometry, true, false);
-        break;
+        return {
+          id: this.id,
+          geometry: this.geometry,
+          noBorder: true,
+          keepAbove: false,
+        };
 
       case WindowState.Tiled:
-        this.window.commit(this.geometry, this.config.noTileBorder, false);
-        break;
+        return {
+          id: this.id,
+          geometry: this.geometry,
+          noBorder: this.config.noTileBorder,
+          keepAbove: false,
+        };
+    }
 
-      case WindowState.TiledAfloat:
-        if (!this.shouldCommitFloat) {
-          break;
-        }
-        this.window.commit(
-          this.floatGeometry,
-          false,
-          this.config.keepFloatAbove
-        );
-        this.shouldCommitFloat = false;
-        break;
+    return null;
+  }
+
+  public applyCommit(request: WindowCommit): void {
+    this.window.commit(request.geometry, request.noBorder, request.keepAbove);
+
+    if (EngineWindowImpl.isFloatingState(this.state)) {
+      this.shouldCommitFloat = false;
     }
   }
 
   public forceSetGeometry(geometry: Rect): void {
+    this.proxy.forgetCommit(this.id);
     this.window.commit(geometry);
   }
 
@@ -4,8 +4,10 @@
 // SPDX-License-Identifier: MIT
 
 import { EngineWindow } from "./window";
+import { Direction } from ".";
 
 import { DriverSurface } from "../driver/surface";
+import { TSProxy } from "../extern/proxy";
 
 /**
  * Window storage facility with convenient window filters built-in.
@@ -37,6 +39,36 @@ export interface WindowStore {
    */
   allWindowsOn(surf: DriverSurface): EngineWindow[];
 
+  /**
+   * Return all the windows in the store on all the surfaces
+   */
+  allWindows(): EngineWindow[];
+
+  /**
+   * Find the closest visible tile in the given direction from the window.
+   * Among the equally close tiles the most recently focused one is returned.
+   * @param basis the window to look from
+   * @param dir the direction to look in
+   * @param surf the surface to look on
+   */
+  neighborOf(
+    basis: EngineWindow,
+    dir: Direction,
+    surf: DriverSurface
+  ): EngineWindow | null;
+
+  /**
+   * Start tracking the interactive move of the window over the tiles
+   */
+  beginDrag(window: EngineWindow): void;
+
+  /**
+   * Finish the interactive move of the window
+   * @returns the only tile under the center of the window on the surface,
+   * where it is dropped, or null
+   */
+  endDrag(window: EngineWindow): EngineWindow | null;
+
   /**
    * Inserts the window at the beginning
    */
@@ -70,95 +102,117 @@ export interface WindowStore {
   putWindowToMaster(window: EngineWindow): void;
 }
 
+/**
+ * Filters of the windows on a surface. Must be in sync with the native WindowRegistry::View.
+ */
+enum WindowView {
+  All,
+  Visible,
+  VisibleTileable,
+  VisibleTiled,
+  Tileable,
+}
+
+/**
+ * Window store backed by the native window registry. The registry keeps
+ * the order of the windows and the cached lists of windows on every
+ * surface, while the store maps the window ids back to the windows.
+ */
 export class WindowStoreImpl implements WindowStore {
+  private windows: { [id: string]: EngineWindow };
+
   /**
-   * @param list window list to initialize from
+   * @param proxy proxy to the native window registry
    */
-  constructor(public list: EngineWindow[] = []) {}
+  constructor(private proxy: TSProxy) {
+    this.windows = {};
+  }
 
   public move(
     srcWin: EngineWindow,
     destWin: EngineWindow,
     after?: boolean
   ): void {
-    const srcIdx = this.list.indexOf(srcWin);
-    const destIdx = this.list.indexOf(destWin);
-    if (srcIdx === -1 || destIdx === -1) {
-      return;
-    }
-
-    // Delete the source window
-    this.list.splice(srcIdx, 1);
-    // Place the source window in before destination window or after it
-    this.list.splice(after ? destIdx + 1 : destIdx, 0, srcWin);
+    this.proxy.moveWindow(srcWin.id, destWin.id, after === true);
   }
 
   public putWindowToMaster(window: EngineWindow): void {
-    const idx = this.list.indexOf(window);
-    if (idx === -1) {
-      return;
-    }
-    this.list.splice(idx, 1);
-    this.list.splice(0, 0, window);
+    this.proxy.putWindowToFront(window.id);
   }
 
   public swap(alpha: EngineWindow, beta: EngineWindow): void {
-    const alphaIndex = this.list.indexOf(alpha);
-    const betaIndex = this.list.indexOf(beta);
-    if (alphaIndex < 0 || betaIndex < 0) {
-      return;
-    }
-
-    this.list[alphaIndex] = beta;
-    this.list[betaIndex] = alpha;
-  }
-
-  public get length(): number {
-    return this.list.length;
-  }
-
-  public at(idx: number): EngineWindow {
-    return this.list[idx];
-  }
-
-  public indexOf(window: EngineWindow): number {
-    return this.list.indexOf(window);
+    this.proxy.swapWindows(alpha.id, beta.id);
   }
 
   public push(window: EngineWindow): void {
-    this.list.push(window);
+    this.windows[window.id] = window;
+    this.proxy.addWindow(window.id, window.properties, false);
   }
 
   public remove(window: EngineWindow): void {
-    const idx = this.list.indexOf(window);
-    if (idx >= 0) {
-      this.list.splice(idx, 1);
-    }
+    delete this.windows[window.id];
+    this.proxy.removeWindow(window.id);
   }
 
   public unshift(window: EngineWindow): void {
-    this.list.unshift(window);
+    this.windows[window.id] = window;
+    this.proxy.addWindow(window.id, window.properties, true);
   }
 
   public visibleWindowsOn(surf: DriverSurface): EngineWindow[] {
-    return this.list.filter((win) => win.visibleOn(surf));
+    return this.windowsOn(surf, WindowView.Visible);
   }
 
   public visibleTiledWindowsOn(surf: DriverSurface): EngineWindow[] {
-    return this.list.filter((win) => win.tiled && win.visibleOn(surf));
+    return this.windowsOn(surf, WindowView.VisibleTiled);
   }
 
   public visibleTileableWindowsOn(surf: DriverSurface): EngineWindow[] {
-    return this.list.filter((win) => win.tileable && win.visibleOn(surf));
+    return this.windowsOn(surf, WindowView.VisibleTileable);
   }
 
   public tileableWindowsOn(surf: DriverSurface): EngineWindow[] {
-    return this.list.filter(
-      (win) => win.tileable && win.surface.id === surf.id
-    );
+    return this.windowsOn(surf, WindowView.Tileable);
   }
 
   public allWindowsOn(surf: DriverSurface): EngineWindow[] {
-    return this.list.filter((win) => win.surface.id === surf.id);
+    return this.windowsOn(surf, WindowView.All);
+  }
+
+  public allWindows(): EngineWindow[] {
+    return Object.keys(this.windows).map((id) => this.windows[id]);
+  }
+
+  public neighborOf(
+    basis: EngineWindow,
+    dir: Direction,
+    surf: DriverSurface
+  ): EngineWindow | null {
+    const id = this.proxy.neighborWindow(
+      surf.handle,
+      basis.geometry.toQRect(),
+      dir
+    );
+    return id ? this.windows[id] : null;
+  }
+
+  public beginDrag(window: EngineWindow): void {
+    this.proxy.beginDrag(window.id);
+  }
+
+  public endDrag(window: EngineWindow): EngineWindow | null {
+    const [x, y] = window.actualGeometry.center;
+    const id = this.proxy.endDrag(x, y, window.surface.handle);
+    return id ? this.windows[id] : null;
+  }
+
+  private windowsOn(surf: DriverSurface, view: WindowView): EngineWindow[] {
+    const ids = this.proxy.windowsOn(surf.handle, view);
+
+    const result: EngineWindow[] = [];
+    for (let i = 0; i < ids.length; i++) {
+      result.push(this.windows[ids[i]]);
+    }
+    return result;
   }
 }
@@ -92,6 +92,11 @@ declare namespace KWin {
      */
     readonly dialog: boolean;
 
+    /**
+     * Whether the window is a dock, like a panel.
+     */
+    readonly dock: boolean;
+
     /**
      * TODO: ???
      */
@@ -227,6 +232,11 @@ declare namespace KWin {
      */
     fullScreen: boolean;
 
+    /**
+     * Emitted, when the window enters or leaves the fullscreen mode
+     */
+    fullScreenChanged: QSignal;
+
     /**
      * This property holds the geometry of the Toplevel, excluding invisible
      * portions, e.g. server-side and client-side drop-shadows, etc.
@@ -238,6 +248,11 @@ declare namespace KWin {
      */
     keepAbove: boolean;
 
+    /**
+     * @see keepAbove
+     */
+    keepAboveChanged: QSignal;
+
     /**
      * Whether the window is set to be below all
      */
@@ -253,6 +268,11 @@ declare namespace KWin {
      */
     noBorder: boolean;
 
+    /**
+     * @see noBorder
+     */
+    noBorderChanged: QSignal;
+
     /**
      * Whether the window is set to be on all desktops
      */
@@ -3,9 +3,392 @@
 
 import { Config } from "../config";
 import { Action } from "../controller/action";
+import { Rect } from "../util/rect";
+
+/**
+ * Per-surface layout parameters, understood by the native layouts.
+ * Every layout reads only the fields it uses.
+ */
+export interface LayoutParameters {
+  numMaster?: number;
+  masterRatio?: number;
+  angle?: number;
+  masterAngle?: number;
+  vsplit?: number;
+  lhsplit?: number;
+  rhsplit?: number;
+  space?: number;
+  direction?: number;
+  ratios?: number[];
+}
+
+/**
+ * Input of the native layout on one surface, @see TSProxy.applyLayouts
+ */
+export interface NativeLayoutRequest {
+  layoutId: string;
+  parameters: LayoutParameters;
+  area: QRectF;
+  weights: number[];
+}
+
+/**
+ * Structured values of a log message
+ */
+export type LogFields = Record<string, unknown>;
+
+/**
+ * Cached values of an interned surface, @see TSProxy.internSurface
+ */
+export interface SurfaceInfo {
+  id: string;
+  layoutKey: number;
+  /** Id of the surface in the trace spans, @see TSProxy.traceEnd */
+  traceId: number;
+  ignore: boolean;
+  workingArea: QRectF;
+}
+
+/**
+ * Window properties to write to KWin. Unset properties are left as is.
+ */
+export interface WindowCommit {
+  id: string;
+  geometry?: Rect;
+  noBorder?: boolean;
+  keepAbove?: boolean;
+}
+
+/**
+ * Window properties, that are tracked by the native window registry
+ */
+export interface WindowProperties {
+  screen: number;
+  desktop: number;
+  activities: string[];
+  minimized: boolean;
+  tileable: boolean;
+  tiled: boolean;
+}
+
+/**
+ * Working area of the screen on the virtual desktop
+ */
+export interface RecordedArea {
+  screen: number;
+  desktop: number;
+  area: QRectF;
+}
+
+/**
+ * State of the workspace, that the recorded events start from
+ */
+export interface RecordedWorkspace {
+  numScreens: number;
+  desktops: number;
+  currentDesktop: number;
+  activeScreen: number;
+  currentActivity: string;
+  activities: { id: string; name: string }[];
+  areas: RecordedArea[];
+  clients: KWin.Client[];
+}
 
 export interface TSProxy {
+  /**
+   * Number, that changes every time the configuration is reloaded
+   */
+  readonly configGeneration: number;
+
+  /**
+   * Settings, that differ from the previous config. A combination of
+   * ConfigChange flags.
+   */
+  readonly configChanges: number;
+
+  /**
+   * Emitted, when the configuration has changed and jsConfig() returns the new one
+   */
+  readonly configChanged: QSignal;
+
+  /**
+   * Emitted once per event loop iteration, when the scheduled arrangement
+   * should be done. Arguments: surfaces: number[] with the surface handles,
+   * allSurfaces: boolean
+   */
+  readonly arrangeRequested: QSignal;
+
+  /**
+   * Emitted, when the parameters of the layouts should be passed to
+   * storeLayoutValues
+   */
+  readonly layoutStateRequested: QSignal;
+
+  /**
+   * Number of window commits, that were sent to KWin
+   */
+  readonly commitsSent: number;
+
+  /**
+   * Number of window commits, that were skipped, as nothing has changed
+   */
+  readonly commitsSkipped: number;
+
+  /**
+   * Whether the events are being recorded
+   */
+  readonly recording: boolean;
+
+  /**
+   * Emitted, when the recording starts or stops. The state of the workspace
+   * must be passed to recordWorkspace, when the recording starts.
+   */
+  readonly recordingChanged: QSignal;
+
   jsConfig(): Config;
   registerShortcut(data: Action): void;
-  log(value: any): void;
+  registerShortcuts(data: Action[]): void;
+
+  /**
+   * Log the message with the given level. Nothing is evaluated, if the level
+   * is disabled for the logging category.
+   * @param fields object or function, returning an object, whose properties
+   * are appended to the message as key=value pairs
+   */
+  logDebug(message: string, fields?: LogFields | (() => LogFields)): void;
+  logInfo(message: string, fields?: LogFields | (() => LogFields)): void;
+  logWarning(message: string, fields?: LogFields | (() => LogFields)): void;
+
+  /**
+   * Compute the geometries of the tiles with the native layout implementation
+   * and limit their width
+   * @returns x, y, width and height of every tile, that fits into the
+   * layout, as 32-bit integers. Read it with Int32Array.
+   */
+  applyLayout(
+    layoutId: string,
+    parameters: LayoutParameters,
+    area: QRectF,
+    weights: number[]
+  ): ArrayBuffer;
+
+  /**
+   * Compute the native layouts of several surfaces at once. The surfaces are
+   * arranged in parallel.
+   * @returns the result of applyLayout for every request
+   */
+  applyLayouts(requests: NativeLayoutRequest[]): ArrayBuffer[];
+
+  /**
+   * Check the window against the window rules from the config
+   * @returns a combination of WindowRule flags
+   */
+  classifyWindow(
+    resourceClass: string,
+    resourceName: string,
+    windowRole: string,
+    caption: string
+  ): number;
+
+  /**
+   * @returns handle of the surface, the same for every call with the same
+   * screen, activity and desktop
+   */
+  internSurface(screen: number, activity: string, desktop: number): number;
+
+  /**
+   * @returns the cached values of the surface or null, if they were invalidated
+   */
+  surfaceInfo(surface: number): SurfaceInfo | null;
+
+  /**
+   * Check the surface against the config and cache it with its working area
+   * until the next invalidateSurfaces
+   */
+  cacheSurface(
+    surface: number,
+    activityName: string,
+    workingArea: QRectF
+  ): SurfaceInfo;
+
+  /**
+   * Drop the cached working areas of all the surfaces
+   */
+  invalidateSurfaces(): void;
+
+  /**
+   * @returns layout key of the surfaces with the given id
+   */
+  surfaceLayoutKey(surfaceId: string): number;
+
+  /**
+   * Request the arrangement of the surface. The requests made during one
+   * event loop iteration are coalesced.
+   */
+  scheduleArrange(surface: number): void;
+
+  /**
+   * Request the arrangement of all the visible surfaces
+   */
+  scheduleArrangeAll(): void;
+
+  /**
+   * Find the commits, that change anything since the last commit of the same
+   * window. The commits are remembered as sent.
+   * @returns indices of the commits, that must be applied
+   */
+  filterCommits(commits: WindowCommit[]): number[];
+
+  /**
+   * Write the values of the commit to the client and remember them, so that
+   * their change signals are recognised by consumeEcho
+   */
+  writeWindow(client: KWin.Client, commit: WindowCommit): void;
+
+  /**
+   * Check, whether the change of the client property is the echo of
+   * writeWindow. Otherwise the last commit of the window is forgotten.
+   * @param property one of EchoProperty values
+   * @returns whether the change must be ignored
+   */
+  consumeEcho(
+    client: KWin.Client,
+    windowId: string,
+    property: number
+  ): boolean;
+
+  /**
+   * Forget the last commit of the window, so that the next one is always sent.
+   * Must be called, when the window was changed outside of filterCommits.
+   */
+  forgetCommit(windowId: string): void;
+
+  /**
+   * Add the window to the native window registry
+   * @param front whether to put the window at the beginning of the list
+   */
+  addWindow(id: string, properties: WindowProperties, front: boolean): void;
+  removeWindow(id: string): void;
+  updateWindow(id: string, properties: WindowProperties): void;
+  moveWindow(source: string, destination: string, after: boolean): void;
+  swapWindows(alpha: string, beta: string): void;
+  putWindowToFront(id: string): void;
+
+  /**
+   * @param view one of the WindowView values
+   * @returns ids of the windows on the surface in their order
+   */
+  windowsOn(surface: number, view: number): string[];
+
+  /**
+   * Mark the window as the most recently focused one
+   */
+  setWindowFocused(id: string): void;
+
+  /**
+   * Find the closest tiled window in the direction from the given area.
+   * Among the equally close windows the most recently focused one wins.
+   * @returns id of the window or an empty string if there is none
+   */
+  neighborWindow(surface: number, basis: QRectF, direction: string): string;
+
+  /**
+   * Start an interactive move of the window
+   */
+  beginDrag(windowId: string): void;
+
+  /**
+   * Finish the interactive move. The drop zones are the layout geometries of
+   * the tiles on the surface, where the window is dropped.
+   * @param surface handle of the surface, that the window is dropped on
+   * @returns id of the only tile under the center of the window or an empty
+   * string
+   */
+  endDrag(x: number, y: number, surface: number): string;
+
+  /**
+   * Intern the name or the detail of the trace spans. Must be called once,
+   * when the span is set up, and not for every span.
+   * @returns id of the string, that is passed to traceEnd
+   */
+  traceName(name: string): number;
+
+  /**
+   * Begin a trace span
+   * @returns timestamp of the beginning, that must be passed to traceEnd
+   */
+  traceBegin(): number;
+
+  /**
+   * Record the trace span, that began at the given timestamp and ends now
+   * @param name id of the span name, e.g. "arrange", @see traceName
+   * @param detail optional id of the detail, e.g. the surface trace id
+   */
+  traceEnd(name: number, start: number, detail?: number): void;
+
+  /**
+   * Record the "arrange" trace spans of the surface, and count the time of
+   * its layout and of its commit in the metrics of the layout. The commit
+   * ends now.
+   * @param surfaceTraceId trace id of the surface, @see SurfaceInfo
+   */
+  arrangeEnd(
+    surfaceTraceId: number,
+    layoutId: string,
+    layoutStart: number,
+    layoutEnd: number,
+    commitStart: number
+  ): void;
+
+  /**
+   * Restore the window order and the layouts, saved by the previous instance
+   * of the script. Must be called once, after the windows are managed and
+   * before the first arrangement.
+   */
+  restoreState(): void;
+
+  /**
+   * @returns id of the current layout of the surface
+   */
+  currentLayout(surface: number): string;
+
+  /**
+   * Switch the surface to the next or the previous enabled layout
+   * @returns id of the new current layout
+   */
+  cycleLayout(surface: number, step: number): string;
+
+  /**
+   * Switch the surface to the layout or back to the previous one
+   * @returns id of the new current layout
+   */
+  toggleLayout(surface: number, layoutId: string): string;
+
+  /**
+   * @returns parameters of the layout on the surface, returned by saveState
+   * of the layout, or an empty array, if there are none stored
+   */
+  layoutValues(surface: number, layoutId: string): number[];
+
+  /**
+   * Remember the parameters of the layout on the surface
+   */
+  storeLayoutValues(surface: number, layoutId: string, values: number[]): void;
+
+  /**
+   * Write the state of the workspace, that the recorded events start from
+   */
+  recordWorkspace(workspace: RecordedWorkspace): void;
+
+  /**
+   * Record the event, that the script has received from KWin
+   * @param type one of the RecordedEvent values
+   * @param client the client of the event or null for the workspace events
+   * @param value argument of the workspace signal, e.g. the new desktop
+   */
+  recordEvent(
+    type: number,
+    client: KWin.Client | null,
+    value?: number | string
+  ): void;
 }
@@ -16,7 +16,8 @@ export function init(
   kwinScriptingApi: KWin.Api,
   proxy: TSProxy
 ): Controller | null {
-  const config = proxy.jsConfig();
+  // The native config is frozen and shared, so work on a copy
+  const config = Object.assign({}, proxy.jsConfig());
 
   const logger = new LogImpl(proxy);
 
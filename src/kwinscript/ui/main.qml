@@ -16,7 +16,7 @@ Item {
     Component.onCompleted: {
         // Init core
         core.init();
-        core.proxy.log("Initiating Bismuth: Plasma Tiling Window script!");
+        core.proxy.logInfo("Initiating Bismuth: Plasma Tiling Window script!");
         const qmlObjects = {
             "scriptRoot": scriptRoot,
             "activityInfo": activityInfo,
@@ -31,7 +31,7 @@ Item {
         scriptRoot.controller = Bismuth.init(qmlObjects, kwinScriptingAPI, core.proxy);
     }
     Component.onDestruction: {
-        core.proxy.log("Calling event hooks destructors... Goodbye.");
+        core.proxy.logDebug("Calling event hooks destructors... Goodbye.");
         if (scriptRoot.controller)
             scriptRoot.controller.drop();
 
@@ -27,21 +27,6 @@ export function slide(value: number, step: number): number {
   return Math.floor(value / step + 1.000001) * step;
 }
 
-/**
- * Find the words in the string.
- * @param str the string to search words in
- * @param words the words to be searched
- * @returns index of a word, that was found in the string first. -1 if none of the words were found.
- */
-export function matchWords(str: string, words: string[]): number {
-  for (let i = 0; i < words.length; i++) {
-    if (str.indexOf(words[i]) >= 0) {
-      return i;
-    }
-  }
-  return -1;
-}
-
 export function wrapIndex(index: number, length: number): number {
   if (index < 0) {
     return index + length;
@@ -3,20 +3,42 @@
 //
 // SPDX-License-Identifier: MIT
 
-import { TSProxy } from "../extern/proxy";
+import { LogFields, TSProxy } from "../extern/proxy";
 
-type LogType = string | Record<string, unknown> | LogType[];
+/**
+ * Set at build time. When false, debug messages are compiled out.
+ */
+declare const BISMUTH_DEBUG_LOGGING: boolean;
+
+/**
+ * Leveled logger.
+ *
+ * Fields are passed as a function, that is called only if the message is
+ * actually printed, so that disabled messages do not cost stringification.
+ */
 export interface Log {
-  log(str: LogType): void;
+  debug(message: string, fields?: () => LogFields): void;
+  info(message: string, fields?: () => LogFields): void;
+  warning(message: string, fields?: () => LogFields): void;
 }
 
 /**
- * Standard logger
+ * Logger, that writes to the org.kde.bismuth logging category
  */
 export class LogImpl implements Log {
   constructor(private proxy: TSProxy) {}
 
-  public log(logObj: LogType): void {
-    this.proxy.log(logObj);
+  public debug(message: string, fields?: () => LogFields): void {
+    if (BISMUTH_DEBUG_LOGGING) {
+      this.proxy.logDebug(message, fields);
+    }
+  }
+
+  public info(message: string, fields?: () => LogFields): void {
+    this.proxy.logInfo(message, fields);
+  }
+
+  public warning(message: string, fields?: () => LogFields): void {
+    this.proxy.logWarning(message, fields);
   }
 }
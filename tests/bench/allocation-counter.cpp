@@ -0,0 +1,134 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include "allocation-counter.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+std::atomic<quint64> s_allocationCount{0};
+std::atomic<quint64> s_deallocationCount{0};
+
+void countAllocation()
+{
+    s_allocationCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+void countDeallocation(void *pointer)
+{
+    // Freeing a null pointer does nothing and is not worth counting
+    if (pointer) {
+        s_deallocationCount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+}
+
+#if defined(__GLIBC__)
+
+// The C allocator is replaced, so that the allocations of Qt containers,
+// strings and the worker threads are counted too. The default operator new
+// of libstdc++ allocates with malloc, so it is counted here as well.
+extern "C" {
+void *__libc_malloc(std::size_t size);
+void *__libc_calloc(std::size_t count, std::size_t size);
+void *__libc_realloc(void *pointer, std::size_t size);
+void __libc_free(void *pointer);
+
+void *malloc(std::size_t size) noexcept
+{
+    countAllocation();
+    return __libc_malloc(size);
+}
+
+void *calloc(std::size_t count, std::size_t size) noexcept
+{
+    countAllocation();
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *pointer, std::size_t size) noexcept
+{
+    // Shrinking or growing in place is still a call to the allocator
+    countAllocation();
+    return __libc_realloc(pointer, size);
+}
+
+void free(void *pointer) noexcept
+{
+    countDeallocation(pointer);
+    __libc_free(pointer);
+}
+}
+
+#else
+
+// Without glibc only the C++ allocations are counted
+namespace
+{
+void *allocate(std::size_t size)
+{
+    countAllocation();
+
+    // Zero-sized allocations must still return a unique pointer
+    if (auto pointer = std::malloc(size ? size : 1)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void deallocate(void *pointer)
+{
+    countDeallocation(pointer);
+    std::free(pointer);
+}
+}
+
+void *operator new(std::size_t size)
+{
+    return allocate(size);
+}
+
+void *operator new[](std::size_t size)
+{
+    return allocate(size);
+}
+
+void operator delete(void *pointer) noexcept
+{
+    deallocate(pointer);
+}
+
+void operator delete[](void *pointer) noexcept
+{
+    deallocate(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept
+{
+    deallocate(pointer);
+}
+
+void operator delete[](void *pointer, std::size_t) noexcept
+{
+    deallocate(pointer);
+}
+
+#endif
+
+namespace Bismuth
+{
+
+quint64 allocationCount()
+{
+    return s_allocationCount.load(std::memory_order_relaxed);
+}
+
+quint64 deallocationCount()
+{
+    return s_deallocationCount.load(std::memory_order_relaxed);
+}
+
+}
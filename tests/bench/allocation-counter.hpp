@@ -0,0 +1,23 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <QtGlobal>
+
+namespace Bismuth
+{
+
+/**
+ * @return the number of heap allocations, made by the process so far.
+ * Counted by the replaced malloc, calloc and realloc, or by the replaced
+ * global operator new, where the C allocator cannot be replaced.
+ */
+quint64 allocationCount();
+
+/**
+ * @return the number of heap blocks, freed by the process so far
+ */
+quint64 deallocationCount();
+
+}
@@ -0,0 +1,210 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include "allocation-counter.hpp"
+#include "config-snapshot.hpp"
+#include "engine/engine.hpp"
+#include "workspace.hpp"
+
+using namespace Bismuth;
+
+namespace
+{
+/**
+ * Iterations before the measurements, so that the caches are warm
+ */
+constexpr int warmupIterations = 10;
+
+/**
+ * Timings and allocations of one operation over all the iterations
+ */
+struct Samples {
+    std::vector<qint64> nanoseconds;
+    quint64 allocations = 0;
+    quint64 deallocations = 0;
+
+    template<typename Operation>
+    void measure(Operation &&operation)
+    {
+        const auto allocationsBefore = allocationCount();
+        const auto deallocationsBefore = deallocationCount();
+        const auto start = std::chrono::steady_clock::now();
+
+        operation();
+
+        const auto end = std::chrono::steady_clock::now();
+        allocations += allocationCount() - allocationsBefore;
+        deallocations += deallocationCount() - deallocationsBefore;
+        nanoseconds.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    }
+
+    QJsonObject summary()
+    {
+        std::sort(nanoseconds.begin(), nanoseconds.end());
+
+        auto percentile = [this](qreal fraction) {
+            if (nanoseconds.empty()) {
+                return qint64(0);
+            }
+            const auto rank = static_cast<std::size_t>(std::ceil(fraction * nanoseconds.size()));
+            return nanoseconds[std::clamp<std::size_t>(rank, 1, nanoseconds.size()) - 1];
+        };
+
+        const auto count = std::max<std::size_t>(nanoseconds.size(), 1);
+        return QJsonObject{
+            {QStringLiteral("p50Ns"), percentile(0.5)},
+            {QStringLiteral("p99Ns"), percentile(0.99)},
+            {QStringLiteral("allocationsPerOp"), static_cast<qreal>(allocations) / count},
+            {QStringLiteral("deallocationsPerOp"), static_cast<qreal>(deallocations) / count},
+        };
+    }
+};
+
+QJsonObject runWorkload(const Engine &engine, const QString &layoutId, int screenCount, int windowCount, int iterations)
+{
+    auto workspace = Workspace(engine, layoutId, screenCount, windowCount);
+
+    for (auto i = 0; i < warmupIterations; ++i) {
+        workspace.touch();
+        workspace.arrange();
+        workspace.arrangeParallel();
+        workspace.commit();
+        workspace.focus();
+    }
+
+    auto arrange = Samples();
+    auto arrangeUncached = Samples();
+    auto arrangeParallel = Samples();
+    auto commit = Samples();
+    auto commitUnchanged = Samples();
+    auto focus = Samples();
+
+    for (auto i = 0; i < iterations; ++i) {
+        workspace.touch();
+        arrange.measure([&] {
+            workspace.arrange();
+        });
+        // Same geometries, computed in one batch, i.e. on the worker threads,
+        // when there are enough tiles
+        arrangeParallel.measure([&] {
+            workspace.arrangeParallel();
+        });
+        commit.measure([&] {
+            workspace.commit();
+        });
+        // The same geometries again, i.e. everything is skipped
+        commitUnchanged.measure([&] {
+            workspace.commit();
+        });
+        // The first lookup after the commit rebuilds the spatial index
+        focus.measure([&] {
+            workspace.focus();
+        });
+        // Tiling areas, that were never arranged, i.e. nothing is memoized.
+        // The other arrangements alternate between two areas.
+        workspace.shift();
+        arrangeUncached.measure([&] {
+            workspace.arrange();
+        });
+    }
+
+    return QJsonObject{
+        {QStringLiteral("layout"), layoutId},
+        {QStringLiteral("screens"), screenCount},
+        {QStringLiteral("windows"), windowCount},
+        {QStringLiteral("tiled"), workspace.tiledCount()},
+        {QStringLiteral("arrange"), arrange.summary()},
+        {QStringLiteral("arrangeUncached"), arrangeUncached.summary()},
+        {QStringLiteral("arrangeParallel"), arrangeParallel.summary()},
+        {QStringLiteral("commit"), commit.summary()},
+        {QStringLiteral("commitUnchanged"), commitUnchanged.summary()},
+        {QStringLiteral("focus"), focus.summary()},
+    };
+}
+}
+
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Bismuth arrange benchmark"));
+    parser.addHelpOption();
+
+    auto iterationsOption = QCommandLineOption(QStringLiteral("iterations"), QStringLiteral("Number of measured iterations per workload"), QStringLiteral("count"), QStringLiteral("200"));
+    auto outputOption = QCommandLineOption(QStringLiteral("output"), QStringLiteral("JSON file to write the results to, stdout by default"), QStringLiteral("file"));
+    parser.addOption(iterationsOption);
+    parser.addOption(outputOption);
+    parser.process(app);
+
+    const auto iterations = std::max(parser.value(iterationsOption).toInt(), 1);
+
+    auto config = std::make_shared<ConfigSnapshot>();
+    config->tileLayoutGap = 8;
+    auto engine = Engine(config);
+
+    // The same layouts and order as in the default config, see ConfigSnapshot::fromConfig
+    const auto layoutIds = QStringList{
+        QStringLiteral("TileLayout"),
+        QStringLiteral("MonocleLayout"),
+        QStringLiteral("ThreeColumnLayout"),
+        QStringLiteral("SpreadLayout"),
+        QStringLiteral("StairLayout"),
+        QStringLiteral("SpiralLayout"),
+        QStringLiteral("QuarterLayout"),
+        QStringLiteral("FloatingLayout"),
+    };
+    const auto windowCounts = {1, 10, 50, 100, 250, 500};
+
+    auto results = QJsonArray();
+    auto skipped = QJsonArray();
+    for (const auto &layoutId : layoutIds) {
+        // Floating layout does not place the windows, so there is nothing to measure
+        if (!engine.layout(layoutId)) {
+            skipped.append(layoutId);
+            continue;
+        }
+
+        for (auto screenCount = 1; screenCount <= 4; ++screenCount) {
+            for (auto windowCount : windowCounts) {
+                results.append(runWorkload(engine, layoutId, screenCount, windowCount, iterations));
+            }
+        }
+    }
+
+    const auto report = QJsonObject{
+        {QStringLiteral("version"), QStringLiteral(BISMUTH_VERSION)},
+        {QStringLiteral("iterations"), iterations},
+        {QStringLiteral("results"), results},
+        {QStringLiteral("skippedLayouts"), skipped},
+    };
+    const auto json = QJsonDocument(report).toJson();
+
+    if (!parser.isSet(outputOption)) {
+        std::fwrite(json.constData(), 1, json.size(), stdout);
+        return 0;
+    }
+
+    QFile output(parser.value(outputOption));
+    if (!output.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCritical("Cannot open %s for writing", qPrintable(output.fileName()));
+        return 1;
+    }
+    output.write(json);
+
+    return 0;
+}
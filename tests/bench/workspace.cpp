@@ -0,0 +1,174 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include "workspace.hpp"
+
+#include <algorithm>
+
+namespace Bismuth
+{
+
+namespace
+{
+constexpr int screenWidth = 1920;
+constexpr int screenHeight = 1080;
+
+/**
+ * Width, by which the tiling area shrinks on every other arrange, so that
+ * every arrange produces new geometries
+ */
+constexpr int areaStep = 16;
+
+/**
+ * Number of the distinct heights of the shifted tiling area. Greater, than
+ * the number of the results, that a layout remembers.
+ */
+constexpr int shiftedHeights = 512;
+}
+
+Workspace::Workspace(const Engine &engine, const QString &layoutId, int screenCount, int windowCount)
+    : m_engine(engine)
+    , m_layoutId(layoutId)
+    , m_parameters()
+    , m_screens()
+    , m_windowIds()
+    , m_windowProperties()
+    , m_weights()
+    , m_requests()
+    , m_results()
+    , m_registry()
+    , m_commitTable()
+{
+    if (auto layout = m_engine.layout(layoutId)) {
+        m_parameters = layout->defaultParameters();
+    }
+
+    const auto activity = QStringLiteral("bench");
+    for (auto screen = 0; screen < screenCount; ++screen) {
+        m_screens.push_back({SurfaceKey{screen, 1, activity}, QRect(screen * screenWidth, 0, screenWidth, screenHeight), {}, {}});
+    }
+
+    for (auto i = 0; i < windowCount; ++i) {
+        auto properties = WindowProperties();
+        properties.screen = i % screenCount;
+        properties.desktop = 1;
+        properties.minimized = i % 10 == 9;
+        properties.tileable = i % 10 >= 2;
+        properties.tiled = properties.tileable;
+
+        auto id = QStringLiteral("window-%1").arg(i);
+        m_registry.add(id, properties);
+        m_windowIds.push_back(std::move(id));
+        m_windowProperties.push_back(properties);
+    }
+}
+
+void Workspace::touch()
+{
+    ++m_iteration;
+
+    // Every screen has one window, that changed, e.g. its caption
+    const auto windowCount = static_cast<int>(m_windowIds.size());
+    for (auto screen = 0; screen < static_cast<int>(m_screens.size()) && screen < windowCount; ++screen) {
+        m_registry.update(m_windowIds[screen], m_windowProperties[screen]);
+    }
+
+    for (auto &screen : m_screens) {
+        screen.area.setWidth(screenWidth - (m_iteration % 2) * areaStep);
+        screen.area.setHeight(screenHeight);
+    }
+}
+
+void Workspace::shift()
+{
+    for (auto &screen : m_screens) {
+        screen.area.setHeight(screenHeight - 1 - m_iteration % shiftedHeights);
+    }
+}
+
+void Workspace::arrange()
+{
+    for (auto &screen : m_screens) {
+        const auto &tiles = m_registry.windowsOn(screen.surface, WindowRegistry::View::VisibleTiled);
+        screen.tiles.assign(tiles.cbegin(), tiles.cend());
+
+        m_weights.assign(tiles.size(), 1);
+        m_engine.arrange(m_layoutId, m_parameters, screen.area, m_weights, screen.geometries);
+    }
+}
+
+void Workspace::arrangeParallel()
+{
+    m_requests.resize(m_screens.size());
+    for (auto i = std::size_t(0); i < m_screens.size(); ++i) {
+        auto &screen = m_screens[i];
+        const auto &tiles = m_registry.windowsOn(screen.surface, WindowRegistry::View::VisibleTiled);
+        screen.tiles.assign(tiles.cbegin(), tiles.cend());
+
+        auto &request = m_requests[i];
+        request.layoutId = m_layoutId;
+        request.parameters = m_parameters;
+        request.area = screen.area;
+        request.weights.assign(tiles.size(), 1);
+    }
+
+    m_engine.arrange(m_requests, m_results);
+
+    // The buffers are swapped, so that both keep their memory for the next batch
+    for (auto i = std::size_t(0); i < m_screens.size(); ++i) {
+        std::swap(m_screens[i].geometries, m_results[i]);
+    }
+}
+
+int Workspace::commit()
+{
+    auto sent = 0;
+    for (auto &screen : m_screens) {
+        const auto count = std::min(static_cast<int>(screen.tiles.size()), screen.geometries.size());
+        for (auto i = 0; i < count; ++i) {
+            auto commit = WindowCommit();
+            commit.geometry = screen.geometries.at(i);
+            if (m_commitTable.update(screen.tiles[i], commit)) {
+                ++sent;
+            }
+            m_registry.setGeometry(screen.tiles[i], *commit.geometry);
+        }
+    }
+    return sent;
+}
+
+int Workspace::focus()
+{
+    const auto &screen = m_screens.front();
+    const auto count = std::min(static_cast<int>(screen.tiles.size()), screen.geometries.size());
+    if (count == 0) {
+        return 0;
+    }
+
+    const auto current = m_iteration % count;
+    const auto basis = screen.geometries.at(current);
+
+    auto found = 0;
+    auto next = QString();
+    for (auto direction : {SpatialIndex::Direction::Up, SpatialIndex::Direction::Down, SpatialIndex::Direction::Left, SpatialIndex::Direction::Right}) {
+        auto neighbor = m_registry.neighbor(screen.surface, basis, direction);
+        if (!neighbor.isEmpty()) {
+            ++found;
+            next = std::move(neighbor);
+        }
+    }
+
+    if (!next.isEmpty()) {
+        m_registry.setFocused(next);
+    }
+    return found;
+}
+
+int Workspace::tiledCount() const
+{
+    return static_cast<int>(std::count_if(m_windowProperties.cbegin(), m_windowProperties.cend(), [](const WindowProperties &properties) {
+        return properties.tiled && !properties.minimized;
+    }));
+}
+
+}
@@ -0,0 +1,93 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <QRect>
+#include <QString>
+
+#include <vector>
+
+#include "commit-table.hpp"
+#include "engine/engine.hpp"
+#include "window-registry.hpp"
+
+namespace Bismuth
+{
+
+/**
+ * Synthetic workspace, that drives the native parts of the script the same
+ * way the TypeScript backend does during an arrange.
+ *
+ * Windows are spread over the screens in turns. Every tenth window is
+ * minimized, and two in ten are floating, the rest are tiled.
+ */
+class Workspace
+{
+public:
+    Workspace(const Engine &engine, const QString &layoutId, int screenCount, int windowCount);
+
+    /**
+     * Emulate an event, that makes the workspace arrange again: change a
+     * window on every screen and alternate the tiling area.
+     */
+    void touch();
+
+    /**
+     * Change the tiling areas to the ones, that were never arranged before,
+     * so that the next arrange computes the layouts instead of copying
+     * their memoized results
+     */
+    void shift();
+
+    /**
+     * Compute the geometries of the tiles on all the screens
+     */
+    void arrange();
+
+    /**
+     * Compute the geometries of the tiles on all the screens in one batch,
+     * the way the screens are arranged at once on the worker threads
+     */
+    void arrangeParallel();
+
+    /**
+     * Pass the computed geometries through the commit table and the registry
+     * @return the number of commits, that would be sent to KWin
+     */
+    int commit();
+
+    /**
+     * Look for the neighbors of a tile in every direction and focus one of them
+     * @return the number of neighbors found
+     */
+    int focus();
+
+    int tiledCount() const;
+
+private:
+    struct Screen {
+        SurfaceKey surface;
+        QRect area;
+        std::vector<QString> tiles; ///< Tiled windows from the last arrange
+        GeometryBuffer geometries; ///< Their geometries
+    };
+
+    const Engine &m_engine;
+    QString m_layoutId;
+    LayoutParameters m_parameters;
+
+    std::vector<Screen> m_screens;
+    std::vector<QString> m_windowIds;
+    std::vector<WindowProperties> m_windowProperties;
+    std::vector<qreal> m_weights;
+    std::vector<ArrangeRequest> m_requests; ///< One for every screen, kept between the batches
+    std::vector<GeometryBuffer> m_results;
+
+    WindowRegistry m_registry;
+    CommitTable m_commitTable;
+
+    int m_iteration = 0;
+};
+
+}
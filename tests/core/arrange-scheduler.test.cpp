@@ -0,0 +1,67 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include <doctest/doctest.h>
+
+#include <QCoreApplication>
+#include <QSignalSpy>
+
+#include "arrange-scheduler.hpp"
+
+using namespace Bismuth;
+
+TEST_CASE("Arrange Scheduler")
+{
+    auto scheduler = ArrangeScheduler();
+    auto spy = QSignalSpy(&scheduler, &ArrangeScheduler::arrangeRequested);
+
+    SUBCASE("Nothing is emitted without requests")
+    {
+        QCoreApplication::processEvents();
+
+        CHECK_FALSE(scheduler.pending());
+        CHECK(spy.count() == 0);
+    }
+
+    SUBCASE("Requests of one iteration are coalesced")
+    {
+        scheduler.schedule(3);
+        scheduler.schedule(1);
+        scheduler.schedule(3);
+        CHECK(scheduler.pending());
+        CHECK(spy.count() == 0);
+
+        QCoreApplication::processEvents();
+
+        CHECK_FALSE(scheduler.pending());
+        REQUIRE(spy.count() == 1);
+        CHECK(spy.at(0).at(0).value<QList<int>>() == QList<int>{3, 1});
+        CHECK(spy.at(0).at(1).toBool() == false);
+    }
+
+    SUBCASE("Arrangement of all the surfaces takes over the single surfaces")
+    {
+        scheduler.schedule(0);
+        scheduler.scheduleAll();
+        scheduler.schedule(1);
+
+        QCoreApplication::processEvents();
+
+        REQUIRE(spy.count() == 1);
+        CHECK(spy.at(0).at(0).value<QList<int>>().isEmpty());
+        CHECK(spy.at(0).at(1).toBool() == true);
+    }
+
+    SUBCASE("Requests of the next iteration are emitted separately")
+    {
+        scheduler.schedule(0);
+        QCoreApplication::processEvents();
+
+        scheduler.schedule(0);
+        QCoreApplication::processEvents();
+
+        REQUIRE(spy.count() == 2);
+        CHECK(spy.at(1).at(0).value<QList<int>>() == QList<int>{0});
+        CHECK(spy.at(1).at(1).toBool() == false);
+    }
+}
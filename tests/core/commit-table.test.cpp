@@ -0,0 +1,73 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include <doctest/doctest.h>
+
+#include "commit-table.hpp"
+
+using namespace Bismuth;
+
+TEST_CASE("Commit Table")
+{
+    const auto window = QStringLiteral("window");
+    const auto geometry = QRect(0, 0, 100, 100);
+
+    auto table = CommitTable();
+
+    SUBCASE("First commit is always sent")
+    {
+        CHECK(table.update(window, WindowCommit{geometry, true, false}));
+        CHECK(table.sentCount() == 1);
+        CHECK(table.skippedCount() == 0);
+    }
+
+    SUBCASE("Unchanged commits are skipped")
+    {
+        table.update(window, WindowCommit{geometry, true, false});
+
+        CHECK_FALSE(table.update(window, WindowCommit{geometry, true, false}));
+        CHECK_FALSE(table.update(window, WindowCommit{geometry, {}, {}}));
+        CHECK(table.sentCount() == 1);
+        CHECK(table.skippedCount() == 2);
+    }
+
+    SUBCASE("Any changed field makes the commit be sent")
+    {
+        table.update(window, WindowCommit{geometry, true, false});
+
+        CHECK(table.update(window, WindowCommit{QRect(0, 0, 50, 100), {}, {}}));
+        CHECK(table.update(window, WindowCommit{{}, false, {}}));
+        CHECK(table.update(window, WindowCommit{{}, {}, true}));
+
+        // The fields, that were not set, keep their committed values
+        CHECK_FALSE(table.update(window, WindowCommit{QRect(0, 0, 50, 100), false, true}));
+    }
+
+    SUBCASE("Windows are tracked separately")
+    {
+        table.update(window, WindowCommit{geometry, {}, {}});
+
+        CHECK(table.update(QStringLiteral("other"), WindowCommit{geometry, {}, {}}));
+    }
+
+    SUBCASE("Forgotten window is sent again")
+    {
+        table.update(window, WindowCommit{geometry, true, false});
+        table.forget(window);
+
+        CHECK(table.update(window, WindowCommit{geometry, true, false}));
+        CHECK(table.sentCount() == 2);
+    }
+
+    SUBCASE("Counters are reset, but the committed values are kept")
+    {
+        table.update(window, WindowCommit{geometry, {}, {}});
+        table.update(window, WindowCommit{geometry, {}, {}});
+        table.resetCounters();
+
+        CHECK(table.sentCount() == 0);
+        CHECK(table.skippedCount() == 0);
+        CHECK_FALSE(table.update(window, WindowCommit{geometry, {}, {}}));
+        CHECK(table.skippedCount() == 1);
+    }
+}
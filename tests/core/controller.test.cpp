@@ -0,0 +1,71 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include <doctest/doctest.h>
+
+#include <QCoreApplication>
+
+#include <vector>
+
+#include "config.hpp"
+#include "controller.hpp"
+
+using namespace Bismuth;
+
+TEST_CASE("Controller")
+{
+    auto config = Config();
+    auto controller = Controller(config, false);
+
+    auto repeats = std::vector<int>();
+    auto presses = std::vector<int>();
+    controller.registerActions({
+        Action(QStringLiteral("move_right"), QStringLiteral("Move Right"), {}, [&repeats](int count) {
+            repeats.push_back(count);
+        }, true),
+        Action(QStringLiteral("toggle_float"), QStringLiteral("Toggle Float"), {}, [&presses](int count) {
+            presses.push_back(count);
+        }),
+    });
+
+    SUBCASE("Unknown actions are not triggered")
+    {
+        CHECK_FALSE(controller.trigger(QStringLiteral("unknown")));
+    }
+
+    SUBCASE("Triggers of one iteration reach the repeatable action once")
+    {
+        CHECK(controller.trigger(QStringLiteral("move_right")));
+        CHECK(controller.trigger(QStringLiteral("move_right")));
+        CHECK(controller.trigger(QStringLiteral("move_right")));
+        CHECK(repeats.empty());
+
+        QCoreApplication::processEvents();
+
+        CHECK(repeats == std::vector<int>{3});
+    }
+
+    SUBCASE("Triggers of the next iteration are not coalesced with the previous ones")
+    {
+        controller.trigger(QStringLiteral("move_right"));
+        QCoreApplication::processEvents();
+
+        controller.trigger(QStringLiteral("move_right"));
+        controller.trigger(QStringLiteral("move_right"));
+        QCoreApplication::processEvents();
+
+        CHECK(repeats == std::vector<int>{1, 2});
+    }
+
+    SUBCASE("Other actions are executed immediately")
+    {
+        controller.trigger(QStringLiteral("toggle_float"));
+        controller.trigger(QStringLiteral("toggle_float"));
+
+        CHECK(presses == std::vector<int>{1, 1});
+
+        QCoreApplication::processEvents();
+
+        CHECK(presses == std::vector<int>{1, 1});
+    }
+}
@@ -0,0 +1,58 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include <doctest/doctest.h>
+
+#include "drag-tracker.hpp"
+
+using namespace Bismuth;
+
+TEST_CASE("Drag Tracker")
+{
+    auto tracker = DragTracker();
+
+    // Master on the left, two stacked tiles on the right
+    const auto tiles = std::vector<std::pair<QString, QRect>>{
+        {QStringLiteral("master"), QRect(0, 0, 1000, 1000)},
+        {QStringLiteral("top"), QRect(1000, 0, 1000, 500)},
+        {QStringLiteral("bottom"), QRect(1000, 500, 1000, 500)},
+    };
+
+    SUBCASE("Nothing is tracked before the drag")
+    {
+        CHECK_FALSE(tracker.active());
+        CHECK(tracker.window().isEmpty());
+    }
+
+    SUBCASE("The tile under the point is the target")
+    {
+        tracker.begin(QStringLiteral("top"));
+        REQUIRE(tracker.active());
+        CHECK(tracker.window() == QStringLiteral("top"));
+
+        CHECK(tracker.target(tiles, QPoint(500, 500)) == QStringLiteral("master"));
+        CHECK(tracker.target(tiles, QPoint(1500, 800)) == QStringLiteral("bottom"));
+
+        // The dragged window itself is never a target
+        CHECK(tracker.target(tiles, QPoint(1500, 200)).isEmpty());
+
+        CHECK(tracker.target(tiles, QPoint(2500, 200)).isEmpty());
+        CHECK(tracker.target(tiles, QPoint(-1, 200)).isEmpty());
+    }
+
+    SUBCASE("Shared edges and overlapping tiles are not a clear target")
+    {
+        tracker.begin(QStringLiteral("master"));
+        CHECK(tracker.target(tiles, QPoint(1500, 500)).isEmpty());
+        CHECK(tracker.target(tiles, QPoint(2000, 1000)) == QStringLiteral("bottom"));
+    }
+
+    SUBCASE("The window is forgotten when the drag ends")
+    {
+        tracker.begin(QStringLiteral("top"));
+        tracker.end();
+
+        CHECK_FALSE(tracker.active());
+        CHECK(tracker.window().isEmpty());
+    }
+}
@@ -0,0 +1,113 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include <doctest/doctest.h>
+
+#include "echo-tracker.hpp"
+
+using namespace Bismuth;
+
+TEST_CASE("Echo Tracker")
+{
+    const auto window = QStringLiteral("window");
+    const auto first = QRect(0, 0, 100, 100);
+    const auto second = QRect(100, 0, 100, 100);
+
+    auto tracker = EchoTracker(1000, 3);
+
+    SUBCASE("Written values are echoed once")
+    {
+        const auto sequence = tracker.record(window, WindowCommit{first, true, false}, 0);
+        CHECK(sequence > 0);
+
+        CHECK(tracker.consumeGeometry(window, first, 10) == sequence);
+        CHECK(tracker.consumeGeometry(window, first, 20) == 0);
+
+        CHECK(tracker.consumeFlag(window, EchoTracker::KeepAbove, true, 30) == 0);
+        CHECK(tracker.consumeFlag(window, EchoTracker::KeepAbove, false, 30) == sequence);
+
+        // The border is still expected
+        CHECK(tracker.size() == 1);
+        CHECK(tracker.consumeFlag(window, EchoTracker::NoBorder, true, 40) == sequence);
+        CHECK(tracker.size() == 0);
+        CHECK(tracker.echoCount() == 3);
+    }
+
+    SUBCASE("Other values and windows are not echoes")
+    {
+        tracker.record(window, WindowCommit{first, {}, {}}, 0);
+
+        CHECK(tracker.consumeGeometry(window, second, 10) == 0);
+        CHECK(tracker.consumeGeometry(QStringLiteral("other"), first, 10) == 0);
+        CHECK(tracker.consumeFlag(window, EchoTracker::NoBorder, true, 10) == 0);
+        CHECK(tracker.echoCount() == 0);
+    }
+
+    SUBCASE("Echo of a later write makes the earlier writes irrelevant")
+    {
+        const auto earlier = tracker.record(window, WindowCommit{first, {}, {}}, 0);
+        const auto later = tracker.record(window, WindowCommit{second, {}, {}}, 10);
+        CHECK(later > earlier);
+
+        CHECK(tracker.consumeGeometry(window, second, 20) == later);
+        CHECK(tracker.consumeGeometry(window, first, 30) == 0);
+        CHECK(tracker.size() == 0);
+    }
+
+    SUBCASE("Writes time out")
+    {
+        tracker.record(window, WindowCommit{first, {}, {}}, 0);
+
+        CHECK(tracker.consumeGeometry(window, first, 1001) == 0);
+        CHECK(tracker.size() == 0);
+    }
+
+    SUBCASE("Only the latest writes are kept")
+    {
+        tracker.record(window, WindowCommit{first, {}, {}}, 0);
+        tracker.record(window, WindowCommit{{}, true, {}}, 1);
+        tracker.record(window, WindowCommit{{}, {}, true}, 2);
+        tracker.record(window, WindowCommit{second, {}, {}}, 3);
+
+        CHECK(tracker.consumeGeometry(window, first, 10) == 0);
+        CHECK(tracker.consumeGeometry(window, second, 10) > 0);
+    }
+
+    SUBCASE("Frame changes are echoes, while the geometry with the border is not echoed")
+    {
+        const auto sequence = tracker.record(window, WindowCommit{first, true, {}}, 0);
+
+        // KWin removes the border around the client, before it moves the window
+        CHECK(tracker.consumeFlag(window, EchoTracker::NoBorder, true, 10) == sequence);
+        CHECK(tracker.consumeGeometry(window, QRect(4, 30, 92, 66), 10) == sequence);
+        CHECK(tracker.consumeGeometry(window, first, 20) == sequence);
+
+        CHECK(tracker.consumeGeometry(window, QRect(4, 30, 92, 66), 30) == 0);
+        CHECK(tracker.echoCount() == 2);
+    }
+
+    SUBCASE("Only one frame change is taken for the echo of the border")
+    {
+        const auto sequence = tracker.record(window, WindowCommit{first, true, {}}, 0);
+
+        CHECK(tracker.consumeGeometry(window, QRect(4, 30, 92, 66), 10) == sequence);
+        CHECK(tracker.consumeGeometry(window, second, 20) == 0);
+
+        // The written geometry is still expected
+        CHECK(tracker.consumeGeometry(window, first, 30) == sequence);
+    }
+
+    SUBCASE("Empty commits are not recorded")
+    {
+        CHECK(tracker.record(window, WindowCommit(), 0) == 0);
+        CHECK(tracker.size() == 0);
+    }
+
+    SUBCASE("Closed windows are forgotten")
+    {
+        tracker.record(window, WindowCommit{first, {}, {}}, 0);
+        tracker.forget(window);
+
+        CHECK(tracker.consumeGeometry(window, first, 10) == 0);
+    }
+}
@@ -0,0 +1,68 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include <doctest/doctest.h>
+
+#include "engine/engine.hpp"
+
+using namespace Bismuth;
+
+TEST_CASE("Engine limits the tile width")
+{
+    auto config = std::make_shared<ConfigSnapshot>();
+    config->limitTileWidthRatio = 1;
+    config->screenGapTop = 50;
+    config->screenGapBottom = 50;
+    auto engine = Engine(config);
+
+    // The working area is 2000x600, so the tiles are at most 600 wide
+    auto buffer = GeometryBuffer();
+    engine.arrange(QStringLiteral("TileLayout"), {}, QRect(0, 50, 2000, 500), {1, 1}, buffer);
+    REQUIRE(buffer.size() == 2);
+    CHECK(buffer.at(0) == QRect(200, 50, 600, 500));
+    CHECK(buffer.at(1) == QRect(1200, 50, 600, 500));
+
+    SUBCASE("Monocle is not limited")
+    {
+        engine.arrange(QStringLiteral("MonocleLayout"), {}, QRect(0, 50, 2000, 500), {1}, buffer);
+        REQUIRE(buffer.size() == 1);
+        CHECK(buffer.at(0) == QRect(0, 50, 2000, 500));
+    }
+
+    SUBCASE("Layouts write into the memory of the buffer")
+    {
+        const auto memory = buffer.geometries().data();
+        engine.arrange(QStringLiteral("TileLayout"), {}, QRect(0, 50, 2000, 500), {2, 1}, buffer);
+        CHECK(buffer.geometries().data() == memory);
+        CHECK(buffer.size() == 2);
+    }
+}
+
+TEST_CASE("Engine arranges several surfaces at once")
+{
+    auto engine = Engine(std::make_shared<ConfigSnapshot>());
+
+    // Enough tiles to be arranged on the workers
+    auto requests = std::vector<ArrangeRequest>();
+    for (auto screen = 0; screen < 4; ++screen) {
+        requests.push_back({QStringLiteral("TileLayout"), {}, QRect(screen * 1000, 0, 1000, 500), std::vector<qreal>(50, 1)});
+    }
+    requests.push_back({QStringLiteral("UnknownLayout"), {}, QRect(0, 0, 1000, 500), {1}});
+
+    auto results = std::vector<GeometryBuffer>();
+    engine.arrange(requests, results);
+    REQUIRE(results.size() == requests.size());
+
+    auto expected = GeometryBuffer();
+    for (auto i = std::size_t(0); i < requests.size() - 1; ++i) {
+        const auto &request = requests[i];
+        engine.arrange(request.layoutId, request.parameters, request.area, request.weights, expected);
+
+        REQUIRE(results[i].size() == expected.size());
+        for (auto j = 0; j < expected.size(); ++j) {
+            CHECK(results[i].at(j) == expected.at(j));
+        }
+    }
+
+    CHECK(results.back().size() == 0);
+}
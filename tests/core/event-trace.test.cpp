@@ -0,0 +1,87 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include <doctest/doctest.h>
+
+#include "event-trace.hpp"
+
+using namespace Bismuth;
+
+TEST_CASE("Event Trace")
+{
+    auto client = TraceClient();
+    client.id = 1;
+    client.windowId = 0x4200007;
+    client.resourceClass = QStringLiteral("konsole");
+    client.caption = QStringLiteral("~ : bash");
+    client.frameGeometry = QRect(10, 20, 800, 600);
+    client.maxSize = QSize(32767, 32767);
+    client.activities = QStringList{QStringLiteral("activity")};
+    client.flags = TraceClient::Active | TraceClient::Resizeable;
+
+    auto trace = EventTrace();
+    trace.workspace.numScreens = 2;
+    trace.workspace.desktops = 4;
+    trace.workspace.currentActivity = QStringLiteral("activity");
+    trace.workspace.activities = {{QStringLiteral("activity"), QStringLiteral("Default")}};
+    trace.workspace.areas = {{0, 1, QRect(0, 0, 1920, 1050)}, {1, 1, QRect(1920, 0, 1920, 1080)}};
+    trace.workspace.clients = {client};
+
+    auto added = TraceEvent();
+    added.state = client;
+    added.state.id = 2;
+    added.client = 2;
+
+    auto moved = TraceEvent();
+    moved.type = TraceEvent::FrameGeometryChanged;
+    moved.delay = 1500;
+    moved.client = 2;
+    moved.geometry = QRect(100, 100, 400, 300);
+
+    auto desktop = TraceEvent();
+    desktop.type = TraceEvent::CurrentDesktopChanged;
+    desktop.value = 3;
+
+    auto shortcut = TraceEvent();
+    shortcut.type = TraceEvent::ShortcutTriggered;
+    shortcut.text = QStringLiteral("bismuth_focus_next_window");
+    shortcut.value = 2;
+
+    trace.events = {added, moved, desktop, shortcut};
+
+    SUBCASE("Serialization round trip")
+    {
+        auto restored = EventTrace::deserialize(trace.serialize());
+        REQUIRE(restored.has_value());
+        CHECK(restored->workspace == trace.workspace);
+        CHECK(restored->events == trace.events);
+    }
+
+    SUBCASE("Events take only the fields of their type")
+    {
+        auto stray = moved;
+        stray.text = QStringLiteral("ignored");
+        stray.value = 7;
+
+        auto restored = EventTrace::deserialize(EventTrace{trace.workspace, {stray}}.serialize());
+        REQUIRE(restored.has_value());
+        REQUIRE(restored->events.size() == 1);
+        CHECK(restored->events[0] == moved);
+    }
+
+    SUBCASE("Interrupted recording keeps the complete events")
+    {
+        auto data = trace.serialize();
+        auto restored = EventTrace::deserialize(data.left(data.size() - 3));
+        REQUIRE(restored.has_value());
+        CHECK(restored->events.size() == 3);
+    }
+
+    SUBCASE("Other versions are ignored")
+    {
+        auto data = trace.serialize();
+        data[7] = data[7] + 1; // The version goes right after the magic number
+        CHECK_FALSE(EventTrace::deserialize(data).has_value());
+        CHECK_FALSE(EventTrace::deserialize(QByteArray()).has_value());
+    }
+}
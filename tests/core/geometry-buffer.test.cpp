@@ -0,0 +1,42 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include <doctest/doctest.h>
+
+#include "engine/geometry_buffer.hpp"
+
+using namespace Bismuth;
+
+TEST_CASE("Geometry Buffer")
+{
+    auto buffer = GeometryBuffer();
+    buffer.geometries() = {QRect(0, 0, 1000, 500), QRect(1000, 0, 300, 500), QRect(1300, 0, 401, 500)};
+    REQUIRE(buffer.size() == 3);
+    CHECK(buffer.at(1) == QRect(1000, 0, 300, 500));
+
+    SUBCASE("Wide tiles are clamped around their centers")
+    {
+        buffer.clampWidth(400);
+        CHECK(buffer.at(0) == QRect(300, 0, 400, 500));
+        CHECK(buffer.at(1) == QRect(1000, 0, 300, 500));
+        CHECK(buffer.at(2) == QRect(1300, 0, 400, 500));
+    }
+
+    SUBCASE("Geometries are written one after another")
+    {
+        qint32 values[12];
+        buffer.writeFlat(values);
+        CHECK(values[4] == 1000);
+        CHECK(values[5] == 0);
+        CHECK(values[6] == 300);
+        CHECK(values[7] == 500);
+        CHECK(values[11] == 500);
+    }
+
+    SUBCASE("Writing fewer geometries shrinks the buffer")
+    {
+        buffer.geometries() = {QRect(0, 0, 10, 10)};
+        CHECK(buffer.size() == 1);
+        CHECK(buffer.at(0) == QRect(0, 0, 10, 10));
+    }
+}
@@ -0,0 +1,90 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include <doctest/doctest.h>
+
+#include "layout-state-store.hpp"
+
+using namespace Bismuth;
+
+TEST_CASE("Layout State Store")
+{
+    const auto tile = QStringLiteral("TileLayout");
+    const auto monocle = QStringLiteral("MonocleLayout");
+    const auto spiral = QStringLiteral("SpiralLayout");
+
+    auto store = LayoutStateStore(3);
+    store.setLayoutOrder({tile, monocle, spiral});
+
+    SUBCASE("New surfaces start with the first layout")
+    {
+        CHECK(store.currentLayout(0, QStringLiteral("0")) == tile);
+        CHECK(store.values(0, QStringLiteral("0"), tile).empty());
+        CHECK(store.size() == 1);
+    }
+
+    SUBCASE("Layouts are cycled and toggled")
+    {
+        CHECK(store.cycleLayout(0, QStringLiteral("0"), 1) == monocle);
+        CHECK(store.cycleLayout(0, QStringLiteral("0"), -1) == tile);
+        CHECK(store.cycleLayout(0, QStringLiteral("0"), -1) == spiral);
+
+        CHECK(store.toggleLayout(0, QStringLiteral("0"), monocle) == monocle);
+        CHECK(store.toggleLayout(0, QStringLiteral("0"), monocle) == spiral);
+
+        // The other surfaces are not affected
+        CHECK(store.currentLayout(1, QStringLiteral("1")) == tile);
+    }
+
+    SUBCASE("Values are stored per layout")
+    {
+        store.setValues(0, QStringLiteral("0"), tile, {1, 0.6});
+        store.setValues(0, QStringLiteral("0"), spiral, {0.4});
+        store.setValues(0, QStringLiteral("0"), tile, {2, 0.5});
+
+        CHECK(store.values(0, QStringLiteral("0"), tile) == std::vector<qreal>{2, 0.5});
+        CHECK(store.values(0, QStringLiteral("0"), spiral) == std::vector<qreal>{0.4});
+        CHECK(store.values(1, QStringLiteral("1"), tile).empty());
+    }
+
+    SUBCASE("The least recently used surface is evicted")
+    {
+        store.setValues(0, QStringLiteral("0"), tile, {3});
+        store.currentLayout(1, QStringLiteral("1"));
+        store.currentLayout(2, QStringLiteral("2"));
+        store.currentLayout(0, QStringLiteral("0"));
+        store.currentLayout(3, QStringLiteral("3"));
+
+        CHECK(store.size() == 3);
+        CHECK(store.evictedCount() == 1);
+        CHECK(store.values(0, QStringLiteral("0"), tile) == std::vector<qreal>{3});
+
+        // Surface 1 was evicted, it starts from scratch and evicts surface 2
+        CHECK(store.values(1, QStringLiteral("1"), tile).empty());
+        CHECK(store.evictedCount() == 2);
+    }
+
+    SUBCASE("Disabled layouts are replaced")
+    {
+        store.toggleLayout(0, QStringLiteral("0"), spiral);
+        store.toggleLayout(1, QStringLiteral("1"), monocle);
+        store.setLayoutOrder({monocle, tile});
+
+        CHECK(store.currentLayout(0, QStringLiteral("0")) == monocle);
+        CHECK(store.currentLayout(1, QStringLiteral("1")) == monocle);
+    }
+
+    SUBCASE("States are restored and listed by the surface id")
+    {
+        store.currentLayout(1, QStringLiteral("1"));
+        store.restore(0, {QStringLiteral("0"), QStringLiteral("ThreeColumnLayout"), tile, {{tile, {1, 0.55}}}});
+
+        CHECK(store.currentLayout(0, QStringLiteral("0")) == tile);
+        CHECK(store.values(0, QStringLiteral("0"), tile) == std::vector<qreal>{1, 0.55});
+
+        auto states = store.states();
+        REQUIRE(states.size() == 2);
+        CHECK(states[0].surfaceId == QStringLiteral("0"));
+        CHECK(states[1].surfaceId == QStringLiteral("1"));
+    }
+}
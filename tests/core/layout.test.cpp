@@ -0,0 +1,134 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include <doctest/doctest.h>
+
+#include "engine/layout/layout_cache.hpp"
+#include "engine/layout/layout_part.hpp"
+#include "engine/layout/quarter_layout.hpp"
+#include "engine/layout/spiral_layout.hpp"
+#include "engine/layout/three_column_layout.hpp"
+#include "engine/layout/tile_layout.hpp"
+
+using namespace Bismuth;
+
+TEST_CASE("Layout Parts")
+{
+    const auto area = QRect(0, 0, 1000, 500);
+    const qreal weights[] = {1, 1, 1};
+    QRect result[3];
+
+    SUBCASE("Stack splits the area vertically")
+    {
+        auto stack = StackLayoutPart();
+        stack.apply(area, weights, 2, result);
+        CHECK(result[0] == QRect(0, 0, 1000, 250));
+        CHECK(result[1] == QRect(0, 250, 1000, 250));
+    }
+
+    SUBCASE("Rotated half split puts the primary part at the bottom")
+    {
+        auto fill = FillLayoutPart();
+        auto split = HalfSplitLayoutPart(fill, fill);
+        split.angle = 270;
+        split.apply(area, weights, 2, result);
+        CHECK(result[0] == QRect(0, 250, 1000, 250));
+        CHECK(result[1] == QRect(0, 0, 1000, 250));
+    }
+
+    SUBCASE("Rotate part transposes the inner part")
+    {
+        auto stack = StackLayoutPart();
+        auto rotate = RotateLayoutPart(stack, 90);
+        rotate.apply(area, weights, 2, result);
+        CHECK(result[0] == QRect(0, 0, 500, 500));
+        CHECK(result[1] == QRect(500, 0, 500, 500));
+    }
+}
+
+TEST_CASE("Layout Cache")
+{
+    auto cache = LayoutCache();
+    const auto area = QRect(0, 0, 1000, 500);
+    const auto parameters = LayoutParameters();
+    const auto weights = std::vector<qreal>{1, 1};
+    const auto stored = std::vector<QRect>{QRect(0, 0, 500, 500), QRect(500, 0, 500, 500)};
+
+    cache.insert(LayoutCache::hash(area, parameters, weights), area, parameters, weights, stored);
+
+    SUBCASE("Result is found for the same inputs")
+    {
+        auto result = std::vector<QRect>(2);
+        CHECK(cache.find(LayoutCache::hash(area, parameters, weights), area, parameters, weights, result));
+        CHECK(result == stored);
+        CHECK(cache.hits() == 1);
+    }
+
+    SUBCASE("Result is not found for other inputs, even with the same hash")
+    {
+        const auto hash = LayoutCache::hash(area, parameters, weights);
+        auto result = std::vector<QRect>(3);
+        CHECK_FALSE(cache.find(hash, area, parameters, {1, 1, 1}, result));
+
+        auto rotated = parameters;
+        rotated.angle = 90;
+        CHECK_FALSE(cache.find(hash, area, rotated, weights, result));
+        CHECK(cache.misses() == 2);
+    }
+}
+
+TEST_CASE("Tile Layout")
+{
+    auto layout = TileLayout(10);
+    auto parameters = layout.defaultParameters();
+    const auto area = QRect(0, 0, 1000, 500);
+
+    auto result = layout.apply(area, {1, 1, 1}, parameters);
+    REQUIRE(result.size() == 3);
+    CHECK(result[0] == QRect(0, 0, 495, 500));
+    CHECK(result[1] == QRect(505, 0, 495, 245));
+    CHECK(result[2] == QRect(505, 255, 495, 245));
+
+    SUBCASE("Memoized result is the same as the computed one")
+    {
+        CHECK(layout.apply(area, {1, 1, 1}, parameters) == result);
+        CHECK(layout.apply(area, {1, 1}, parameters).size() == 2);
+    }
+
+    SUBCASE("Rotation moves the master area to the right")
+    {
+        parameters.angle = 180;
+        result = layout.apply(area, {1, 1}, parameters);
+        CHECK(result[0] == QRect(505, 0, 495, 500));
+        CHECK(result[1] == QRect(0, 0, 495, 500));
+    }
+}
+
+TEST_CASE("Three Column Layout")
+{
+    auto layout = ThreeColumnLayout(0);
+    auto result = layout.apply(QRect(0, 0, 1000, 500), {1, 1, 1}, layout.defaultParameters());
+    REQUIRE(result.size() == 3);
+    CHECK(result[0] == QRect(285, 0, 428, 500)); // Master
+    CHECK(result[1] == QRect(714, 0, 285, 500)); // R-stack
+    CHECK(result[2] == QRect(0, 0, 285, 500)); // L-stack
+}
+
+TEST_CASE("Spiral Layout")
+{
+    auto layout = SpiralLayout(0);
+    auto result = layout.apply(QRect(0, 0, 1000, 1000), {1, 1, 1, 1}, layout.defaultParameters());
+    REQUIRE(result.size() == 4);
+    CHECK(result[0] == QRect(0, 0, 500, 1000));
+    CHECK(result[1] == QRect(500, 0, 500, 500));
+    CHECK(result[2] == QRect(750, 500, 250, 500));
+    CHECK(result[3] == QRect(500, 500, 250, 500));
+}
+
+TEST_CASE("Quarter Layout places at most four tiles")
+{
+    auto layout = QuarterLayout(0);
+    auto result = layout.apply(QRect(0, 0, 1000, 1000), {1, 1, 1, 1, 1}, layout.defaultParameters());
+    CHECK(result.size() == 4);
+    CHECK(result[3] == QRect(0, 500, 500, 500));
+}
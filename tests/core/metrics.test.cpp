@@ -0,0 +1,101 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include <doctest/doctest.h>
+
+#include "metrics.hpp"
+
+using namespace Bismuth;
+
+TEST_CASE("Latency Histogram")
+{
+    auto histogram = LatencyHistogram();
+
+    SUBCASE("Empty histogram has no percentiles")
+    {
+        CHECK(histogram.count() == 0);
+        CHECK(histogram.percentile(0.5) == 0);
+    }
+
+    SUBCASE("Durations are put into power-of-two buckets of microseconds")
+    {
+        histogram.record(500); // 0.5 µs
+        histogram.record(1'000); // 1 µs
+        histogram.record(3'000); // 3 µs
+        histogram.record(3'999);
+        histogram.record(-1); // Clock skew is counted as zero
+
+        CHECK(histogram.count() == 5);
+        CHECK(histogram.bucket(0) == 2);
+        CHECK(histogram.bucket(1) == 1);
+        CHECK(histogram.bucket(2) == 2);
+        CHECK(histogram.totalNanoseconds() == 8'499);
+        CHECK(histogram.maxNanoseconds() == 3'999);
+    }
+
+    SUBCASE("Very long durations end up in the last bucket")
+    {
+        histogram.record(3'600'000'000'000); // An hour
+
+        CHECK(histogram.bucket(LatencyHistogram::BucketCount - 1) == 1);
+        CHECK(histogram.percentile(0.5) == LatencyHistogram::bucketBound(LatencyHistogram::BucketCount - 1));
+    }
+
+    SUBCASE("Percentiles are the bucket bounds, but no more than the maximum")
+    {
+        for (auto i = 0; i < 98; ++i) {
+            histogram.record(10'000); // 10 µs, the bucket below 16 µs
+        }
+        histogram.record(100'000); // 100 µs, the bucket below 128 µs
+        histogram.record(150'000); // 150 µs, the bucket below 256 µs
+
+        CHECK(histogram.percentile(0.5) == 16);
+        CHECK(histogram.percentile(0.98) == 16);
+        CHECK(histogram.percentile(0.99) == 128);
+        CHECK(histogram.percentile(1.0) == 150);
+    }
+}
+
+TEST_CASE("Metrics")
+{
+    auto metrics = Metrics();
+    const auto tile = QStringLiteral("TileLayout");
+
+    metrics.recordArrange(tile, 2'000);
+    metrics.recordArrange(tile, 4'000);
+    metrics.recordShortcut(1'000);
+    metrics.countCall(Metrics::WindowCall);
+    metrics.countCall(Metrics::WindowCall);
+    metrics.countCall(Metrics::CommitCall);
+
+    SUBCASE("Arrangements are counted per layout")
+    {
+        REQUIRE(metrics.arrangeLatency(tile) != nullptr);
+        CHECK(metrics.arrangeLatency(tile)->count() == 2);
+        CHECK(metrics.arrangeLatency(QStringLiteral("MonocleLayout")) == nullptr);
+        CHECK(metrics.shortcutLatency().count() == 1);
+    }
+
+    SUBCASE("Calls are counted per group")
+    {
+        CHECK(metrics.calls(Metrics::WindowCall) == 2);
+        CHECK(metrics.calls(Metrics::CommitCall) == 1);
+        CHECK(metrics.calls(Metrics::LayoutCall) == 0);
+    }
+
+    SUBCASE("Every group has a name")
+    {
+        for (auto i = 0; i < Metrics::BridgeCallCount; ++i) {
+            CHECK_FALSE(Metrics::callName(static_cast<Metrics::BridgeCall>(i)).isEmpty());
+        }
+    }
+
+    SUBCASE("Reset starts from zero")
+    {
+        metrics.reset();
+
+        CHECK(metrics.arrangeLatency(tile) == nullptr);
+        CHECK(metrics.shortcutLatency().count() == 0);
+        CHECK(metrics.calls(Metrics::WindowCall) == 0);
+    }
+}
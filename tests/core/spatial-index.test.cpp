@@ -0,0 +1,113 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include <doctest/doctest.h>
+
+#include <random>
+
+#include "spatial-index.hpp"
+
+using namespace Bismuth;
+
+namespace
+{
+/**
+ * The same lookup, done by filtering all the tiles
+ */
+int bruteForceNeighbor(const std::vector<QRect> &tiles, const QRect &basis, SpatialIndex::Direction direction)
+{
+    auto start = [direction](const QRect &rect) {
+        switch (direction) {
+        case SpatialIndex::Direction::Up:
+            return -rect.y();
+        case SpatialIndex::Direction::Down:
+            return rect.y();
+        case SpatialIndex::Direction::Left:
+            return -rect.x();
+        case SpatialIndex::Direction::Right:
+            return rect.x();
+        }
+        return 0;
+    };
+    auto end = [direction](const QRect &rect) {
+        switch (direction) {
+        case SpatialIndex::Direction::Up:
+            return -(rect.y() + rect.height());
+        case SpatialIndex::Direction::Left:
+            return -(rect.x() + rect.width());
+        default:
+            return direction == SpatialIndex::Direction::Down ? rect.y() : rect.x();
+        }
+    };
+    auto overlaps = [direction](const QRect &lhs, const QRect &rhs) {
+        if (direction == SpatialIndex::Direction::Up || direction == SpatialIndex::Direction::Down) {
+            return std::min(lhs.x() + lhs.width(), rhs.x() + rhs.width()) > std::max(lhs.x(), rhs.x());
+        }
+        return std::min(lhs.y() + lhs.height(), rhs.y() + rhs.height()) > std::max(lhs.y(), rhs.y());
+    };
+
+    auto closest = -1;
+    for (auto i = 0; i < static_cast<int>(tiles.size()); ++i) {
+        if (start(tiles[i]) > start(basis) && overlaps(basis, tiles[i]) && (closest < 0 || end(tiles[i]) < end(tiles[closest]))) {
+            closest = i;
+        }
+    }
+    if (closest < 0) {
+        return -1;
+    }
+
+    // The priority is the tile number, so the last of the equally close tiles wins
+    auto result = -1;
+    for (auto i = 0; i < static_cast<int>(tiles.size()); ++i) {
+        if (start(tiles[i]) > start(basis) && overlaps(basis, tiles[i]) && end(tiles[i]) < end(tiles[closest]) + 5) {
+            result = i;
+        }
+    }
+    return result;
+}
+}
+
+TEST_CASE("Spatial Index")
+{
+    const auto priority = [](int tile) {
+        return static_cast<quint64>(tile);
+    };
+
+    SUBCASE("Empty index has no neighbors")
+    {
+        const auto index = SpatialIndex();
+        CHECK(index.neighbor(QRect(0, 0, 100, 100), SpatialIndex::Direction::Right, priority) == -1);
+    }
+
+    SUBCASE("Tall tiles above the basis are found")
+    {
+        // The tall tile ends lower, than the short one, but starts above the basis
+        const auto tiles = std::vector<QRect>{QRect(0, 0, 100, 900), QRect(100, 0, 100, 100), QRect(0, 900, 200, 100)};
+        const auto index = SpatialIndex(tiles);
+
+        CHECK(index.neighbor(tiles[2], SpatialIndex::Direction::Up, priority) == 0);
+        CHECK(index.neighbor(tiles[0], SpatialIndex::Direction::Down, priority) == 2);
+        CHECK(index.neighbor(tiles[1], SpatialIndex::Direction::Left, priority) == 0);
+    }
+
+    SUBCASE("Lookups are the same as the brute force ones")
+    {
+        auto random = std::mt19937(42);
+        auto coordinate = std::uniform_int_distribution<int>(0, 1000);
+        auto size = std::uniform_int_distribution<int>(10, 400);
+
+        for (auto round = 0; round < 20; ++round) {
+            auto tiles = std::vector<QRect>();
+            for (auto i = 0; i < 30; ++i) {
+                tiles.push_back(QRect(coordinate(random), coordinate(random), size(random), size(random)));
+            }
+            const auto index = SpatialIndex(tiles);
+
+            for (const auto &basis : tiles) {
+                for (auto direction : {SpatialIndex::Direction::Up, SpatialIndex::Direction::Down, SpatialIndex::Direction::Left, SpatialIndex::Direction::Right}) {
+                    CHECK(index.neighbor(basis, direction, priority) == bruteForceNeighbor(tiles, basis, direction));
+                }
+            }
+        }
+    }
+}
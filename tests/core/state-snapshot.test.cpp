@@ -0,0 +1,54 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include <doctest/doctest.h>
+
+#include <QTemporaryDir>
+
+#include "state-snapshot.hpp"
+
+using namespace Bismuth;
+
+TEST_CASE("State Snapshot")
+{
+    auto snapshot = StateSnapshot();
+    snapshot.surfaces.push_back({QStringLiteral("0@activity#1"),
+                                 QStringLiteral("TileLayout"),
+                                 QStringLiteral("MonocleLayout"),
+                                 {{QStringLiteral("TileLayout"), {2, 0.65, 90, 0}}, {QStringLiteral("MonocleLayout"), {}}}});
+    snapshot.windowOrder = {QStringLiteral("b"), QStringLiteral("a")};
+
+    SUBCASE("Serialization round trip")
+    {
+        auto restored = StateSnapshot::deserialize(snapshot.serialize());
+        REQUIRE(restored.has_value());
+        CHECK(*restored == snapshot);
+    }
+
+    SUBCASE("File round trip")
+    {
+        QTemporaryDir directory;
+        const auto path = directory.filePath(QStringLiteral("bismuth-state"));
+
+        CHECK_FALSE(StateSnapshot::load(path).has_value());
+        REQUIRE(snapshot.save(path));
+
+        auto restored = StateSnapshot::load(path);
+        REQUIRE(restored.has_value());
+        CHECK(*restored == snapshot);
+    }
+
+    SUBCASE("Other versions are ignored")
+    {
+        auto data = snapshot.serialize();
+        data[7] = data[7] + 1; // The version goes right after the magic number
+        CHECK_FALSE(StateSnapshot::deserialize(data).has_value());
+    }
+
+    SUBCASE("Damaged data is ignored")
+    {
+        auto data = snapshot.serialize();
+        CHECK_FALSE(StateSnapshot::deserialize(data.left(data.size() - 3)).has_value());
+        CHECK_FALSE(StateSnapshot::deserialize(QByteArray()).has_value());
+    }
+}
@@ -0,0 +1,76 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include <doctest/doctest.h>
+
+#include "surface-registry.hpp"
+
+using namespace Bismuth;
+
+TEST_CASE("Surface Registry")
+{
+    auto config = std::make_shared<ConfigSnapshot>();
+    auto registry = SurfaceRegistry(config);
+
+    const auto activity = QStringLiteral("a1");
+
+    SUBCASE("The same surface gets the same handle")
+    {
+        auto first = registry.intern({0, 1, activity});
+        auto second = registry.intern({1, 1, activity});
+
+        CHECK(first != second);
+        CHECK(registry.intern({0, 1, activity}) == first);
+        CHECK(registry.size() == 2);
+        CHECK(registry.contains(second));
+        CHECK_FALSE(registry.contains(2));
+        CHECK(registry.surface(second).key == SurfaceKey{1, 1, activity});
+    }
+
+    SUBCASE("Ids are in the format of the saved state")
+    {
+        auto handle = registry.intern({1, 2, activity});
+        CHECK(registry.surface(handle).id == QStringLiteral("1@a1\"#2"));
+
+        auto perScreen = std::make_shared<ConfigSnapshot>();
+        perScreen->layoutPerActivity = false;
+        perScreen->layoutPerDesktop = false;
+        registry.setConfig(perScreen);
+
+        CHECK(registry.surface(handle).id == QStringLiteral("1"));
+        CHECK(registry.intern({1, 2, activity}) == handle);
+    }
+
+    SUBCASE("Surfaces with the same id share the layout key")
+    {
+        auto perActivity = std::make_shared<ConfigSnapshot>();
+        perActivity->layoutPerDesktop = false;
+        registry.setConfig(perActivity);
+
+        auto first = registry.intern({0, 1, activity});
+        auto second = registry.intern({0, 2, activity});
+        auto third = registry.intern({0, 1, QStringLiteral("a2")});
+
+        CHECK(registry.surface(first).layoutKey == registry.surface(second).layoutKey);
+        CHECK(registry.surface(first).layoutKey != registry.surface(third).layoutKey);
+        CHECK(registry.layoutKey(QStringLiteral("0@a1")) == registry.surface(first).layoutKey);
+    }
+
+    SUBCASE("Working areas are cached until invalidated")
+    {
+        auto handle = registry.intern({0, 1, activity});
+        CHECK_FALSE(registry.surface(handle).cached);
+
+        registry.cache(handle, true, QRect(0, 32, 1920, 1048));
+        CHECK(registry.surface(handle).cached);
+        CHECK(registry.surface(handle).ignored);
+        CHECK(registry.surface(handle).workingArea == QRect(0, 32, 1920, 1048));
+
+        registry.invalidate();
+        CHECK_FALSE(registry.surface(handle).cached);
+
+        registry.cache(handle, false, QRect(0, 0, 1920, 1080));
+        registry.setConfig(config);
+        CHECK_FALSE(registry.surface(handle).cached);
+    }
+}
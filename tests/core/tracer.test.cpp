@@ -0,0 +1,54 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include <doctest/doctest.h>
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include "tracer.hpp"
+
+using namespace Bismuth;
+
+TEST_CASE("Tracer")
+{
+    auto tracer = Tracer(4);
+
+    const auto arrange = tracer.intern(QStringLiteral("arrange"));
+    const auto commit = tracer.intern(QStringLiteral("commit"));
+    CHECK(tracer.intern(QStringLiteral("arrange")) == arrange);
+    CHECK(arrange != commit);
+
+    auto events = [&tracer]() {
+        return QJsonDocument::fromJson(tracer.toChromeJson()).object().value(QStringLiteral("traceEvents")).toArray();
+    };
+
+    SUBCASE("Spans are written in the Chrome trace format")
+    {
+        tracer.record(arrange, 1000, 3000, tracer.intern(QStringLiteral("surface")));
+
+        auto trace = events();
+        REQUIRE(trace.size() == 1);
+
+        auto event = trace.at(0).toObject();
+        CHECK(event.value(QStringLiteral("name")).toString() == QStringLiteral("arrange"));
+        CHECK(event.value(QStringLiteral("ph")).toString() == QStringLiteral("X"));
+        CHECK(event.value(QStringLiteral("ts")).toDouble() == 1.0);
+        CHECK(event.value(QStringLiteral("dur")).toDouble() == 2.0);
+        CHECK(event.value(QStringLiteral("args")).toObject().value(QStringLiteral("detail")).toString() == QStringLiteral("surface"));
+    }
+
+    SUBCASE("Only the latest spans are kept")
+    {
+        for (auto i = 0; i < 6; ++i) {
+            tracer.record(i % 2 ? commit : arrange, i * 1000, i * 1000 + 500);
+        }
+
+        auto trace = events();
+        REQUIRE(trace.size() == 4);
+        CHECK(trace.at(0).toObject().value(QStringLiteral("ts")).toDouble() == 2.0);
+        CHECK(trace.at(3).toObject().value(QStringLiteral("name")).toString() == QStringLiteral("commit"));
+        CHECK_FALSE(trace.at(3).toObject().contains(QStringLiteral("args")));
+    }
+}
@@ -0,0 +1,146 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include <doctest/doctest.h>
+
+#include "window-registry.hpp"
+
+using namespace Bismuth;
+
+TEST_CASE("Window Registry")
+{
+    auto registry = WindowRegistry();
+
+    auto tiled = WindowProperties();
+    tiled.desktop = 1;
+    tiled.tileable = true;
+    tiled.tiled = true;
+
+    registry.add(QStringLiteral("a"), tiled);
+    registry.add(QStringLiteral("b"), tiled);
+    registry.add(QStringLiteral("c"), tiled);
+
+    const auto surface = SurfaceKey{0, 1, QStringLiteral("activity")};
+    auto ids = [&](WindowRegistry::View view = WindowRegistry::View::VisibleTiled) {
+        return registry.windowsOn(surface, view);
+    };
+    using Ids = std::vector<QString>;
+
+    SUBCASE("Windows are kept in the insertion order")
+    {
+        registry.add(QStringLiteral("d"), tiled, true);
+        CHECK(ids() == Ids{QStringLiteral("d"), QStringLiteral("a"), QStringLiteral("b"), QStringLiteral("c")});
+    }
+
+    SUBCASE("Reordering")
+    {
+        registry.move(QStringLiteral("a"), QStringLiteral("c"), true);
+        CHECK(ids() == Ids{QStringLiteral("b"), QStringLiteral("c"), QStringLiteral("a")});
+
+        registry.swap(QStringLiteral("b"), QStringLiteral("a"));
+        CHECK(ids() == Ids{QStringLiteral("a"), QStringLiteral("c"), QStringLiteral("b")});
+
+        registry.putToFront(QStringLiteral("b"));
+        CHECK(ids() == Ids{QStringLiteral("b"), QStringLiteral("a"), QStringLiteral("c")});
+    }
+
+    SUBCASE("Saved order is restored")
+    {
+        registry.move(QStringLiteral("a"), QStringLiteral("c"), true);
+        const auto order = registry.order();
+        CHECK(order == Ids{QStringLiteral("b"), QStringLiteral("c"), QStringLiteral("a")});
+
+        auto restored = WindowRegistry();
+        restored.add(QStringLiteral("a"), tiled);
+        restored.add(QStringLiteral("new"), tiled);
+        restored.add(QStringLiteral("b"), tiled);
+        restored.add(QStringLiteral("c"), tiled);
+        restored.restoreOrder(order);
+
+        CHECK(restored.windowsOn(surface, WindowRegistry::View::VisibleTiled)
+              == Ids{QStringLiteral("b"), QStringLiteral("c"), QStringLiteral("a"), QStringLiteral("new")});
+    }
+
+    SUBCASE("Views follow the window properties")
+    {
+        auto minimized = tiled;
+        minimized.minimized = true;
+        registry.update(QStringLiteral("b"), minimized);
+
+        auto otherDesktop = tiled;
+        otherDesktop.desktop = 2;
+        registry.update(QStringLiteral("c"), otherDesktop);
+
+        CHECK(ids() == Ids{QStringLiteral("a")});
+        CHECK(ids(WindowRegistry::View::All) == Ids{QStringLiteral("a"), QStringLiteral("b")});
+    }
+
+    SUBCASE("Windows on all desktops and activities")
+    {
+        auto sticky = tiled;
+        sticky.desktop = -1;
+        registry.add(QStringLiteral("d"), sticky);
+
+        auto otherActivity = tiled;
+        otherActivity.activities = QStringList{QStringLiteral("other")};
+        registry.update(QStringLiteral("a"), otherActivity);
+
+        CHECK(ids() == Ids{QStringLiteral("b"), QStringLiteral("c"), QStringLiteral("d")});
+    }
+
+    SUBCASE("Moving to another screen")
+    {
+        auto otherScreen = tiled;
+        otherScreen.screen = 1;
+        registry.update(QStringLiteral("b"), otherScreen);
+        registry.remove(QStringLiteral("c"));
+
+        CHECK(ids() == Ids{QStringLiteral("a")});
+        CHECK(registry.windowsOn({1, 1, QStringLiteral("activity")}, WindowRegistry::View::VisibleTiled) == Ids{QStringLiteral("b")});
+    }
+}
+
+TEST_CASE("Window Registry Neighbors")
+{
+    auto registry = WindowRegistry();
+
+    auto tiled = WindowProperties();
+    tiled.tileable = true;
+    tiled.tiled = true;
+
+    // Master on the left, two stacked windows on the right
+    registry.add(QStringLiteral("master"), tiled);
+    registry.add(QStringLiteral("top"), tiled);
+    registry.add(QStringLiteral("bottom"), tiled);
+    registry.setGeometry(QStringLiteral("master"), QRect(0, 0, 500, 500));
+    registry.setGeometry(QStringLiteral("top"), QRect(500, 0, 500, 250));
+    registry.setGeometry(QStringLiteral("bottom"), QRect(500, 250, 500, 250));
+
+    const auto surface = SurfaceKey{0, 0, QString()};
+
+    CHECK(registry.neighbor(surface, QRect(500, 0, 500, 250), SpatialIndex::Direction::Down) == QStringLiteral("bottom"));
+    CHECK(registry.neighbor(surface, QRect(500, 250, 500, 250), SpatialIndex::Direction::Left) == QStringLiteral("master"));
+    CHECK(registry.neighbor(surface, QRect(500, 0, 500, 250), SpatialIndex::Direction::Up).isEmpty());
+
+    SUBCASE("The most recently focused window wins")
+    {
+        CHECK(registry.neighbor(surface, QRect(0, 0, 500, 500), SpatialIndex::Direction::Right) == QStringLiteral("top"));
+
+        registry.setFocused(QStringLiteral("bottom"));
+        CHECK(registry.neighbor(surface, QRect(0, 0, 500, 500), SpatialIndex::Direction::Right) == QStringLiteral("bottom"));
+    }
+
+    SUBCASE("Changed geometries rebuild only the index of the tiles")
+    {
+        const auto *views = &registry.windowsOn(surface, WindowRegistry::View::VisibleTiled);
+
+        // The stack is moved to the left of the master
+        registry.setGeometry(QStringLiteral("master"), QRect(500, 0, 500, 500));
+        registry.setGeometry(QStringLiteral("top"), QRect(0, 0, 500, 250));
+        registry.setGeometry(QStringLiteral("bottom"), QRect(0, 250, 500, 250));
+
+        CHECK(registry.neighbor(surface, QRect(500, 0, 500, 500), SpatialIndex::Direction::Left) == QStringLiteral("top"));
+        CHECK(registry.neighbor(surface, QRect(0, 0, 500, 250), SpatialIndex::Direction::Right) == QStringLiteral("master"));
+        CHECK(&registry.windowsOn(surface, WindowRegistry::View::VisibleTiled) == views);
+    }
+}
@@ -0,0 +1,77 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include <doctest/doctest.h>
+
+#include "window-rules.hpp"
+
+using namespace Bismuth;
+
+TEST_CASE("Substring Matcher")
+{
+    auto matcher = SubstringMatcher();
+    matcher.addPattern(QStringLiteral("he"), 0x1);
+    matcher.addPattern(QStringLiteral("she"), 0x2);
+    matcher.addPattern(QStringLiteral("hers"), 0x4);
+    matcher.build();
+
+    CHECK(matcher.match(QStringLiteral("ushers")) == 0x7);
+    CHECK(matcher.match(QStringLiteral("ahead")) == 0x1);
+    CHECK(matcher.match(QStringLiteral("sh")) == 0);
+    CHECK(matcher.match(QString()) == 0);
+}
+
+TEST_CASE("Window Rules")
+{
+    auto config = std::make_shared<ConfigSnapshot>();
+    config->ignoreClass = QStringList{QStringLiteral("yakuake")};
+    config->floatingClass = QStringList{QStringLiteral("gimp")};
+    config->ignoreRole = QStringList{QStringLiteral("quake")};
+    config->floatingTitle = QStringList{QStringLiteral("Picture-in-Picture")};
+    config->ignoreScreen = QList<int>{1};
+
+    auto rules = WindowRules(config);
+
+    SUBCASE("Windows without rules are tiled")
+    {
+        CHECK(rules.classify(QStringLiteral("konsole"), QStringLiteral("konsole"), QString(), QStringLiteral("Shell")) == WindowRules::Tile);
+    }
+
+    SUBCASE("Class rules match both the class and the name")
+    {
+        CHECK((rules.classify(QStringLiteral("Yakuake"), QStringLiteral("yakuake"), QString(), QString()) & WindowRules::Ignore) != 0);
+        CHECK(rules.classify(QStringLiteral("gimp"), QStringLiteral("gimp-2.10"), QString(), QString()) == WindowRules::Float);
+        CHECK((rules.classify(QStringLiteral("plasmashell"), QStringLiteral("plasmashell"), QString(), QString()) & WindowRules::Ignore) != 0);
+    }
+
+    SUBCASE("Title rules are checked for the cached classes")
+    {
+        CHECK(rules.classify(QStringLiteral("firefox"), QStringLiteral("Navigator"), QString(), QStringLiteral("Mozilla Firefox")) == WindowRules::Tile);
+        CHECK(rules.classify(QStringLiteral("firefox"), QStringLiteral("Navigator"), QString(), QStringLiteral("Picture-in-Picture")) == WindowRules::Float);
+    }
+
+    SUBCASE("Config change drops the cache")
+    {
+        CHECK(rules.classify(QStringLiteral("gimp"), QStringLiteral("gimp"), QString(), QString()) == WindowRules::Float);
+
+        auto newConfig = std::make_shared<ConfigSnapshot>();
+        rules.setConfig(newConfig);
+
+        CHECK(rules.classify(QStringLiteral("gimp"), QStringLiteral("gimp"), QString(), QString()) == WindowRules::Tile);
+    }
+
+    SUBCASE("Rules stay in effect, when the cache is dropped for its size")
+    {
+        for (auto i = 0; i < 1000; ++i) {
+            const auto role = QStringLiteral("window-%1").arg(i);
+            CHECK(rules.classify(QStringLiteral("gimp"), QStringLiteral("gimp"), role, QString()) == WindowRules::Float);
+        }
+        CHECK((rules.classify(QStringLiteral("konsole"), QStringLiteral("konsole"), QStringLiteral("quake"), QString()) & WindowRules::Ignore) != 0);
+    }
+
+    SUBCASE("Surfaces")
+    {
+        CHECK(rules.ignoresSurface(QStringLiteral("Default"), 1));
+        CHECK_FALSE(rules.ignoresSurface(QStringLiteral("Default"), 0));
+    }
+}
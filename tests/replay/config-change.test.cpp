@@ -0,0 +1,107 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include <doctest/doctest.h>
+
+#include <limits>
+#include <memory>
+
+#include "fake-workspace.hpp"
+#include "script-harness.hpp"
+
+using namespace Bismuth;
+
+namespace
+{
+TraceClient client(quint32 id, const QString &resourceClass, quint32 flags = TraceClient::Resizeable)
+{
+    auto result = TraceClient();
+    result.id = id;
+    result.windowId = id;
+    result.resourceClass = resourceClass;
+    result.resourceName = resourceClass;
+    result.frameGeometry = QRect(100, 100, 300, 200);
+    // Size hints of a client, that does not limit its size. The default
+    // QSize is invalid and would make the script shrink the tiles to nothing.
+    result.minSize = QSize(0, 0);
+    result.maxSize = QSize(std::numeric_limits<int>::max(), std::numeric_limits<int>::max());
+    result.desktop = 1;
+    result.activities = {QStringLiteral("activity")};
+    result.flags = flags;
+    return result;
+}
+
+TraceWorkspace workspace()
+{
+    auto result = TraceWorkspace();
+    result.currentActivity = QStringLiteral("activity");
+    result.activities = {{QStringLiteral("activity"), QStringLiteral("Default")}};
+    result.areas = {{0, 1, QRect(0, 0, 1000, 800)}};
+    result.clients = {
+        client(1, QStringLiteral("editor")),
+        client(2, QStringLiteral("terminal")),
+        client(3, QStringLiteral("picker"), TraceClient::Resizeable | TraceClient::Dialog),
+    };
+    return result;
+}
+
+QRect geometry(ScriptHarness &script, int client)
+{
+    return script.workspace().clients()[client]->frameGeometry().toRect();
+}
+}
+
+TEST_CASE("Config changes of the running script")
+{
+    auto script = ScriptHarness(workspace(), ScriptHarness::defaultConfig());
+    REQUIRE(script.start(QStringLiteral(BISMUTH_SCRIPT_BUNDLE)));
+
+    const auto area = QRect(0, 0, 1000, 800);
+    const auto editorTiled = geometry(script, 0);
+    REQUIRE(area.contains(editorTiled));
+    REQUIRE(editorTiled.width() < area.width());
+
+    SUBCASE("Window, that is ignored by the rules now, is not tiled anymore and is tiled again, when it is not ignored")
+    {
+        auto config = std::make_shared<ConfigSnapshot>(*script.config());
+        ++config->generation;
+        config->ignoreClass.append(QStringLiteral("terminal"));
+        script.setConfig(config);
+        script.settle();
+
+        // The editor takes the whole area alone, and the moved terminal is
+        // not put back into its tile
+        CHECK(geometry(script, 0) == area);
+
+        auto terminal = script.workspace().clients()[1];
+        terminal->setFrameGeometry(QRectF(50, 50, 200, 100));
+        script.settle();
+        CHECK(geometry(script, 1) == QRect(50, 50, 200, 100));
+
+        auto restored = std::make_shared<ConfigSnapshot>(*config);
+        ++restored->generation;
+        restored->ignoreClass.removeAll(QStringLiteral("terminal"));
+        script.setConfig(restored);
+        script.settle();
+
+        CHECK(geometry(script, 0) == editorTiled);
+        CHECK(area.contains(geometry(script, 1)));
+        CHECK_FALSE(geometry(script, 0).intersects(geometry(script, 1)));
+    }
+
+    SUBCASE("Floating windows follow the keep above setting")
+    {
+        auto picker = script.workspace().clients()[2];
+        REQUIRE(picker->keepAbove());
+
+        auto config = std::make_shared<ConfigSnapshot>(*script.config());
+        ++config->generation;
+        config->keepFloatAbove = false;
+        script.setConfig(config);
+        script.settle();
+
+        CHECK_FALSE(picker->keepAbove());
+        // Only the flag is written, the floating window stays, where it is
+        CHECK(geometry(script, 2) == QRect(100, 100, 300, 200));
+    }
+}
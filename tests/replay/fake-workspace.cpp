@@ -0,0 +1,524 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include "fake-workspace.hpp"
+
+#include <algorithm>
+
+namespace Bismuth
+{
+
+FakeClient::FakeClient(const TraceClient &state, const FakeWorkspace &workspace, QObject *parent)
+    : QObject(parent)
+    , m_state(state)
+    , m_workspace(workspace)
+{
+}
+
+TraceClient &FakeClient::state()
+{
+    return m_state;
+}
+
+const TraceClient &FakeClient::state() const
+{
+    return m_state;
+}
+
+QStringList FakeClient::activities() const
+{
+    return m_state.activities;
+}
+
+bool FakeClient::dialog() const
+{
+    return flag(TraceClient::Dialog);
+}
+
+QByteArray FakeClient::resourceClass() const
+{
+    return m_state.resourceClass.toUtf8();
+}
+
+QByteArray FakeClient::resourceName() const
+{
+    return m_state.resourceName.toUtf8();
+}
+
+int FakeClient::screen() const
+{
+    return m_state.screen;
+}
+
+bool FakeClient::splash() const
+{
+    return flag(TraceClient::Splash);
+}
+
+bool FakeClient::utility() const
+{
+    return flag(TraceClient::Utility);
+}
+
+quint32 FakeClient::windowId() const
+{
+    return m_state.windowId;
+}
+
+QByteArray FakeClient::windowRole() const
+{
+    return m_state.windowRole.toUtf8();
+}
+
+bool FakeClient::active() const
+{
+    return flag(TraceClient::Active);
+}
+
+QString FakeClient::caption() const
+{
+    return m_state.caption;
+}
+
+QSize FakeClient::maxSize() const
+{
+    return m_state.maxSize;
+}
+
+QSize FakeClient::minSize() const
+{
+    return m_state.minSize;
+}
+
+bool FakeClient::modal() const
+{
+    return flag(TraceClient::Modal);
+}
+
+bool FakeClient::move() const
+{
+    return flag(TraceClient::Move);
+}
+
+bool FakeClient::resize() const
+{
+    return flag(TraceClient::Resize);
+}
+
+bool FakeClient::resizeable() const
+{
+    return flag(TraceClient::Resizeable);
+}
+
+bool FakeClient::specialWindow() const
+{
+    return flag(TraceClient::SpecialWindow);
+}
+
+bool FakeClient::transient() const
+{
+    return flag(TraceClient::Transient);
+}
+
+int FakeClient::desktop() const
+{
+    return m_state.desktop;
+}
+
+bool FakeClient::onAllDesktops() const
+{
+    return m_state.desktop == -1;
+}
+
+bool FakeClient::fullScreen() const
+{
+    return flag(TraceClient::FullScreen);
+}
+
+QRectF FakeClient::frameGeometry() const
+{
+    return m_state.frameGeometry;
+}
+
+bool FakeClient::keepAbove() const
+{
+    return flag(TraceClient::KeepAbove);
+}
+
+bool FakeClient::keepBelow() const
+{
+    return flag(TraceClient::KeepBelow);
+}
+
+bool FakeClient::minimized() const
+{
+    return flag(TraceClient::Minimized);
+}
+
+bool FakeClient::noBorder() const
+{
+    return flag(TraceClient::NoBorder);
+}
+
+bool FakeClient::shade() const
+{
+    return flag(TraceClient::Shade);
+}
+
+void FakeClient::setDesktop(int desktop)
+{
+    if (m_state.desktop != desktop) {
+        m_state.desktop = desktop;
+        Q_EMIT desktopChanged();
+    }
+}
+
+void FakeClient::setFullScreen(bool fullScreen)
+{
+    if (setFlag(TraceClient::FullScreen, fullScreen)) {
+        Q_EMIT fullScreenChanged();
+    }
+}
+
+void FakeClient::setFrameGeometry(const QRectF &frameGeometry)
+{
+    const auto geometry = frameGeometry.toRect();
+    if (m_state.frameGeometry == geometry) {
+        return;
+    }
+
+    m_state.frameGeometry = geometry;
+    Q_EMIT frameGeometryChanged();
+
+    // KWin moves the window to the screen, that it was moved onto
+    const auto screen = m_workspace.screenAt(geometry.center());
+    if (screen >= 0 && screen != m_state.screen) {
+        m_state.screen = screen;
+        Q_EMIT screenChanged();
+    }
+}
+
+void FakeClient::setKeepAbove(bool keepAbove)
+{
+    if (setFlag(TraceClient::KeepAbove, keepAbove)) {
+        Q_EMIT keepAboveChanged();
+    }
+}
+
+void FakeClient::setKeepBelow(bool keepBelow)
+{
+    if (setFlag(TraceClient::KeepBelow, keepBelow)) {
+        Q_EMIT keepBelowChanged();
+    }
+}
+
+void FakeClient::setMinimized(bool minimized)
+{
+    if (setFlag(TraceClient::Minimized, minimized)) {
+        Q_EMIT minimizedChanged();
+    }
+}
+
+void FakeClient::setNoBorder(bool noBorder)
+{
+    if (setFlag(TraceClient::NoBorder, noBorder)) {
+        Q_EMIT noBorderChanged();
+    }
+}
+
+void FakeClient::setShade(bool shade)
+{
+    if (setFlag(TraceClient::Shade, shade)) {
+        Q_EMIT shadeChanged();
+    }
+}
+
+bool FakeClient::setFlag(TraceClient::Flag flag, bool value)
+{
+    const auto flags = value ? m_state.flags | flag : m_state.flags & ~static_cast<quint32>(flag);
+    return std::exchange(m_state.flags, flags) != flags;
+}
+
+bool FakeClient::flag(TraceClient::Flag flag) const
+{
+    return m_state.flags & flag;
+}
+
+FakeWorkspace::FakeWorkspace(const TraceWorkspace &workspace, QObject *parent)
+    : QObject(parent)
+    , m_workspace(workspace)
+    , m_clients()
+    , m_clientIds()
+    , m_activeClient()
+{
+    m_workspace.clients.clear();
+    for (auto &client : workspace.clients) {
+        addClient(client);
+    }
+}
+
+int FakeWorkspace::activeScreen() const
+{
+    return m_workspace.activeScreen;
+}
+
+QString FakeWorkspace::currentActivity() const
+{
+    return m_workspace.currentActivity;
+}
+
+int FakeWorkspace::numScreens() const
+{
+    return m_workspace.numScreens;
+}
+
+QObject *FakeWorkspace::activeClient() const
+{
+    return m_activeClient;
+}
+
+int FakeWorkspace::currentDesktop() const
+{
+    return m_workspace.currentDesktop;
+}
+
+int FakeWorkspace::desktops() const
+{
+    return m_workspace.desktops;
+}
+
+void FakeWorkspace::setActiveClient(QObject *object)
+{
+    auto activeClient = qobject_cast<FakeClient *>(object);
+    if (m_activeClient == activeClient) {
+        return;
+    }
+
+    auto previousClient = std::exchange(m_activeClient, activeClient);
+    if (previousClient && previousClient->setFlag(TraceClient::Active, false)) {
+        Q_EMIT previousClient->activeChanged();
+    }
+    if (activeClient && activeClient->setFlag(TraceClient::Active, true)) {
+        Q_EMIT activeClient->activeChanged();
+    }
+    Q_EMIT clientActivated(activeClient);
+}
+
+void FakeWorkspace::setCurrentDesktop(int desktop)
+{
+    if (desktop < 1 || desktop > m_workspace.desktops || desktop == m_workspace.currentDesktop) {
+        return;
+    }
+
+    const auto previousDesktop = std::exchange(m_workspace.currentDesktop, desktop);
+    Q_EMIT currentDesktopChanged(previousDesktop);
+}
+
+QList<QObject *> FakeWorkspace::clientList() const
+{
+    auto result = QList<QObject *>();
+    for (auto client : m_clients) {
+        result.append(client);
+    }
+    return result;
+}
+
+QRect FakeWorkspace::clientArea(int, int screen, int desktop) const
+{
+    // Windows on all the desktops ask for the area of the current one
+    if (desktop < 1) {
+        desktop = m_workspace.currentDesktop;
+    }
+
+    for (auto &area : m_workspace.areas) {
+        if (area.screen == screen && area.desktop == desktop) {
+            return area.area;
+        }
+    }
+    return {};
+}
+
+int FakeWorkspace::screenAt(const QPoint &point) const
+{
+    for (auto &area : m_workspace.areas) {
+        if (area.desktop == m_workspace.currentDesktop && area.area.contains(point)) {
+            return area.screen;
+        }
+    }
+    return -1;
+}
+
+bool FakeWorkspace::apply(const TraceEvent &event)
+{
+    if (event.type == TraceEvent::CurrentDesktopChanged) {
+        const auto previousDesktop = std::exchange(m_workspace.currentDesktop, event.value);
+        Q_EMIT currentDesktopChanged(previousDesktop);
+        return true;
+    }
+
+    if (event.type == TraceEvent::CurrentActivityChanged) {
+        m_workspace.currentActivity = event.text;
+        Q_EMIT currentActivityChanged(event.text);
+        return true;
+    }
+
+    if (event.type == TraceEvent::ClientAdded) {
+        Q_EMIT clientAdded(addClient(event.state));
+        return true;
+    }
+
+    if (event.type == TraceEvent::ShortcutTriggered) {
+        return false;
+    }
+
+    // The client may be unknown, if it was added before the recording had begun
+    // and removed before the workspace state was recorded
+    auto client = this->client(event.client);
+    if (!client) {
+        return false;
+    }
+
+    auto &state = client->state();
+    switch (event.type) {
+    case TraceEvent::ClientRemoved:
+        Q_EMIT clientRemoved(client);
+        if (m_activeClient == client) {
+            m_activeClient = nullptr;
+        }
+        m_clients.erase(std::find(m_clients.begin(), m_clients.end(), client));
+        m_clientIds.erase(event.client);
+        client->deleteLater();
+        break;
+    case TraceEvent::ClientMaximizeSet:
+        Q_EMIT clientMaximizeSet(client, event.value & 1, event.value & 2);
+        break;
+    case TraceEvent::ClientMinimized:
+        client->setFlag(TraceClient::Minimized, true);
+        Q_EMIT clientMinimized(client);
+        break;
+    case TraceEvent::ClientUnminimized:
+        client->setFlag(TraceClient::Minimized, false);
+        Q_EMIT clientUnminimized(client);
+        break;
+    case TraceEvent::FrameGeometryChanged:
+        state.frameGeometry = event.geometry;
+        Q_EMIT client->frameGeometryChanged();
+        break;
+    case TraceEvent::MoveResizedChanged:
+        client->setFlag(TraceClient::Move, event.value & TraceClient::Move);
+        client->setFlag(TraceClient::Resize, event.value & TraceClient::Resize);
+        Q_EMIT client->moveResizedChanged();
+        break;
+    case TraceEvent::ActiveChanged:
+        client->setFlag(TraceClient::Active, event.value);
+        if (event.value) {
+            // The previous client may be one, whose events the script ignores
+            if (m_activeClient && m_activeClient != client) {
+                m_activeClient->setFlag(TraceClient::Active, false);
+            }
+            m_activeClient = client;
+        } else if (m_activeClient == client) {
+            m_activeClient = nullptr;
+        }
+        Q_EMIT client->activeChanged();
+        break;
+    case TraceEvent::ScreenChanged:
+        state.screen = event.value;
+        Q_EMIT client->screenChanged();
+        break;
+    case TraceEvent::ActivitiesChanged:
+        state.activities = event.activities;
+        Q_EMIT client->activitiesChanged();
+        break;
+    case TraceEvent::DesktopChanged:
+        state.desktop = event.value;
+        Q_EMIT client->desktopChanged();
+        break;
+    case TraceEvent::FullScreenChanged:
+        client->setFlag(TraceClient::FullScreen, event.value);
+        Q_EMIT client->fullScreenChanged();
+        break;
+    case TraceEvent::ShadeChanged:
+        client->setFlag(TraceClient::Shade, event.value);
+        Q_EMIT client->shadeChanged();
+        break;
+    default:
+        return false;
+    }
+
+    return true;
+}
+
+const std::vector<FakeClient *> &FakeWorkspace::clients() const
+{
+    return m_clients;
+}
+
+FakeClient *FakeWorkspace::addClient(const TraceClient &state)
+{
+    auto client = new FakeClient(state, *this, this);
+    m_clients.push_back(client);
+    m_clientIds[state.id] = client;
+
+    if (state.flags & TraceClient::Active) {
+        m_activeClient = client;
+    }
+
+    // The script minimizes and restores the windows itself
+    connect(client, &FakeClient::minimizedChanged, this, [this, client]() {
+        if (client->minimized()) {
+            Q_EMIT clientMinimized(client);
+        } else {
+            Q_EMIT clientUnminimized(client);
+        }
+    });
+
+    return client;
+}
+
+FakeClient *FakeWorkspace::client(quint32 id) const
+{
+    auto it = m_clientIds.find(id);
+    return it != m_clientIds.end() ? it->second : nullptr;
+}
+
+int FakeKWin::placementArea() const
+{
+    // ClientAreaOption::PlacementArea of KWin
+    return 0;
+}
+
+FakeActivityInfo::FakeActivityInfo(const TraceWorkspace &workspace, QObject *parent)
+    : QObject(parent)
+    , m_activities(workspace.activities)
+{
+}
+
+QStringList FakeActivityInfo::runningActivities() const
+{
+    auto result = QStringList();
+    for (auto &activity : m_activities) {
+        result.append(activity.first);
+    }
+    return result;
+}
+
+QString FakeActivityInfo::activityName(const QString &id) const
+{
+    auto it = std::find_if(m_activities.begin(), m_activities.end(), [&id](auto &activity) {
+        return activity.first == id;
+    });
+    return it != m_activities.end() ? it->second : id;
+}
+
+void FakePopupDialog::show(const QString &, const QString &, const QString &)
+{
+    ++m_notificationCount;
+}
+
+int FakePopupDialog::notificationCount() const
+{
+    return m_notificationCount;
+}
+
+}
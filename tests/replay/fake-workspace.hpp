@@ -0,0 +1,279 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <QByteArray>
+#include <QList>
+#include <QObject>
+#include <QPoint>
+#include <QRect>
+#include <QRectF>
+#include <QSize>
+#include <QString>
+#include <QStringList>
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "event-trace.hpp"
+
+namespace Bismuth
+{
+
+class FakeWorkspace;
+
+/**
+ * Stand-in for a KWin client with the properties and signals, that the
+ * script uses. The script changes it with the property setters, which emit
+ * the signals like KWin does.
+ */
+class FakeClient : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(QStringList activities READ activities NOTIFY activitiesChanged)
+    Q_PROPERTY(bool dialog READ dialog CONSTANT)
+    Q_PROPERTY(QByteArray resourceClass READ resourceClass CONSTANT)
+    Q_PROPERTY(QByteArray resourceName READ resourceName CONSTANT)
+    Q_PROPERTY(int screen READ screen NOTIFY screenChanged)
+    Q_PROPERTY(bool splash READ splash CONSTANT)
+    Q_PROPERTY(bool utility READ utility CONSTANT)
+    Q_PROPERTY(quint32 windowId READ windowId CONSTANT)
+    Q_PROPERTY(QByteArray windowRole READ windowRole CONSTANT)
+    Q_PROPERTY(bool active READ active NOTIFY activeChanged)
+    Q_PROPERTY(QString caption READ caption CONSTANT)
+    Q_PROPERTY(QSize maxSize READ maxSize CONSTANT)
+    Q_PROPERTY(QSize minSize READ minSize CONSTANT)
+    Q_PROPERTY(bool modal READ modal CONSTANT)
+    Q_PROPERTY(bool move READ move NOTIFY moveResizedChanged)
+    Q_PROPERTY(bool resize READ resize NOTIFY moveResizedChanged)
+    Q_PROPERTY(bool resizeable READ resizeable CONSTANT)
+    Q_PROPERTY(bool specialWindow READ specialWindow CONSTANT)
+    Q_PROPERTY(bool transient READ transient CONSTANT)
+    Q_PROPERTY(int desktop READ desktop WRITE setDesktop NOTIFY desktopChanged)
+    Q_PROPERTY(bool onAllDesktops READ onAllDesktops NOTIFY desktopChanged)
+    Q_PROPERTY(bool fullScreen READ fullScreen WRITE setFullScreen NOTIFY fullScreenChanged)
+    Q_PROPERTY(QRectF frameGeometry READ frameGeometry WRITE setFrameGeometry NOTIFY frameGeometryChanged)
+    Q_PROPERTY(bool keepAbove READ keepAbove WRITE setKeepAbove NOTIFY keepAboveChanged)
+    Q_PROPERTY(bool keepBelow READ keepBelow WRITE setKeepBelow NOTIFY keepBelowChanged)
+    Q_PROPERTY(bool minimized READ minimized WRITE setMinimized NOTIFY minimizedChanged)
+    Q_PROPERTY(bool noBorder READ noBorder WRITE setNoBorder NOTIFY noBorderChanged)
+    Q_PROPERTY(bool shade READ shade WRITE setShade NOTIFY shadeChanged)
+
+public:
+    FakeClient(const TraceClient &, const FakeWorkspace &, QObject *parent = nullptr);
+
+    /**
+     * State of the client. Changing it directly does not emit any signals.
+     */
+    TraceClient &state();
+    const TraceClient &state() const;
+
+    QStringList activities() const;
+    bool dialog() const;
+    QByteArray resourceClass() const;
+    QByteArray resourceName() const;
+    int screen() const;
+    bool splash() const;
+    bool utility() const;
+    quint32 windowId() const;
+    QByteArray windowRole() const;
+    bool active() const;
+    QString caption() const;
+    QSize maxSize() const;
+    QSize minSize() const;
+    bool modal() const;
+    bool move() const;
+    bool resize() const;
+    bool resizeable() const;
+    bool specialWindow() const;
+    bool transient() const;
+    int desktop() const;
+    bool onAllDesktops() const;
+    bool fullScreen() const;
+    QRectF frameGeometry() const;
+    bool keepAbove() const;
+    bool keepBelow() const;
+    bool minimized() const;
+    bool noBorder() const;
+    bool shade() const;
+
+    void setDesktop(int);
+    void setFullScreen(bool);
+    void setFrameGeometry(const QRectF &);
+    void setKeepAbove(bool);
+    void setKeepBelow(bool);
+    void setMinimized(bool);
+    void setNoBorder(bool);
+    void setShade(bool);
+
+    /**
+     * Set the flag without emitting any signals
+     * @return whether the flag has changed
+     */
+    bool setFlag(TraceClient::Flag, bool);
+
+Q_SIGNALS:
+    void activitiesChanged();
+    void frameGeometryChanged();
+    void screenChanged();
+    void windowShown();
+    void activeChanged();
+    void desktopChanged();
+    void fullScreenChanged();
+    void keepAboveChanged();
+    void keepBelowChanged();
+    void minimizedChanged();
+    void moveResizedChanged();
+    void noBorderChanged();
+    void shadeChanged();
+
+private:
+    bool flag(TraceClient::Flag) const;
+
+    TraceClient m_state;
+    const FakeWorkspace &m_workspace;
+};
+
+/**
+ * Headless stand-in for the KWin workspace.
+ *
+ * The screens, desktops and activities are the ones from the trace. The
+ * recorded events are applied with apply, which changes the state of the
+ * workspace and emits exactly the signal, that the script has received
+ * during the recording.
+ */
+class FakeWorkspace : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(int activeScreen READ activeScreen CONSTANT)
+    Q_PROPERTY(QString currentActivity READ currentActivity NOTIFY currentActivityChanged)
+    Q_PROPERTY(int numScreens READ numScreens CONSTANT)
+    Q_PROPERTY(QObject *activeClient READ activeClient WRITE setActiveClient NOTIFY clientActivated)
+    Q_PROPERTY(int currentDesktop READ currentDesktop WRITE setCurrentDesktop NOTIFY currentDesktopChanged)
+    Q_PROPERTY(int desktops READ desktops CONSTANT)
+
+public:
+    explicit FakeWorkspace(const TraceWorkspace &, QObject *parent = nullptr);
+
+    int activeScreen() const;
+    QString currentActivity() const;
+    int numScreens() const;
+    QObject *activeClient() const;
+    int currentDesktop() const;
+    int desktops() const;
+
+    void setActiveClient(QObject *);
+    void setCurrentDesktop(int);
+
+    Q_INVOKABLE QList<QObject *> clientList() const;
+
+    /**
+     * @return the recorded working area of the screen on the desktop
+     */
+    Q_INVOKABLE QRect clientArea(int option, int screen, int desktop) const;
+
+    /**
+     * @return the screen, whose working area contains the point, or -1
+     */
+    int screenAt(const QPoint &) const;
+
+    /**
+     * Apply the recorded event and emit its signal. Shortcut triggers are
+     * not workspace events and are ignored.
+     * @return whether the event was applied
+     */
+    bool apply(const TraceEvent &);
+
+    /**
+     * @return the clients in the order they were added
+     */
+    const std::vector<FakeClient *> &clients() const;
+
+Q_SIGNALS:
+    void clientAdded(QObject *client);
+    void clientRemoved(QObject *client);
+    void clientActivated(QObject *client);
+    void clientMaximizeSet(QObject *client, bool horizontally, bool vertically);
+    void clientMinimized(QObject *client);
+    void clientUnminimized(QObject *client);
+    void currentActivityChanged(const QString &activity);
+    void currentDesktopChanged(int previousDesktop);
+
+    // The screens, the desktops and the activities of the trace never change
+    void activitiesChanged(const QString &id);
+    void numberDesktopsChanged(int previousDesktops);
+    void numberScreensChanged(int count);
+    void screenResized(int screen);
+
+private:
+    FakeClient *addClient(const TraceClient &);
+    FakeClient *client(quint32 id) const;
+
+    TraceWorkspace m_workspace; ///< Only the static parts are used, the clients are in m_clients
+    std::vector<FakeClient *> m_clients;
+    std::unordered_map<quint32, FakeClient *> m_clientIds; ///< Clients by their trace ids
+    FakeClient *m_activeClient;
+};
+
+/**
+ * Stand-in for the KWin options
+ */
+class FakeOptions : public QObject
+{
+    Q_OBJECT
+
+Q_SIGNALS:
+    void configChanged();
+};
+
+/**
+ * Stand-in for the KWin global object of the scripts
+ */
+class FakeKWin : public QObject
+{
+    Q_OBJECT
+
+    Q_PROPERTY(int PlacementArea READ placementArea CONSTANT)
+
+public:
+    int placementArea() const;
+};
+
+/**
+ * Stand-in for the activity info of the task manager
+ */
+class FakeActivityInfo : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit FakeActivityInfo(const TraceWorkspace &, QObject *parent = nullptr);
+
+    Q_INVOKABLE QStringList runningActivities() const;
+    Q_INVOKABLE QString activityName(const QString &id) const;
+
+private:
+    std::vector<std::pair<QString, QString>> m_activities;
+};
+
+/**
+ * Stand-in for the popup of the script, that only counts the notifications
+ */
+class FakePopupDialog : public QObject
+{
+    Q_OBJECT
+
+public:
+    Q_INVOKABLE void show(const QString &text, const QString &icon = QString(), const QString &hint = QString());
+
+    int notificationCount() const;
+
+private:
+    int m_notificationCount = 0;
+};
+
+}
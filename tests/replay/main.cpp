@@ -0,0 +1,153 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTimer>
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+
+#include "event-trace.hpp"
+#include "fake-workspace.hpp"
+#include "script-harness.hpp"
+
+using namespace Bismuth;
+
+namespace
+{
+/**
+ * Process the events of the application for the given time
+ */
+void wait(qint64 microseconds)
+{
+    if (microseconds <= 0) {
+        QCoreApplication::processEvents();
+        return;
+    }
+
+    QEventLoop loop;
+    QTimer::singleShot(std::chrono::milliseconds(microseconds / 1000), Qt::PreciseTimer, &loop, &QEventLoop::quit);
+    loop.exec();
+}
+
+QJsonObject windowReport(const FakeClient &client)
+{
+    const auto &state = client.state();
+    return QJsonObject{
+        {QStringLiteral("windowId"), static_cast<qint64>(state.windowId)},
+        {QStringLiteral("resourceClass"), state.resourceClass},
+        {QStringLiteral("geometry"),
+         QJsonArray{state.frameGeometry.x(), state.frameGeometry.y(), state.frameGeometry.width(), state.frameGeometry.height()}},
+        {QStringLiteral("screen"), state.screen},
+        {QStringLiteral("desktop"), state.desktop},
+        {QStringLiteral("minimized"), client.minimized()},
+        {QStringLiteral("noBorder"), client.noBorder()},
+        {QStringLiteral("keepAbove"), client.keepAbove()},
+    };
+}
+}
+
+int main(int argc, char **argv)
+{
+    // The actions of the controller need a GUI application, but nothing is shown
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Replay a recorded Bismuth event trace without KWin"));
+    parser.addHelpOption();
+
+    auto realtimeOption = QCommandLineOption(QStringLiteral("realtime"), QStringLiteral("Keep the recorded delays between the events"));
+    auto scriptOption =
+        QCommandLineOption(QStringLiteral("script"), QStringLiteral("Bundled script to run"), QStringLiteral("file"), QStringLiteral(BISMUTH_SCRIPT_BUNDLE));
+    auto outputOption =
+        QCommandLineOption(QStringLiteral("output"), QStringLiteral("JSON file to write the results to, stdout by default"), QStringLiteral("file"));
+    parser.addOption(realtimeOption);
+    parser.addOption(scriptOption);
+    parser.addOption(outputOption);
+    parser.addPositionalArgument(QStringLiteral("trace"), QStringLiteral("Event trace, recorded with org.kde.bismuth /Core startRecording"));
+    parser.process(app);
+
+    if (parser.positionalArguments().size() != 1) {
+        parser.showHelp(1);
+    }
+
+    const auto trace = EventTrace::load(parser.positionalArguments().constFirst());
+    if (!trace) {
+        return 1;
+    }
+
+    // The trace does not record the settings, so the script runs with the
+    // defaults and not with the config of the current user. Otherwise the
+    // result of the replay would depend on the machine.
+    auto script = ScriptHarness(trace->workspace, ScriptHarness::defaultConfig());
+    if (!script.start(parser.value(scriptOption))) {
+        return 1;
+    }
+
+    const auto realtime = parser.isSet(realtimeOption);
+    auto clock = QElapsedTimer();
+    clock.start();
+
+    auto replayTime = qint64(0);
+    auto skippedEvents = 0;
+    for (auto &event : trace->events) {
+        if (realtime) {
+            // The delays are counted from the start, so that the time spent in the script does not add up
+            replayTime += event.delay;
+            wait(replayTime - clock.nsecsElapsed() / 1000);
+        }
+
+        if (!script.apply(event)) {
+            ++skippedEvents;
+        }
+
+        if (!realtime) {
+            script.settle();
+        }
+    }
+    script.settle();
+
+    const auto elapsed = clock.nsecsElapsed();
+
+    auto windows = QJsonArray();
+    for (auto client : script.workspace().clients()) {
+        windows.append(windowReport(*client));
+    }
+
+    const auto report = QJsonObject{
+        {QStringLiteral("events"), static_cast<qint64>(trace->events.size())},
+        {QStringLiteral("skippedEvents"), skippedEvents},
+        {QStringLiteral("realtime"), realtime},
+        {QStringLiteral("durationMs"), elapsed / 1e6},
+        {QStringLiteral("commitsSent"), static_cast<qint64>(script.proxy().commitsSent())},
+        {QStringLiteral("commitsSkipped"), static_cast<qint64>(script.proxy().commitsSkipped())},
+        {QStringLiteral("notifications"), script.popupDialog().notificationCount()},
+        {QStringLiteral("windows"), windows},
+    };
+    const auto json = QJsonDocument(report).toJson();
+
+    if (!parser.isSet(outputOption)) {
+        std::fwrite(json.constData(), 1, json.size(), stdout);
+        return 0;
+    }
+
+    QFile output(parser.value(outputOption));
+    if (!output.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCritical("Cannot open %s for writing", qPrintable(output.fileName()));
+        return 1;
+    }
+    output.write(json);
+
+    return 0;
+}
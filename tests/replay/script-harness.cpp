@@ -0,0 +1,130 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include "script-harness.hpp"
+
+#include <QCoreApplication>
+
+namespace Bismuth
+{
+
+ScriptHarness::ScriptHarness(const TraceWorkspace &workspace, std::shared_ptr<const ConfigSnapshot> config)
+    : m_config()
+    , m_configSnapshot(config)
+    , m_controller(m_config, false)
+    , m_engine(config)
+    , m_scheduler()
+    , m_tracer()
+    , m_qmlEngine()
+    , m_proxy(&m_qmlEngine, m_controller, m_engine, m_scheduler, m_tracer, config)
+    , m_workspace(workspace)
+    , m_options()
+    , m_kwin()
+    , m_activityInfo(workspace)
+    , m_popupDialog()
+    , m_scriptController()
+{
+    m_config.setDefaults();
+}
+
+ScriptHarness::~ScriptHarness()
+{
+    if (m_scriptController.isObject()) {
+        m_scriptController.property(QStringLiteral("drop")).callWithInstance(m_scriptController);
+    }
+}
+
+bool ScriptHarness::start(const QString &scriptPath)
+{
+    auto qmlObjects = m_qmlEngine.newObject();
+    qmlObjects.setProperty(QStringLiteral("scriptRoot"), m_qmlEngine.newObject());
+    qmlObjects.setProperty(QStringLiteral("activityInfo"), wrap(&m_activityInfo));
+    qmlObjects.setProperty(QStringLiteral("popupDialog"), wrap(&m_popupDialog));
+
+    auto kwinApi = m_qmlEngine.newObject();
+    kwinApi.setProperty(QStringLiteral("workspace"), wrap(&m_workspace));
+    kwinApi.setProperty(QStringLiteral("options"), wrap(&m_options));
+    kwinApi.setProperty(QStringLiteral("KWin"), wrap(&m_kwin));
+
+    auto script = m_qmlEngine.importModule(scriptPath);
+    if (script.isError()) {
+        qCritical("Cannot load the script: %s", qPrintable(script.toString()));
+        return false;
+    }
+
+    auto scriptController = script.property(QStringLiteral("init")).call({qmlObjects, kwinApi, wrap(&m_proxy)});
+    if (scriptController.isError() || scriptController.isNull()) {
+        qCritical("Cannot start the script: %s", qPrintable(scriptController.toString()));
+        return false;
+    }
+
+    m_scriptController = scriptController;
+    settle();
+    return true;
+}
+
+bool ScriptHarness::apply(const TraceEvent &event)
+{
+    if (event.type != TraceEvent::ShortcutTriggered) {
+        return m_workspace.apply(event);
+    }
+
+    // Triggers of the repeatable actions are coalesced again by the controller
+    for (auto i = 0; i < event.value; ++i) {
+        if (!m_controller.trigger(event.text)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void ScriptHarness::settle()
+{
+    do {
+        QCoreApplication::processEvents();
+    } while (m_scheduler.pending());
+}
+
+void ScriptHarness::setConfig(std::shared_ptr<const ConfigSnapshot> config)
+{
+    const auto changes = config->changesFrom(*m_configSnapshot);
+    m_configSnapshot = std::move(config);
+
+    m_engine.setConfig(m_configSnapshot);
+    m_proxy.setConfig(m_configSnapshot, changes);
+}
+
+std::shared_ptr<const ConfigSnapshot> ScriptHarness::config() const
+{
+    return m_configSnapshot;
+}
+
+FakeWorkspace &ScriptHarness::workspace()
+{
+    return m_workspace;
+}
+
+const TSProxy &ScriptHarness::proxy() const
+{
+    return m_proxy;
+}
+
+const FakePopupDialog &ScriptHarness::popupDialog() const
+{
+    return m_popupDialog;
+}
+
+std::shared_ptr<const ConfigSnapshot> ScriptHarness::defaultConfig()
+{
+    auto config = Bismuth::Config();
+    config.setDefaults();
+    return ConfigSnapshot::fromConfig(config, 1);
+}
+
+QJSValue ScriptHarness::wrap(QObject *object)
+{
+    QQmlEngine::setObjectOwnership(object, QQmlEngine::CppOwnership);
+    return m_qmlEngine.newQObject(object);
+}
+
+}
@@ -0,0 +1,97 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <QJSValue>
+#include <QQmlEngine>
+#include <QString>
+
+#include <memory>
+
+#include "arrange-scheduler.hpp"
+#include "config-snapshot.hpp"
+#include "config.hpp"
+#include "controller.hpp"
+#include "engine/engine.hpp"
+#include "event-trace.hpp"
+#include "fake-workspace.hpp"
+#include "tracer.hpp"
+#include "ts-proxy.hpp"
+
+namespace Bismuth
+{
+
+/**
+ * The bundled script, running on a fake workspace without KWin.
+ *
+ * Owns the native parts of the script the same way the plugin does, and
+ * the stand-ins for the KWin objects. The script never touches the global
+ * shortcuts or the saved state of the running instance.
+ */
+class ScriptHarness
+{
+public:
+    /**
+     * @param workspace initial state of the workspace
+     * @param config settings of the script
+     */
+    ScriptHarness(const TraceWorkspace &workspace, std::shared_ptr<const ConfigSnapshot> config);
+    ~ScriptHarness();
+
+    /**
+     * Load the script and let it manage the clients of the workspace
+     * @return whether the script has started
+     */
+    bool start(const QString &scriptPath);
+
+    /**
+     * Pass the recorded event to the workspace or to the controller
+     * @return whether the event was applied
+     */
+    bool apply(const TraceEvent &);
+
+    /**
+     * Let the script finish everything, that the last event has scheduled
+     */
+    void settle();
+
+    /**
+     * Replace the settings of the script, like the plugin does, when the
+     * config is saved
+     */
+    void setConfig(std::shared_ptr<const ConfigSnapshot>);
+
+    std::shared_ptr<const ConfigSnapshot> config() const;
+
+    FakeWorkspace &workspace();
+    const TSProxy &proxy() const;
+    const FakePopupDialog &popupDialog() const;
+
+    /**
+     * @return the settings, that the user has not changed
+     */
+    static std::shared_ptr<const ConfigSnapshot> defaultConfig();
+
+private:
+    QJSValue wrap(QObject *);
+
+    Bismuth::Config m_config;
+    std::shared_ptr<const ConfigSnapshot> m_configSnapshot;
+    Controller m_controller;
+    Engine m_engine;
+    ArrangeScheduler m_scheduler;
+    Tracer m_tracer;
+    QQmlEngine m_qmlEngine;
+    TSProxy m_proxy;
+
+    FakeWorkspace m_workspace;
+    FakeOptions m_options;
+    FakeKWin m_kwin;
+    FakeActivityInfo m_activityInfo;
+    FakePopupDialog m_popupDialog;
+
+    QJSValue m_scriptController; ///< Returned by the init of the script
+};
+
+}
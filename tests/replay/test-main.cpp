@@ -0,0 +1,28 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#define DOCTEST_CONFIG_IMPLEMENT
+#include <doctest/doctest.h>
+
+#include <QApplication>
+#include <QTimer>
+
+int main(int argc, char **argv)
+{
+    // The actions of the controller need a GUI application, but nothing is shown
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+
+    auto testRunner = [&]() {
+        doctest::Context context;
+        context.applyCommandLine(argc, argv);
+        app.exit(context.run());
+    };
+
+    QTimer::singleShot(0, &app, testRunner);
+    QTimer::singleShot(0, &app, SLOT(quit()));
+
+    return app.exec();
+}
@@ -0,0 +1,43 @@
+// SPDX-FileCopyrightText: 2022 Mikhail Zolotukhin <mail@gikari.com>
+// SPDX-License-Identifier: MIT
+
+#include <doctest/doctest.h>
+
+#include "event-trace.hpp"
+#include "fake-workspace.hpp"
+#include "script-harness.hpp"
+
+using namespace Bismuth;
+
+TEST_CASE("Replay of a recorded trace")
+{
+    // Editor, terminal and viewer are opened on the empty 1000x800 area one
+    // after another, then the terminal is closed
+    const auto trace = EventTrace::load(QStringLiteral(BISMUTH_REPLAY_FIXTURES "/close-window.trace"));
+    REQUIRE(trace);
+    REQUIRE(trace->events.size() == 4);
+
+    auto script = ScriptHarness(trace->workspace, ScriptHarness::defaultConfig());
+    REQUIRE(script.start(QStringLiteral(BISMUTH_SCRIPT_BUNDLE)));
+
+    for (auto &event : trace->events) {
+        CHECK(script.apply(event));
+        script.settle();
+    }
+
+    const auto &clients = script.workspace().clients();
+    REQUIRE(clients.size() == 2);
+    CHECK(clients[0]->resourceClass() == QByteArrayLiteral("editor"));
+    CHECK(clients[1]->resourceClass() == QByteArrayLiteral("viewer"));
+
+    // The two remaining windows share the whole area side by side
+    const auto area = QRect(0, 0, 1000, 800);
+    const auto editor = clients[0]->frameGeometry().toRect();
+    const auto viewer = clients[1]->frameGeometry().toRect();
+    CHECK(area.contains(editor));
+    CHECK(area.contains(viewer));
+    CHECK(editor.height() == area.height());
+    CHECK(viewer.height() == area.height());
+    CHECK(editor.width() + viewer.width() == area.width());
+    CHECK_FALSE(editor.intersects(viewer));
+}